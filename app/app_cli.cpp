@@ -79,7 +79,7 @@ static unsigned int splitStringIntoHexArray(std::string str, uint8_t *array);
  * Function to read the GBL file from the file system of the host file system.
  *****************************************************************************/
 static EmberStatus read_gbl_file(std::string filename,
-                                 uint8_t** gbl_image,
+                                 EmberAfOtaUnicastBootloaderImage** gbl_image,
                                  uint32_t* gbl_size);
 
 // -----------------------------------------------------------------------------
@@ -392,6 +392,8 @@ void cli_bootloader_unicast_distribute(std::ostream&,
     printf("No GBL image was loaded!\n");
     return;
   }
+  // Lets the server identify the image in the resume journal
+  emberAfPluginOtaUnicastBootloaderServerSetImageSource(image_tag, gbl_image);
 
   EmberAfOtaUnicastBootloaderStatus status =
     emberAfPluginOtaUnicastBootloaderServerInitiateImageDistribution(target,
@@ -462,13 +464,104 @@ void cli_load_gbl_file(std::ostream&,
 
   if (status == EMBER_BAD_ARGUMENT) {
     printf("Can't find/load GBL file!\n");
-  } else if (status == EMBER_ERR_FATAL) {
-    printf("Can't allocate memory for GBL file!\n");
   } else if (status == EMBER_SUCCESS) {
     printf("GBL file of %u bytes loaded into memory.\n", gbl_size);
   }
 }
 
+/**************************************************************************//**
+ * CLI - bootloader_unicast_journal command
+ * Records the progress of the image transmissions in a journal file, and
+ * resumes the transmissions interrupted by a previous run if the loaded GBL
+ * file is still the same.
+ *****************************************************************************/
+void cli_bootloader_unicast_journal(std::ostream&,
+                                    std::string filename)
+{
+  EmberAfOtaUnicastBootloaderStatus status =
+    emberAfPluginOtaUnicastBootloaderServerEnableJournal(filename.c_str());
+
+  if (status == EMBER_OTA_UNICAST_BOOTLOADER_STATUS_SUCCESS) {
+    printf("unicast image distribution journal enabled\n");
+  } else {
+    printf("unicast image distribution journal failed 0x%x\n", status);
+  }
+}
+
+/**************************************************************************//**
+ * CLI - capture_start command
+ * Records the CSP frames exchanged with the NCP in pcapng files.
+ *****************************************************************************/
+void cli_capture_start(std::ostream&,
+                       std::string filename,
+                       uint32_t max_file_size,
+                       uint16_t file_count)
+{
+  if (file_count == 0 || file_count > 255) {
+    printf("invalid file count\n");
+    return;
+  }
+
+  EmberStatus status = sl_connect_ncp_start_capture(filename.c_str(),
+                                                    max_file_size,
+                                                    (uint8_t)file_count);
+
+  if (status == EMBER_SUCCESS) {
+    printf("capture started\n");
+  } else {
+    printf("capture failed 0x%x\n", status);
+  }
+}
+
+/**************************************************************************//**
+ * CLI - capture_stop command
+ *****************************************************************************/
+void cli_capture_stop(std::ostream&)
+{
+  sl_connect_ncp_stop_capture();
+  printf("capture stopped\n");
+}
+
+/**************************************************************************//**
+ * CLI - ncp_stats command
+ * Prints the latency and throughput statistics of the commands sent to the
+ * NCP.
+ *****************************************************************************/
+void cli_ncp_stats(std::ostream&)
+{
+  sl_connect_ncp_dump_stats(stdout);
+}
+
+/**************************************************************************//**
+ * CLI - response_timeout command
+ * Sets the time the NCP has to answer each command and how many times a
+ * command is sent again when it is not answered.
+ *****************************************************************************/
+void cli_response_timeout(std::ostream&,
+                          uint32_t timeout_ms,
+                          uint8_t max_retries,
+                          uint32_t backoff_ms)
+{
+  sl_connect_ncp_set_response_timeout(timeout_ms);
+  sl_connect_ncp_set_retry_policy(max_retries, backoff_ms);
+  printf("response timeout set\n");
+}
+
+/**************************************************************************//**
+ * CLI - sequence_numbers command
+ * Negotiates the sequence numbers matching the NCP responses to their
+ * commands.
+ *****************************************************************************/
+void cli_sequence_numbers(std::ostream&, uint8_t enable)
+{
+  EmberStatus status = sl_connect_ncp_set_sequence_numbers(enable != 0);
+  if (status == EMBER_SUCCESS) {
+    printf("sequence numbers %s\n", (enable != 0) ? "enabled" : "disabled");
+  } else {
+    printf("sequence numbers not set: 0x%02X\n", status);
+  }
+}
+
 // -----------------------------------------------------------------------------
 //                          Static Function Definitions
 // -----------------------------------------------------------------------------
@@ -508,34 +601,26 @@ static unsigned int splitStringIntoHexArray(std::string str, uint8_t *array)
 
 
 /**************************************************************************//**
- * Function to read the GBL file from the file system of the host file system.
+ * Function to map the GBL file from the file system of the host file system.
+ * The file content is read on demand, while the segments are sent.
  *****************************************************************************/
 static EmberStatus read_gbl_file(std::string filename,
-                                 uint8_t** gbl_image,
+                                 EmberAfOtaUnicastBootloaderImage** gbl_image,
                                  uint32_t* gbl_size)
 {
-  FILE* gbl_file_hnd = NULL;
-
-  gbl_file_hnd = fopen(const_cast<char*>(filename.c_str()), "r");
+  EmberAfOtaUnicastBootloaderImage* image =
+    emberAfPluginOtaUnicastBootloaderServerOpenImage(filename.c_str());
 
-  if(gbl_file_hnd == NULL || gbl_size == NULL) {
+  if(image == NULL || gbl_size == NULL) {
+    emberAfPluginOtaUnicastBootloaderServerCloseImage(image);
     return EMBER_BAD_ARGUMENT;
   }
 
   // Discard any previous image
   free_gbl_image();
 
-  fseek(gbl_file_hnd, 0L, SEEK_END);
-  *gbl_size = ftell(gbl_file_hnd);
-
-  fseek(gbl_file_hnd, 0L, SEEK_SET);
-
-  *gbl_image = (uint8_t*)malloc(*gbl_size);
-  if(*gbl_image == NULL)
-      return EMBER_ERR_FATAL;
-
-  fread(*gbl_image, sizeof(uint8_t), *gbl_size, gbl_file_hnd);
-  fclose(gbl_file_hnd);
+  *gbl_image = image;
+  *gbl_size = emberAfPluginOtaUnicastBootloaderServerGetImageSize(image);
 
   return EMBER_SUCCESS;
 }
@@ -103,4 +103,23 @@ void cli_bootloader_set_tag(std::ostream&,
 void cli_load_gbl_file(std::ostream&,
                        std::string filename);
 
+void cli_bootloader_unicast_journal(std::ostream&,
+                                    std::string filename);
+
+void cli_capture_start(std::ostream&,
+                       std::string filename,
+                       uint32_t max_file_size,
+                       uint16_t file_count);
+
+void cli_capture_stop(std::ostream&);
+
+void cli_ncp_stats(std::ostream&);
+
+void cli_response_timeout(std::ostream&,
+                          uint32_t timeout_ms,
+                          uint8_t max_retries,
+                          uint32_t backoff_ms);
+
+void cli_sequence_numbers(std::ostream&, uint8_t enable);
+
 #endif //__CLI_HANDLERS_H__
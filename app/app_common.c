@@ -34,6 +34,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <connect/ember-types.h>
+#include <connect/ota-unicast-bootloader-server.h>
 #include "sl_sensor_sink_config.h"
 
 // -----------------------------------------------------------------------------
@@ -41,7 +42,7 @@
 // -----------------------------------------------------------------------------
 
 /// GBL image storage
-uint8_t* gbl_image = NULL;
+EmberAfOtaUnicastBootloaderImage* gbl_image = NULL;
 
 /// Connect security key (default)
 EmberKeyData default_security_key = { .contents = SL_SENSOR_SINK_SECURITY_KEY };
@@ -62,12 +63,12 @@ void printBuffer(const uint8_t* buffer, uint8_t length)
 }
 
 /******************************************************************************
-* Helper to free the memory buffer of a GBL file no longer used
+* Helper to release the GBL file no longer used
 ******************************************************************************/
 void free_gbl_image(void)
 {
   if(gbl_image != NULL) {
-    free(gbl_image);
+    emberAfPluginOtaUnicastBootloaderServerCloseImage(gbl_image);
     gbl_image = NULL;
   }
 }
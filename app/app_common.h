@@ -38,6 +38,7 @@ extern "C" {
 //                                   Includes
 // -----------------------------------------------------------------------------
 #include <connect/ember.h>
+#include <connect/ota-unicast-bootloader-server.h>
 #include "sl_sensor_sink_config.h"
 
 // -----------------------------------------------------------------------------
@@ -53,7 +54,7 @@ extern EmberKeyData security_key;
 /// TX options set up for the network
 extern EmberMessageOptions tx_options;
 /// GBL image storage
-extern uint8_t* gbl_image;
+extern EmberAfOtaUnicastBootloaderImage* gbl_image;
 /// Default security set by the app during startup
 extern const EmberKeyData default_security_key;
 
@@ -68,7 +69,7 @@ extern const EmberKeyData default_security_key;
 extern void printBuffer(const uint8_t* buffer, uint8_t length);
 
 /******************************************************************************
-* Helper to free the memory buffer of a GBL file no longer used
+* Helper to release the GBL file no longer used
 ******************************************************************************/
 extern void free_gbl_image(void);
 
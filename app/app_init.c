@@ -34,9 +34,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <pthread.h>
 #include <fcntl.h>
-#include <poll.h>
 #include <assert.h>
 #include <connect/ncp.h>
 #include <connect/ember.h>
@@ -52,8 +50,6 @@
 //                          Static Function Declarations
 // -----------------------------------------------------------------------------
 
-static void start_ncp_msg_thread(void);
-
 // -----------------------------------------------------------------------------
 //                                Global Variables
 // -----------------------------------------------------------------------------
@@ -67,29 +63,13 @@ extern EmberKeyData security_key;
 //                          Public Function Definitions
 // -----------------------------------------------------------------------------
 
-void *poll_ncp_msg(void *arg)
-{
-  while (1) {
-    EmberStatus status = sl_connect_poll_ncp_msg(-1);
-    assert(status == EMBER_SUCCESS);
-  }
-}
-
-void *poll_cb_commands(void *arg)
-{
-  while ((1)) {
-    EmberStatus status = sl_connect_ncp_poll_callback_command(-1);
-    assert(status == EMBER_SUCCESS);
-  }
-}
-
 /******************************************************************************
 * Application init
 ******************************************************************************/
 void app_init()
 {
+  // NCP messages and callbacks are processed by the main scheduler event loop
   sl_connect_ncp_init();
-  start_ncp_msg_thread();
   printf("<Power UP>\n");
 
   emberNetworkInit();
@@ -118,11 +98,3 @@ void emberAfInitCallback(void)
 // -----------------------------------------------------------------------------
 //                          Static Function Definitions
 // -----------------------------------------------------------------------------
-
-static void start_ncp_msg_thread(void)
-{
-  pthread_t com_thread;
-  pthread_t cb_thread;
-  pthread_create(&com_thread, NULL, poll_ncp_msg, NULL);
-  pthread_create(&cb_thread, NULL, poll_cb_commands, NULL);
-}
@@ -205,13 +205,13 @@ bool emberAfPluginOtaUnicastBootloaderServerGetImageSegmentCallback(uint32_t sta
     return false;
   }
 
-  // Move to the start of the current segment
-  uint8_t* segment_start = gbl_image;
-  segment_start += startIndex;
   // Copy the returned segment of the image
-  memcpy(imageSegment,
-         segment_start,
-         (endIndex - startIndex + 1));
+  if (!emberAfPluginOtaUnicastBootloaderServerReadImageSegment(gbl_image,
+                                                               startIndex,
+                                                               endIndex,
+                                                               imageSegment)) {
+    return false;
+  }
 
   printf(".");
 
@@ -220,17 +220,21 @@ bool emberAfPluginOtaUnicastBootloaderServerGetImageSegmentCallback(uint32_t sta
 
 
 /**************************************************************************//**
- * A callback invoked when the image distribution process is terminated.
+ * A callback invoked when the image distribution process of a target is
+ * terminated.
  *****************************************************************************/
-void emberAfPluginOtaUnicastBootloaderServerImageDistributionCompleteCallback(EmberAfOtaUnicastBootloaderStatus status)
+void emberAfPluginOtaUnicastBootloaderServerTargetImageDistributionCompleteCallback(EmberNodeId targetId,
+                                                                                    EmberAfOtaUnicastBootloaderStatus status)
 {
-  printf("image distribution completed, 0x%x\n", status);
+  printf("image distribution to 0x%04X completed, 0x%x\n", targetId, status);
 }
 
 /**************************************************************************//**
- * A callback invoked when a bootload request process has completed.
+ * A callback invoked when the bootload request process of a target has
+ * completed.
  *****************************************************************************/
-void emberAfPluginOtaUnicastBootloaderServerRequestTargetBootloadCompleteCallback(EmberAfOtaUnicastBootloaderStatus status)
+void emberAfPluginOtaUnicastBootloaderServerTargetRequestTargetBootloadCompleteCallback(EmberNodeId targetId,
+                                                                                       EmberAfOtaUnicastBootloaderStatus status)
 {
-  printf("bootload request completed, 0x%x\n", status);
+  printf("bootload request to 0x%04X completed, 0x%x\n", targetId, status);
 }
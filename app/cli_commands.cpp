@@ -118,4 +118,36 @@ void load_cli_commands(std::unique_ptr<cli::Menu>& rootMenu)
     cli_load_gbl_file,
     "Loads the selected GBL file from disk to RAM for transmitting it later to the target node\n \
        <filename>         Name of the GBL file to load");
+  rootMenu->Insert(
+    "bootloader_unicast_journal",
+    cli_bootloader_unicast_journal,
+    "Records the OTA Unicast Image transmissions in a journal file and resumes the ones interrupted by a previous run. Load the GBL file first\n \
+       <filename>         Name of the journal file");
+  rootMenu->Insert(
+    "capture_start",
+    cli_capture_start,
+    "Records the CSP frames exchanged with the NCP in a pcapng file or a ring of files\n \
+       <filename>         Name of the capture file, suffixed with the file index when several files are used\n \
+       <max file size>    Size in bytes after which the next file is used, 0 for no limit\n \
+       <file count>       Number of files of the ring");
+  rootMenu->Insert(
+    "capture_stop",
+    cli_capture_stop,
+    "Stops the capture started with capture_start");
+  rootMenu->Insert(
+    "ncp_stats",
+    cli_ncp_stats,
+    "Prints the frame counters and the round trip latency of each command ID sent to the NCP");
+  rootMenu->Insert(
+    "response_timeout",
+    cli_response_timeout,
+    "Sets the time the NCP has to answer each command, and the retries of the commands it does not answer\n \
+       <timeout ms>       Response timeout in milliseconds, 0 for the default one\n \
+       <max retries>      Number of times a command is sent again\n \
+       <backoff ms>       Delay before the first retry, doubled for each following one");
+  rootMenu->Insert(
+    "sequence_numbers",
+    cli_sequence_numbers,
+    "Enables or disables the sequence numbers matching the NCP responses to their commands, if the NCP supports them\n \
+       <enable>           1 to enable, 0 to disable");
 }
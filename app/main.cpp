@@ -16,6 +16,7 @@
 
 #include <unistd.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <cli/cli.h>
 #include <cli/clilocalsession.h>
 #include <cli/filehistorystorage.h>
@@ -39,8 +40,71 @@ using CliTelnetServer = BoostAsioCliTelnetServer;
 using namespace cli;
 using namespace std;
 
-int main()
+// Processes the NCP messages and callbacks each time the descriptor is readable,
+// until the link to the NCP goes down
+static void watch_ncp_descriptor(boost::asio::posix::stream_descriptor& descriptor)
 {
+  descriptor.async_wait(boost::asio::posix::stream_descriptor::wait_read,
+                        [&descriptor](const boost::system::error_code& error)
+  {
+    if (!error && sl_connect_ncp_process_events() != EMBER_NCP_NO_RESPONSE) {
+      watch_ncp_descriptor(descriptor);
+    }
+  });
+}
+
+static boost::asio::io_context *ncpContext;
+static boost::asio::posix::stream_descriptor *ncpDescriptor;
+static boost::asio::posix::stream_descriptor *callbackDescriptor;
+
+// Watches the new descriptor of the NCP once the link is reconnected. Called
+// from the reconnection thread of the library.
+static void link_state_handler(sl_connect_ncp_instance_t *, sl_connect_ncp_link_state_t state)
+{
+  if (state != SL_CONNECT_NCP_LINK_UP) {
+    return;
+  }
+  boost::asio::post(*ncpContext, []()
+  {
+    // Both cancel the pending waits, if any
+    ncpDescriptor->release();
+    callbackDescriptor->cancel();
+    ncpDescriptor->assign(sl_connect_ncp_get_fd());
+    watch_ncp_descriptor(*ncpDescriptor);
+    watch_ncp_descriptor(*callbackDescriptor);
+  });
+}
+
+static void usage(const char *name)
+{
+  fprintf(stderr,
+          "Usage: %s [-t TRACES] [-a]\n"
+          "  -t TRACES  Library traces: sum of 0x1 (CSP IDs), 0x2 (CSP frames), 0x4 (callback queue)\n"
+          "  -a         Write the traces from a logger thread\n",
+          name);
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned int traces = 0;
+  bool asyncTraces = false;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "t:a")) != -1) {
+    switch (opt) {
+      case 't':
+        traces = strtoul(optarg, NULL, 0);
+        break;
+      case 'a':
+        asyncTraces = true;
+        break;
+      default:
+        usage(argv[0]);
+        return -1;
+    }
+  }
+  sl_connect_ncp_set_traces(traces, asyncTraces);
+
   try
   {
     CmdHandler colorCmd;
@@ -92,8 +156,22 @@ int main()
 
     app_init();
 
+    // The descriptors are owned by the library: release them instead of closing them
+    boost::asio::posix::stream_descriptor ncpFd(scheduler.AsioContext(), sl_connect_ncp_get_fd());
+    boost::asio::posix::stream_descriptor callbackFd(scheduler.AsioContext(), sl_connect_ncp_get_callback_fd());
+    ncpContext = &scheduler.AsioContext();
+    ncpDescriptor = &ncpFd;
+    callbackDescriptor = &callbackFd;
+    sl_connect_ncp_set_link_state_handler(link_state_handler);
+    watch_ncp_descriptor(ncpFd);
+    watch_ncp_descriptor(callbackFd);
+
     scheduler.Run();
 
+    sl_connect_ncp_set_link_state_handler(NULL);
+    ncpFd.release();
+    callbackFd.release();
+
     return 0;
   }
   catch (const std::exception& e)
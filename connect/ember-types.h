@@ -265,7 +265,8 @@ typedef struct {
    */
   EmberMessageLength length;
   /**
-   * A pointer to the message payload.
+   * A pointer to the message payload. In stack callbacks, it is only valid
+   * until the callback returns.
    */
   uint8_t *payload;
   /**
@@ -308,7 +309,8 @@ typedef struct {
    */
   EmberMessageLength length;
   /**
-   * A pointer to the message payload.
+   * A pointer to the message payload. In stack callbacks, it is only valid
+   * until the callback returns.
    */
   uint8_t *payload;
   /**
@@ -429,7 +431,8 @@ typedef struct {
    */
   EmberMessageLength length;
   /**
-   * A pointer to the message MAC payload.
+   * A pointer to the message MAC payload. In stack callbacks, it is only
+   * valid until the callback returns.
    */
   uint8_t *payload;
   /**
@@ -469,7 +472,8 @@ typedef struct {
    */
   EmberMessageLength length;
   /**
-   * A pointer to the message payload.
+   * A pointer to the message payload. In stack callbacks, it is only valid
+   * until the callback returns.
    */
   uint8_t *payload;
   /**
@@ -619,6 +619,12 @@ enum
  */
   EMBER_NCP_UNKNOWN_COMMAND_ID = 0xD0,
 
+/**
+ * @brief The NCP did not answer the command in time, or the link to the NCP
+ * is down. The other results of the call are not valid.
+ */
+  EMBER_NCP_NO_RESPONSE = 0xD1,
+
 //@}
 
 /**
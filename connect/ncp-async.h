@@ -0,0 +1,468 @@
+/***************************************************************************//**
+ * @brief Pipelined (non-blocking) variants of the Connect stack APIs
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef __CONNECT_NCP_ASYNC_H__
+#define __CONNECT_NCP_ASYNC_H__
+
+/* This ifdef allows the header to be used from both C and C++. */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "connect/ember.h"
+
+//------------------------------------------------------------------------------
+// Request handles
+//------------------------------------------------------------------------------
+
+/**
+ * @brief
+ * Handle on a command sent to the NCP whose response has not been consumed yet.
+ *
+ * Every blocking stack API (for instance emberNetworkState()) has a pipelined
+ * counterpart split in two halves:
+ * - emberXxxAsync() takes the input parameters, sends the command to the NCP
+ *   and returns immediately with a request handle.
+ * - emberXxxResult() takes the handle and the output parameters, waits for the
+ *   response if it has not arrived yet, decodes it and releases the handle.
+ *
+ * Several commands can therefore be in flight at the same time, the responses
+ * being matched to their request by the thread calling sl_connect_poll_ncp_msg().
+ * At most SL_CONNECT_NCP_MAX_PENDING_REQUESTS handles can be outstanding;
+ * when they are all in use, an Async call blocks until one is released. If
+ * none is released within the response timeout, or the link to the NCP is
+ * down, the returned handle is already failed: its Result function returns
+ * the EMBER_NCP_NO_RESPONSE results described in sl_connect_ncp_get_last_call_status().
+ * Each handle must be passed exactly once to the matching Result function.
+ */
+typedef struct sl_connect_ncp_request sl_connect_ncp_request_t;
+
+/**
+ * @brief
+ * Returns true if the response of the request has been received, or if the
+ * request failed.
+ */
+bool sl_connect_ncp_request_is_complete(const sl_connect_ncp_request_t *request);
+
+/**
+ * @brief
+ * Waits up to timeout milliseconds (forever if negative) for the response of
+ * the request. Returns true if the response has been received, or if the
+ * request failed.
+ */
+bool sl_connect_ncp_request_wait(sl_connect_ncp_request_t *request, int32_t timeout);
+
+//------------------------------------------------------------------------------
+// Batches
+//------------------------------------------------------------------------------
+
+/**
+ * @brief
+ * Sends the command of index in a batch, usually by calling an emberXxxAsync()
+ * function, and returns its request handle.
+ */
+typedef sl_connect_ncp_request_t *(*sl_connect_ncp_batch_submit_t)(uint16_t index, void *context);
+
+/**
+ * @brief
+ * Consumes the response of the command of index in a batch, usually by calling
+ * the emberXxxResult() function matching the one used to send it.
+ */
+typedef void (*sl_connect_ncp_batch_collect_t)(uint16_t index,
+                                               sl_connect_ncp_request_t *request,
+                                               void *context);
+
+/**
+ * @brief
+ * Runs count commands back to back and collects their results in order.
+ *
+ * Up to SL_CONNECT_NCP_BATCH_WINDOW commands are kept in flight: a command is
+ * sent as soon as the response of an earlier one has been collected, so the
+ * batch waits for about one NCP round trip per window rather than one per
+ * command, whatever its size. submit and collect are called from the calling
+ * thread, in index order.
+ */
+void sl_connect_ncp_run_batch(uint16_t count,
+                              sl_connect_ncp_batch_submit_t submit,
+                              sl_connect_ncp_batch_collect_t collect,
+                              void *context);
+
+/**
+ * @brief
+ * Reads all the NCP counters, indexed by EmberCounterType, in a single batch.
+ * Returns the first error reported by the NCP, if any; the counters it could
+ * not read are set to 0.
+ */
+EmberStatus sl_connect_ncp_get_counters(uint32_t counters[EMBER_COUNTER_TYPE_COUNT]);
+
+//------------------------------------------------------------------------------
+// Pipelined stack APIs
+//------------------------------------------------------------------------------
+
+// networkState
+sl_connect_ncp_request_t *emberNetworkStateAsync(void);
+EmberNetworkStatus emberNetworkStateResult(sl_connect_ncp_request_t *request);
+
+// stackIsUp
+sl_connect_ncp_request_t *emberStackIsUpAsync(void);
+bool emberStackIsUpResult(sl_connect_ncp_request_t *request);
+
+#ifdef SL_CATALOG_CONNECT_AES_SECURITY_PRESENT
+// setSecurityKey
+sl_connect_ncp_request_t *emberSetSecurityKeyAsync(EmberKeyData *key);
+EmberStatus emberSetSecurityKeyResult(sl_connect_ncp_request_t *request);
+
+// GetSecurityKey
+sl_connect_ncp_request_t *emberGetSecurityKeyAsync(EmberKeyData *key);
+EmberStatus emberGetSecurityKeyResult(sl_connect_ncp_request_t *request,
+                                      EmberKeyData *key);
+
+// setPsaSecurityKey
+sl_connect_ncp_request_t *emberSetPsaSecurityKeyAsync(mbedtls_svc_key_id_t key_id);
+EmberStatus emberSetPsaSecurityKeyResult(sl_connect_ncp_request_t *request);
+
+// RemovePsaSecurityKey
+sl_connect_ncp_request_t *emberRemovePsaSecurityKeyAsync(void);
+EmberStatus emberRemovePsaSecurityKeyResult(sl_connect_ncp_request_t *request);
+
+// setNcpSecurityKeyPersistent
+sl_connect_ncp_request_t *emberSetNcpSecurityKeyPersistentAsync(uint8_t *key,
+                                                                uint8_t keyLength,
+                                                                uint32_t key_id);
+EmberStatus emberSetNcpSecurityKeyPersistentResult(sl_connect_ncp_request_t *request);
+
+// setNcpSecurityKey
+sl_connect_ncp_request_t *emberSetNcpSecurityKeyAsync(uint8_t *key,
+                                                      uint8_t keyLength);
+EmberStatus emberSetNcpSecurityKeyResult(sl_connect_ncp_request_t *request);
+
+// getKeyId
+sl_connect_ncp_request_t *emberGetKeyIdAsync(void);
+mbedtls_svc_key_id_t emberGetKeyIdResult(sl_connect_ncp_request_t *request);
+
+#endif
+
+// getCounter
+sl_connect_ncp_request_t *emberGetCounterAsync(EmberCounterType counterType);
+EmberStatus emberGetCounterResult(sl_connect_ncp_request_t *request,
+                                  uint32_t* count);
+
+// setRadioChannelExtended
+sl_connect_ncp_request_t *emberSetRadioChannelExtendedAsync(uint16_t channel,
+                                                            bool persistent);
+EmberStatus emberSetRadioChannelExtendedResult(sl_connect_ncp_request_t *request);
+
+// setRadioChannel
+sl_connect_ncp_request_t *emberSetRadioChannelAsync(uint16_t channel);
+EmberStatus emberSetRadioChannelResult(sl_connect_ncp_request_t *request);
+
+// getRadioChannel
+sl_connect_ncp_request_t *emberGetRadioChannelAsync(void);
+uint16_t emberGetRadioChannelResult(sl_connect_ncp_request_t *request);
+
+// setRadioPower
+sl_connect_ncp_request_t *emberSetRadioPowerAsync(int16_t power,
+                                                  bool persistent);
+EmberStatus emberSetRadioPowerResult(sl_connect_ncp_request_t *request);
+
+// getRadioPower
+sl_connect_ncp_request_t *emberGetRadioPowerAsync(void);
+int16_t emberGetRadioPowerResult(sl_connect_ncp_request_t *request);
+
+// setRadioPowerMode
+sl_connect_ncp_request_t *emberSetRadioPowerModeAsync(bool radioOn);
+EmberStatus emberSetRadioPowerModeResult(sl_connect_ncp_request_t *request);
+
+// setUnencryptedPacketsAcceptance
+sl_connect_ncp_request_t *emberSetUnencryptedPacketsAcceptanceAsync(bool accept);
+EmberStatus emberSetUnencryptedPacketsAcceptanceResult(sl_connect_ncp_request_t *request);
+
+// setMacParams
+sl_connect_ncp_request_t *emberSetMacParamsAsync(int8_t ccaThreshold,
+                                                 uint8_t maxCcaAttempts,
+                                                 uint8_t minBackoffExp,
+                                                 uint8_t maxBackoffExp,
+                                                 uint16_t ccaBackoff,
+                                                 uint16_t ccaDuration,
+                                                 uint8_t maxRetries,
+                                                 uint32_t csmaTimeout,
+                                                 uint16_t ackTimeout);
+EmberStatus emberSetMacParamsResult(sl_connect_ncp_request_t *request);
+
+// currentStackTasks
+sl_connect_ncp_request_t *emberCurrentStackTasksAsync(void);
+uint16_t emberCurrentStackTasksResult(sl_connect_ncp_request_t *request);
+
+// okToNap
+sl_connect_ncp_request_t *emberOkToNapAsync(void);
+bool emberOkToNapResult(sl_connect_ncp_request_t *request);
+
+// okToHibernate
+sl_connect_ncp_request_t *emberOkToHibernateAsync(void);
+bool emberOkToHibernateResult(sl_connect_ncp_request_t *request);
+
+// getEui64
+// The result is stored as by emberGetEui64()
+sl_connect_ncp_request_t *emberGetEui64Async(void);
+uint8_t* emberGetEui64Result(sl_connect_ncp_request_t *request);
+
+// macGetParentAddress
+sl_connect_ncp_request_t *emberMacGetParentAddressAsync(EmberMacAddress *parentAddress);
+EmberStatus emberMacGetParentAddressResult(sl_connect_ncp_request_t *request,
+                                           EmberMacAddress *parentAddress);
+
+// isLocalEui64
+sl_connect_ncp_request_t *emberIsLocalEui64Async(EmberEUI64 eui64);
+bool emberIsLocalEui64Result(sl_connect_ncp_request_t *request);
+
+// getNodeId
+sl_connect_ncp_request_t *emberGetNodeIdAsync(void);
+EmberNodeId emberGetNodeIdResult(sl_connect_ncp_request_t *request);
+
+// getPanId
+sl_connect_ncp_request_t *emberGetPanIdAsync(void);
+EmberPanId emberGetPanIdResult(sl_connect_ncp_request_t *request);
+
+// getParentId
+sl_connect_ncp_request_t *emberGetParentIdAsync(void);
+EmberNodeId emberGetParentIdResult(sl_connect_ncp_request_t *request);
+
+// getNodeType
+sl_connect_ncp_request_t *emberGetNodeTypeAsync(void);
+EmberNodeType emberGetNodeTypeResult(sl_connect_ncp_request_t *request);
+
+// calibrateCurrentChannelExtended
+sl_connect_ncp_request_t *emberCalibrateCurrentChannelExtendedAsync(uint32_t calValueIn);
+EmberStatus emberCalibrateCurrentChannelExtendedResult(sl_connect_ncp_request_t *request,
+                                                       uint32_t* calValueOut);
+
+// applyIrCalibration
+sl_connect_ncp_request_t *emberApplyIrCalibrationAsync(uint32_t calValue);
+EmberStatus emberApplyIrCalibrationResult(sl_connect_ncp_request_t *request);
+
+// tempCalibration
+sl_connect_ncp_request_t *emberTempCalibrationAsync(void);
+EmberStatus emberTempCalibrationResult(sl_connect_ncp_request_t *request);
+
+// getCalType
+sl_connect_ncp_request_t *emberGetCalTypeAsync(void);
+EmberCalType emberGetCalTypeResult(sl_connect_ncp_request_t *request);
+
+// getMaximumPayloadLength
+sl_connect_ncp_request_t *emberGetMaximumPayloadLengthAsync(EmberMacAddressMode srcAddressMode,
+                                                            EmberMacAddressMode dstAddressMode,
+                                                            bool interpan,
+                                                            bool secured);
+uint16_t emberGetMaximumPayloadLengthResult(sl_connect_ncp_request_t *request);
+
+// setIndirectQueueTimeout
+sl_connect_ncp_request_t *emberSetIndirectQueueTimeoutAsync(uint32_t timeoutMs);
+EmberStatus emberSetIndirectQueueTimeoutResult(sl_connect_ncp_request_t *request);
+
+// getVersionInfo
+sl_connect_ncp_request_t *emberGetVersionInfoAsync(void);
+EmberStatus emberGetVersionInfoResult(sl_connect_ncp_request_t *request,
+                                      uint16_t* gsdkVersion,
+                                      uint16_t* connectStackVersion,
+                                      uint32_t* bootloaderVersion);
+
+// ofdmSetMcs
+sl_connect_ncp_request_t *emberOfdmSetMcsAsync(uint8_t mcs);
+EmberStatus emberOfdmSetMcsResult(sl_connect_ncp_request_t *request);
+
+// ofdmGetMcs
+sl_connect_ncp_request_t *emberOfdmGetMcsAsync(void);
+EmberStatus emberOfdmGetMcsResult(sl_connect_ncp_request_t *request,
+                                  uint8_t* mcs);
+
+// usingLongMessages
+sl_connect_ncp_request_t *emberUsingLongMessagesAsync(void);
+bool emberUsingLongMessagesResult(sl_connect_ncp_request_t *request);
+
+// messageSend
+sl_connect_ncp_request_t *emberMessageSendAsync(EmberNodeId destination,
+                                                uint8_t endpoint,
+                                                uint8_t messageTag,
+                                                EmberMessageLength messageLength,
+                                                uint8_t *message,
+                                                EmberMessageOptions options);
+EmberStatus emberMessageSendResult(sl_connect_ncp_request_t *request);
+
+// pollForData
+sl_connect_ncp_request_t *emberPollForDataAsync(void);
+EmberStatus emberPollForDataResult(sl_connect_ncp_request_t *request);
+
+// macMessageSend
+sl_connect_ncp_request_t *emberMacMessageSendAsync(EmberMacFrame *macFrame,
+                                                   uint8_t messageTag,
+                                                   EmberMessageLength messageLength,
+                                                   uint8_t *message,
+                                                   EmberMessageOptions options);
+EmberStatus emberMacMessageSendResult(sl_connect_ncp_request_t *request);
+
+// macSetPanCoordinator
+sl_connect_ncp_request_t *emberMacSetPanCoordinatorAsync(bool isCoordinator);
+EmberStatus emberMacSetPanCoordinatorResult(sl_connect_ncp_request_t *request);
+
+// setPollDestinationAddress
+sl_connect_ncp_request_t *emberSetPollDestinationAddressAsync(EmberMacAddress *destination);
+EmberStatus emberSetPollDestinationAddressResult(sl_connect_ncp_request_t *request);
+
+// removeChild
+sl_connect_ncp_request_t *emberRemoveChildAsync(EmberMacAddress *address);
+EmberStatus emberRemoveChildResult(sl_connect_ncp_request_t *request);
+
+// getChildFlags
+sl_connect_ncp_request_t *emberGetChildFlagsAsync(EmberMacAddress *address);
+EmberStatus emberGetChildFlagsResult(sl_connect_ncp_request_t *request,
+                                     EmberChildFlags* flags);
+
+// getChildInfo
+sl_connect_ncp_request_t *emberGetChildInfoAsync(EmberMacAddress *address);
+EmberStatus emberGetChildInfoResult(sl_connect_ncp_request_t *request,
+                                    EmberMacAddress *addressResp,
+                                    EmberChildFlags* flags);
+
+// purgeIndirectMessages
+sl_connect_ncp_request_t *emberPurgeIndirectMessagesAsync(void);
+EmberStatus emberPurgeIndirectMessagesResult(sl_connect_ncp_request_t *request);
+
+// macAddShortToLongAddressMapping
+sl_connect_ncp_request_t *emberMacAddShortToLongAddressMappingAsync(EmberNodeId shortId,
+                                                                    EmberEUI64 longId);
+EmberStatus emberMacAddShortToLongAddressMappingResult(sl_connect_ncp_request_t *request);
+
+// macClearShortToLongAddressMappings
+sl_connect_ncp_request_t *emberMacClearShortToLongAddressMappingsAsync(void);
+EmberStatus emberMacClearShortToLongAddressMappingsResult(sl_connect_ncp_request_t *request);
+
+// networkLeave
+sl_connect_ncp_request_t *emberNetworkLeaveAsync(void);
+EmberStatus emberNetworkLeaveResult(sl_connect_ncp_request_t *request);
+
+// networkInit
+sl_connect_ncp_request_t *emberNetworkInitAsync(void);
+EmberStatus emberNetworkInitResult(sl_connect_ncp_request_t *request);
+
+// startActiveScan
+sl_connect_ncp_request_t *emberStartActiveScanAsync(uint16_t channel);
+EmberStatus emberStartActiveScanResult(sl_connect_ncp_request_t *request);
+
+// startEnergyScan
+sl_connect_ncp_request_t *emberStartEnergyScanAsync(uint16_t channel,
+                                                    uint8_t samples);
+EmberStatus emberStartEnergyScanResult(sl_connect_ncp_request_t *request);
+
+// setApplicationBeaconPayload
+sl_connect_ncp_request_t *emberSetApplicationBeaconPayloadAsync(uint8_t payloadLength,
+                                                                uint8_t *payload);
+EmberStatus emberSetApplicationBeaconPayloadResult(sl_connect_ncp_request_t *request);
+
+// setSelectiveJoinPayload
+sl_connect_ncp_request_t *emberSetSelectiveJoinPayloadAsync(uint8_t payloadLength,
+                                                            uint8_t *payload);
+EmberStatus emberSetSelectiveJoinPayloadResult(sl_connect_ncp_request_t *request);
+
+// clearSelectiveJoinPayload
+sl_connect_ncp_request_t *emberClearSelectiveJoinPayloadAsync(void);
+EmberStatus emberClearSelectiveJoinPayloadResult(sl_connect_ncp_request_t *request);
+
+// formNetwork
+sl_connect_ncp_request_t *emberFormNetworkAsync(EmberNetworkParameters *parameters);
+EmberStatus emberFormNetworkResult(sl_connect_ncp_request_t *request);
+
+// joinNetworkExtended
+sl_connect_ncp_request_t *emberJoinNetworkExtendedAsync(EmberNodeType nodeType,
+                                                        EmberNodeId nodeId,
+                                                        EmberNetworkParameters *parameters);
+EmberStatus emberJoinNetworkExtendedResult(sl_connect_ncp_request_t *request);
+
+// joinNetwork
+sl_connect_ncp_request_t *emberJoinNetworkAsync(EmberNodeType nodeType,
+                                                EmberNetworkParameters *parameters);
+EmberStatus emberJoinNetworkResult(sl_connect_ncp_request_t *request);
+
+// macFormNetwork
+sl_connect_ncp_request_t *emberMacFormNetworkAsync(EmberNetworkParameters *parameters);
+EmberStatus emberMacFormNetworkResult(sl_connect_ncp_request_t *request);
+
+// permitJoining
+sl_connect_ncp_request_t *emberPermitJoiningAsync(uint8_t duration);
+EmberStatus emberPermitJoiningResult(sl_connect_ncp_request_t *request);
+
+// joinCommissioned
+sl_connect_ncp_request_t *emberJoinCommissionedAsync(EmberNodeType nodeType,
+                                                     EmberNodeId nodeId,
+                                                     EmberNetworkParameters *parameters);
+EmberStatus emberJoinCommissionedResult(sl_connect_ncp_request_t *request);
+
+// resetNetworkState
+sl_connect_ncp_request_t *emberResetNetworkStateAsync(void);
+void emberResetNetworkStateResult(sl_connect_ncp_request_t *request);
+
+// frequencyHoppingSetChannelMask
+sl_connect_ncp_request_t *emberFrequencyHoppingSetChannelMaskAsync(uint8_t channelMaskLength,
+                                                                   uint8_t *channelMask);
+EmberStatus emberFrequencyHoppingSetChannelMaskResult(sl_connect_ncp_request_t *request);
+
+// frequencyHoppingStartServer
+sl_connect_ncp_request_t *emberFrequencyHoppingStartServerAsync(void);
+EmberStatus emberFrequencyHoppingStartServerResult(sl_connect_ncp_request_t *request);
+
+// frequencyHoppingStartClient
+sl_connect_ncp_request_t *emberFrequencyHoppingStartClientAsync(EmberNodeId serverNodeId,
+                                                                EmberPanId serverPanId);
+EmberStatus emberFrequencyHoppingStartClientResult(sl_connect_ncp_request_t *request);
+
+// frequencyHoppingStop
+sl_connect_ncp_request_t *emberFrequencyHoppingStopAsync(void);
+EmberStatus emberFrequencyHoppingStopResult(sl_connect_ncp_request_t *request);
+
+// setAuxiliaryAddressFilteringEntry
+sl_connect_ncp_request_t *emberSetAuxiliaryAddressFilteringEntryAsync(EmberNodeId nodeId,
+                                                                      uint8_t entryIndex);
+EmberStatus emberSetAuxiliaryAddressFilteringEntryResult(sl_connect_ncp_request_t *request);
+
+// getAuxiliaryAddressFilteringEntry
+sl_connect_ncp_request_t *emberGetAuxiliaryAddressFilteringEntryAsync(uint8_t entryIndex);
+EmberNodeId emberGetAuxiliaryAddressFilteringEntryResult(sl_connect_ncp_request_t *request);
+
+// startTxStream
+sl_connect_ncp_request_t *emberStartTxStreamAsync(EmberTxStreamParameters parameters,
+                                                  uint16_t channel);
+EmberStatus emberStartTxStreamResult(sl_connect_ncp_request_t *request);
+
+// stopTxStream
+sl_connect_ncp_request_t *emberStopTxStreamAsync(void);
+EmberStatus emberStopTxStreamResult(sl_connect_ncp_request_t *request);
+
+// setActiveScanDuration
+sl_connect_ncp_request_t *emberSetActiveScanDurationAsync(uint16_t durationMs);
+EmberStatus emberSetActiveScanDurationResult(sl_connect_ncp_request_t *request);
+
+// getActiveScanDuration
+sl_connect_ncp_request_t *emberGetActiveScanDurationAsync(void);
+uint16_t emberGetActiveScanDurationResult(sl_connect_ncp_request_t *request);
+
+// getDefaultChannel
+sl_connect_ncp_request_t *emberGetDefaultChannelAsync(void);
+uint16_t emberGetDefaultChannelResult(sl_connect_ncp_request_t *request);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__CONNECT_NCP_ASYNC_H__
@@ -0,0 +1,67 @@
+/***************************************************************************//**
+ * @brief In-process NCP simulator
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef __CONNECT_NCP_SIMULATOR_H__
+#define __CONNECT_NCP_SIMULATOR_H__
+
+/* This ifdef allows the header to be used from both C and C++. */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "connect/ncp.h"
+
+/**
+ * @brief
+ * Behavior of a simulated NCP. A zeroed configuration answers immediately and
+ * injects no traffic.
+ */
+typedef struct {
+  /** Time the simulated NCP takes to answer each command, in microseconds. */
+  uint32_t response_delay_us;
+  /** Period of the incoming messages injected by the simulated NCP, in microseconds. 0 injects none. */
+  uint32_t indication_period_us;
+  /** Payload length of the injected incoming messages. */
+  uint16_t indication_payload_length;
+  /** Source node ID of the injected incoming messages. */
+  EmberNodeId indication_source;
+  /** Endpoint of the injected incoming messages. */
+  uint8_t indication_endpoint;
+} sl_connect_ncp_simulator_config_t;
+
+/**
+ * @brief
+ * Initializes an instance connected to a simulated NCP running in a thread of the calling process.
+ *
+ * The simulated NCP answers every command of the CSP protocol. Commands without simulated behavior get a response made of
+ * zeroes, which is EMBER_SUCCESS for the ones returning a status. The network state, node ID, PAN ID, node type and radio
+ * channel follow the network management commands, which also trigger the matching stack status indications, and every sent
+ * message is confirmed by a message sent indication. The NCP and the host share a SOCK_SEQPACKET socket pair, so frames are
+ * delimited as on a CPC endpoint.
+ */
+sl_connect_ncp_instance_t *sl_connect_ncp_init_simulator(const sl_connect_ncp_simulator_config_t *config);
+
+/**
+ * @brief
+ * Makes a simulated NCP send a raw CSP frame, for instance a recorded stack callback, to the host.
+ */
+void sl_connect_ncp_simulator_inject(sl_connect_ncp_instance_t *instance, const uint8_t *frame, uint16_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__CONNECT_NCP_SIMULATOR_H__
@@ -0,0 +1,118 @@
+/***************************************************************************//**
+ * @brief Runtime subscriptions to the Connect stack callbacks
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef __CONNECT_NCP_SUBSCRIPTIONS_H__
+#define __CONNECT_NCP_SUBSCRIPTIONS_H__
+
+/* This ifdef allows the header to be used from both C and C++. */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "connect/ember.h"
+
+/**
+ * @brief
+ * Subscribe to all the endpoints.
+ */
+#define SL_CONNECT_ANY_ENDPOINT 0xFFFF
+
+/**
+ * @brief
+ * Handle on a registered handler.
+ *
+ * Any number of independent modules can subscribe to the stack callbacks, in
+ * addition to the emberAfXxxCallback() functions the application may define.
+ * Message callbacks are routed by endpoint: a handler is only called for the
+ * messages of the endpoint it subscribed to, or for all the messages if it
+ * subscribed to SL_CONNECT_ANY_ENDPOINT. Handlers of a given endpoint are
+ * called before the ones subscribed to any endpoint, each group in
+ * subscription order.
+ *
+ * Handlers are called from the thread dispatching the stack callbacks, without
+ * any lock held: they may subscribe or unsubscribe, including themselves.
+ */
+typedef struct sl_connect_subscription sl_connect_subscription_t;
+
+typedef void (*sl_connect_stack_status_handler_t)(EmberStatus status, void *context);
+
+typedef void (*sl_connect_incoming_message_handler_t)(EmberIncomingMessage *message, void *context);
+
+typedef void (*sl_connect_message_sent_handler_t)(EmberStatus status,
+                                                  EmberOutgoingMessage *message,
+                                                  void *context);
+
+/**
+ * @brief
+ * Calls handler with context on each emberAfStackStatusCallback().
+ */
+sl_connect_subscription_t *sl_connect_subscribe_stack_status(sl_connect_stack_status_handler_t handler,
+                                                             void *context);
+
+/**
+ * @brief
+ * Calls handler with context on each emberAfIncomingMessageCallback() for
+ * endpoint (or any endpoint if SL_CONNECT_ANY_ENDPOINT).
+ */
+sl_connect_subscription_t *sl_connect_subscribe_incoming_message(uint16_t endpoint,
+                                                                 sl_connect_incoming_message_handler_t handler,
+                                                                 void *context);
+
+/**
+ * @brief
+ * Calls handler with context on each emberAfMessageSentCallback() for endpoint
+ * (or any endpoint if SL_CONNECT_ANY_ENDPOINT).
+ */
+sl_connect_subscription_t *sl_connect_subscribe_message_sent(uint16_t endpoint,
+                                                             sl_connect_message_sent_handler_t handler,
+                                                             void *context);
+
+/**
+ * @brief
+ * Removes a subscription. The handler is not called anymore once this returns,
+ * except by a dispatch already running on another thread.
+ */
+void sl_connect_unsubscribe(sl_connect_subscription_t *subscription);
+
+/**
+ * @brief
+ * Copies a message received by a stack callback, so that it can be used after
+ * the callback returns.
+ *
+ * The payload of the messages passed to the callbacks points into the buffer
+ * of the callback queue, which is reused once the callback returns. The copy
+ * holds the message and its payload in one allocation, released by
+ * sl_connect_release_message().
+ */
+EmberIncomingMessage *sl_connect_retain_incoming_message(const EmberIncomingMessage *message);
+
+EmberOutgoingMessage *sl_connect_retain_outgoing_message(const EmberOutgoingMessage *message);
+
+EmberIncomingMacMessage *sl_connect_retain_incoming_mac_message(const EmberIncomingMacMessage *message);
+
+EmberOutgoingMacMessage *sl_connect_retain_outgoing_mac_message(const EmberOutgoingMacMessage *message);
+
+/**
+ * @brief
+ * Releases a message returned by one of the sl_connect_retain_xxx() functions.
+ */
+void sl_connect_release_message(void *message);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
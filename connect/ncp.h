@@ -25,7 +25,10 @@ extern "C" {
 // Stack specific types, call-able APIs and config
 //------------------------------------------------------------------------------
 
+#include <stdio.h>
 #include "connect/ember.h"
+#include "connect/ncp-async.h"
+#include "connect/ncp-subscriptions.h"
 
 //------------------------------------------------------------------------------
 // Connect Host library API
@@ -36,17 +39,228 @@ extern "C" {
  * Initializes the Connect NCP Host library.
  *
  * It starts the CPC connection with the daemon as well as a the callback queue and an internal Mutex.
+ * This is equivalent to sl_connect_ncp_init_instance(NULL).
  */
 void sl_connect_ncp_init(void);
 
+/**
+ * @brief
+ * Handle on an NCP driven through its own CPC daemon instance.
+ */
+typedef struct sl_connect_ncp_instance sl_connect_ncp_instance_t;
+
+/**
+ * @brief
+ * Initializes the connection with the NCP of a CPC daemon instance.
+ *
+ * Each instance has its own CPC endpoint, pending commands and callback queue. Up to SL_CONNECT_NCP_MAX_INSTANCES instances
+ * can be initialized. The first one is the default instance.
+ *
+ * @param cpcd_instance_name Name of the CPC daemon instance, NULL for the default one (cpcd_0).
+ */
+sl_connect_ncp_instance_t *sl_connect_ncp_init_instance(const char *cpcd_instance_name);
+
+/**
+ * @brief
+ * Link to an NCP carrying one CSP frame per read or write, as a CPC endpoint does.
+ *
+ * The library calls open() from sl_connect_ncp_init_instance_with_transport(), then write() to send each command and read()
+ * each time the descriptor returned by open() is readable. When a read or a write fails, close() then open() are called again to
+ * reconnect. All the functions get the context member as first argument.
+ */
+typedef struct {
+  /** Connects to the NCP. Returns a descriptor readable whenever a frame can be read, negative on failure. */
+  int (*open)(void *context);
+  /** Sends one frame. Returns the number of bytes written, negative on failure. */
+  int (*write)(void *context, const void *frame, unsigned int length);
+  /** Reads one frame into a buffer of capacity bytes. Returns its length, 0 or negative on failure. */
+  int (*read)(void *context, void *frame, unsigned int capacity);
+  /** Returns the version of the software running on the NCP. Can be NULL. */
+  const char *(*get_version)(void *context);
+  void *context;
+  /** Releases the link before open() is called again to reconnect it. Can be NULL. */
+  void (*close)(void *context);
+} sl_connect_ncp_transport_t;
+
+/**
+ * @brief
+ * Initializes the connection with an NCP reached through the given transport instead of a CPC daemon.
+ *
+ * The transport is copied. Otherwise the instance behaves as one returned by sl_connect_ncp_init_instance().
+ */
+sl_connect_ncp_instance_t *sl_connect_ncp_init_instance_with_transport(const sl_connect_ncp_transport_t *transport);
+
+/**
+ * @brief
+ * Selects the instance used by the calling thread.
+ *
+ * Every stack API and every sl_connect_* API called afterwards by this thread applies to this instance. Threads that never
+ * select an instance use the default one. Polling threads and threads handling callbacks must select their instance first;
+ * the callbacks are then executed with the instance that received them selected.
+ */
+void sl_connect_ncp_select_instance(sl_connect_ncp_instance_t *instance);
+
+/**
+ * @brief
+ * Gets the instance used by the calling thread.
+ */
+sl_connect_ncp_instance_t *sl_connect_ncp_get_current_instance(void);
+
 /**
  * @brief
  * Polls the communication with the CPC daemon and dispatches incoming messages to the rest of the library.
  *
- * This API needs to have its own dedicated polling thread, implemented by the user, to prevent blocking the communication with the NCP.
+ * This API can be called from a dedicated polling thread, implemented by the user. Alternatively, the library can be run from the
+ * application event loop with sl_connect_ncp_get_fd(), sl_connect_ncp_get_callback_fd() and sl_connect_ncp_process_events().
+ * In both cases, a thread waiting for a command response reads the NCP messages itself while no other thread does.
+ *
+ * Returns EMBER_NCP_NO_RESPONSE while the link to the NCP is not up, once its state changed or the timeout elapsed.
  */
 EmberStatus sl_connect_poll_ncp_msg(int32_t timeout);
 
+/**
+ * @brief
+ * Gets the file descriptor of the communication with the CPC daemon.
+ *
+ * It becomes readable when a message is received from the NCP. The descriptor is owned by the library and must not be closed
+ * nor read by the application.
+ */
+int sl_connect_ncp_get_fd(void);
+
+/**
+ * @brief
+ * Gets the file descriptor of the callback queue.
+ *
+ * It becomes readable when callback commands are pending. The descriptor is owned by the library and must not be closed nor
+ * read by the application.
+ */
+int sl_connect_ncp_get_callback_fd(void);
+
+/**
+ * @brief
+ * Processes the messages already received from the NCP, then executes every pending callback command, without blocking.
+ *
+ * This API is meant to be called from the application event loop (epoll, Boost.Asio, ...) whenever the file descriptor returned by
+ * sl_connect_ncp_get_fd() or sl_connect_ncp_get_callback_fd() is readable. It replaces the dedicated polling threads.
+ *
+ * Returns EMBER_NCP_NO_RESPONSE while the link to the NCP is not up. The descriptor returned by sl_connect_ncp_get_fd() must then
+ * not be watched anymore: it may stay readable until the link is reconnected. The link state handler tells when to watch the
+ * new one.
+ */
+EmberStatus sl_connect_ncp_process_events(void);
+
+/**
+ * @brief
+ * Sets how long the NCP of the current instance has to answer each command, SL_CONNECT_NCP_RESPONSE_TIMEOUT_MS by default.
+ *
+ * A command that is not answered in time, after its retries, returns EMBER_NCP_NO_RESPONSE from
+ * sl_connect_ncp_get_last_call_status() instead of terminating the process. 0 restores the default.
+ */
+void sl_connect_ncp_set_response_timeout(uint32_t timeout_ms);
+
+/**
+ * @brief
+ * Overrides the response timeout of the instance for the commands sent by the calling thread. 0 removes the override.
+ */
+void sl_connect_ncp_set_thread_response_timeout(uint32_t timeout_ms);
+
+/**
+ * @brief
+ * Sets how many times a command of the current instance is sent again when its response timed out, none by default.
+ *
+ * The n-th retry is sent backoff_ms << (n - 1) milliseconds after the timeout, capped at 60 seconds by default
+ * (SL_CONNECT_NCP_MAX_RETRY_BACKOFF_MS). Only commands that can safely be executed twice by the NCP should be used with
+ * retries, as the NCP may have executed a command whose response was lost.
+ */
+void sl_connect_ncp_set_retry_policy(uint8_t max_retries, uint32_t backoff_ms);
+
+/**
+ * @brief
+ * Negotiates the sequence numbers in the frames exchanged with the NCP of the current instance, disabled by default.
+ *
+ * Each command is then followed by a one byte sequence number that the NCP appends to its response. A response is only handed
+ * to the command it carries the number of: the late response of a command that timed out, or of the previous send of a retried
+ * command, is dropped instead of being decoded as the response of the next command with the same identifier. Without them,
+ * responses are matched by their order and command identifier only.
+ *
+ * The NCP firmware must support them. They are only used once the NCP accepted the setting, so that with a firmware that does
+ * not, this returns EMBER_NCP_NO_RESPONSE or the error status of the NCP and the frames keep their format. The commands of the
+ * other threads are held until the NCP answered. The accepted setting is restored when the link is reconnected.
+ */
+EmberStatus sl_connect_ncp_set_sequence_numbers(bool enable);
+
+/**
+ * @brief
+ * Gets the status of the last command sent by the calling thread: EMBER_SUCCESS if the NCP answered it, EMBER_NCP_NO_RESPONSE
+ * if it timed out or the link to the NCP is down.
+ *
+ * The results of a call that did not get a response are not valid, a returned EmberStatus being EMBER_NCP_NO_RESPONSE. It is
+ * set by every stack API and by every *Result() function of ncp-async.h.
+ */
+EmberStatus sl_connect_ncp_get_last_call_status(void);
+
+/**
+ * @brief
+ * State of the link to an NCP.
+ */
+typedef enum {
+  /** Commands are sent to the NCP. */
+  SL_CONNECT_NCP_LINK_UP,
+  /** A read or a write failed and the link is being reopened. Pending commands have failed; new ones are held until the link is
+   *  up again and the NCP configuration restored. */
+  SL_CONNECT_NCP_LINK_RECONNECTING,
+  /** A read or a write failed and the link is not reopened automatically anymore. Commands fail with EMBER_NCP_NO_RESPONSE
+   *  until sl_connect_ncp_reconnect() succeeds. */
+  SL_CONNECT_NCP_LINK_DOWN,
+} sl_connect_ncp_link_state_t;
+
+/**
+ * @brief
+ * Called when the link to the NCP of an instance changes state, without any lock held: from the thread that noticed a failure,
+ * from the thread that reconnected the link, or from the reconnection thread of the instance.
+ */
+typedef void (*sl_connect_ncp_link_state_handler_t)(sl_connect_ncp_instance_t *instance, sl_connect_ncp_link_state_t state);
+
+/**
+ * @brief
+ * Sets the handler called when the link to an NCP changes state, for all instances. NULL removes it.
+ */
+void sl_connect_ncp_set_link_state_handler(sl_connect_ncp_link_state_handler_t handler);
+
+/**
+ * @brief
+ * Gets the state of the link to the NCP of the current instance.
+ */
+sl_connect_ncp_link_state_t sl_connect_ncp_get_link_state(void);
+
+/**
+ * @brief
+ * Returns true if the state of the link to the NCP of the current instance is SL_CONNECT_NCP_LINK_UP.
+ */
+bool sl_connect_ncp_link_is_up(void);
+
+/**
+ * @brief
+ * Sets for how long the link to the NCP of the current instance is reopened automatically after a failure, every
+ * SL_CONNECT_NCP_RECONNECT_PERIOD_MS, SL_CONNECT_NCP_RECONNECT_TIMEOUT_MS by default. 0 disables the automatic reconnection.
+ */
+void sl_connect_ncp_set_auto_reconnect(uint32_t timeout_ms);
+
+/**
+ * @brief
+ * Closes then opens again the link to the NCP of the current instance, then restores the NCP configuration.
+ *
+ * Commands still pending fail with EMBER_NCP_NO_RESPONSE and the response cache is invalidated. The settings last accepted by
+ * sl_connect_ncp_set_sequence_numbers(), emberNcpSetLongMessagesUse(), emberSetSecurityKey(), emberSetRadioChannel(), emberSetRadioChannelExtended(),
+ * emberSetRadioPower() and emberSetMacParams(), or by the Result() functions of their asynchronous variants, are sent again, as the
+ * NCP may have been reset, and the host follows the message format of the NCP. Commands of the other threads are held meanwhile.
+ * Applications running the library from their event loop must watch the new descriptor returned by sl_connect_ncp_get_fd()
+ * afterwards. Returns EMBER_NCP_NO_RESPONSE if the link could not be opened or the NCP did not answer.
+ *
+ * The automatic reconnection does the same.
+ */
+EmberStatus sl_connect_ncp_reconnect(void);
+
 /**
  * @brief
  * Polls the callback queue to see if any callback command is pending.
@@ -60,11 +274,182 @@ EmberStatus sl_connect_ncp_poll_callback_command(int32_t timeout);
  * @brief
  * Execute every pending callback command in the queue.
  *
- * This API needs to be called regularly to prevent blocking the callback queue. Once the queue is full, no other callback can be
- * written into it and will thus be irremediably lost.
+ * This API needs to be called regularly to prevent blocking the callback queue. Once the queue is full, incoming callbacks are
+ * handled according to the policy set with sl_connect_ncp_set_callback_queue_policy().
  */
 void sl_connect_ncp_handle_pending_callback_commands();
 
+/**
+ * @brief
+ * Behaviour of the callback queue when a callback is received while it is full.
+ */
+typedef enum {
+  /** The incoming callback is dropped. */
+  SL_CONNECT_NCP_CALLBACK_QUEUE_DROP_NEWEST,
+  /** The oldest pending callback is dropped to make room for the incoming one. */
+  SL_CONNECT_NCP_CALLBACK_QUEUE_DROP_OLDEST,
+  /** An incoming state callback (stack status, radio calibration request)
+   *  replaces the most recent pending callback with the same command ID. The
+   *  other callbacks, and state callbacks without a pending one, are dropped. */
+  SL_CONNECT_NCP_CALLBACK_QUEUE_COALESCE,
+  /** The incoming callback is kept aside and the poll thread waits until it
+   *  has been queued before reading the next NCP message (default). A thread
+   *  waiting for a command response keeps reading the messages meanwhile, the
+   *  callbacks it receives being kept aside as well, and so does a thread that
+   *  also handles the callbacks: sl_connect_ncp_process_events() handles them
+   *  whenever the queue is full. */
+  SL_CONNECT_NCP_CALLBACK_QUEUE_BLOCK,
+} sl_connect_ncp_callback_queue_policy_t;
+
+/**
+ * @brief
+ * Callback queue counters.
+ */
+typedef struct {
+  /** Number of callbacks the queue can hold. */
+  uint16_t capacity;
+  /** Highest number of callbacks pending at the same time. */
+  uint16_t high_water_mark;
+  /** Number of callbacks dropped because the queue was full. */
+  uint32_t dropped;
+  /** Number of callbacks that replaced a pending one with the same command ID. */
+  uint32_t coalesced;
+} sl_connect_ncp_callback_queue_stats_t;
+
+/**
+ * @brief
+ * Sets the callback queue overflow policy of the current instance. A new policy takes effect once the callbacks pending
+ * in the queue have been handled.
+ */
+void sl_connect_ncp_set_callback_queue_policy(sl_connect_ncp_callback_queue_policy_t policy);
+
+/**
+ * @brief
+ * Gets the callback queue counters.
+ */
+void sl_connect_ncp_get_callback_queue_stats(sl_connect_ncp_callback_queue_stats_t *stats);
+
+/**
+ * @brief
+ * Statistics of the commands of one command ID sent to the NCP. Latencies are the round trip times in microseconds between
+ * the command being first written to the NCP and its response being read, retries included, measured with a histogram
+ * accurate to about 1.6%.
+ */
+typedef struct {
+  /** Command ID. */
+  uint16_t command_id;
+  /** Number of responses received. */
+  uint32_t responses;
+  /** Number of times a command was not answered in time, each retry included. */
+  uint32_t timeouts;
+  /** Number of responses received after more than half of the response timeout of their command. */
+  uint32_t slow_responses;
+  /** Bytes of the commands sent. */
+  uint64_t bytes_sent;
+  /** Bytes of the responses received. */
+  uint64_t bytes_received;
+  uint32_t min_us;
+  uint32_t mean_us;
+  uint32_t p50_us;
+  uint32_t p90_us;
+  uint32_t p99_us;
+  uint32_t p999_us;
+  uint32_t max_us;
+} sl_connect_ncp_command_stats_t;
+
+/**
+ * @brief
+ * Counters of the frames exchanged with the NCP, callbacks included.
+ */
+typedef struct {
+  uint64_t frames_sent;
+  uint64_t bytes_sent;
+  uint64_t frames_received;
+  uint64_t bytes_received;
+  /** Number of times a command was not answered in time, each retry included. */
+  uint32_t timeouts;
+} sl_connect_ncp_link_stats_t;
+
+/**
+ * @brief
+ * Gets the statistics of every command ID sent to the NCP of the current instance since its initialization or the last
+ * sl_connect_ncp_reset_stats().
+ * @param stats Array receiving the statistics.
+ * @param max_count Number of entries of the array.
+ * @return The number of entries written.
+ */
+uint16_t sl_connect_ncp_get_command_stats(sl_connect_ncp_command_stats_t *stats, uint16_t max_count);
+
+/**
+ * @brief
+ * Gets a percentile, between 0 and 100, of the round trip latency in microseconds of a command ID. Returns 0 if no response was
+ * received for this command ID.
+ */
+uint32_t sl_connect_ncp_get_command_latency_percentile(uint16_t command_id, double percentile);
+
+/**
+ * @brief
+ * Gets the frame counters of the current instance.
+ */
+void sl_connect_ncp_get_link_stats(sl_connect_ncp_link_stats_t *stats);
+
+/**
+ * @brief
+ * Clears the command statistics and the frame counters of the current instance.
+ */
+void sl_connect_ncp_reset_stats(void);
+
+/**
+ * @brief
+ * Writes the frame counters and a table of the command statistics of the current instance to stream.
+ */
+void sl_connect_ncp_dump_stats(FILE *stream);
+
+/**
+ * @brief
+ * Enables or disables the host-side cache of the current instance for getters
+ * whose answer only changes with the network state (EUI64, node ID, PAN ID,
+ * node type, maximum payload length, default channel and version info). The
+ * cache is cleared on each stack status indication and on each host command
+ * that can change these values. Disabled by default.
+ */
+void sl_connect_ncp_set_response_cache(bool enable);
+
+/**
+ * @brief
+ * Starts recording every CSP frame exchanged with the NCPs of all instances to a pcapng file.
+ * Each instance is a pcapng interface and each packet is a direction byte (0 from the host to the NCP, 1 from the NCP to the
+ * host) followed by the CSP frame, with the LINKTYPE_USER0 link type. Packets are timestamped in nanoseconds with the monotonic
+ * clock, relative to the wall clock time of the capture start.
+ * @param path Path of the capture file. With several files, the index of the file is appended to the path (path.0, path.1, ...).
+ * @param max_file_size Size in bytes after which the capture continues in the next file, 0 for no limit.
+ * @param file_count Number of files used as a ring, the oldest one being overwritten once they are all used.
+ * @return EMBER_SUCCESS, EMBER_INVALID_CALL if a capture is already running, EMBER_BAD_ARGUMENT or EMBER_ERR_FATAL if the file
+ * can not be created.
+ */
+EmberStatus sl_connect_ncp_start_capture(const char *path, uint32_t max_file_size, uint8_t file_count);
+
+/**
+ * @brief
+ * Stops the capture started with sl_connect_ncp_start_capture() and closes its file. Called at exit as well.
+ */
+void sl_connect_ncp_stop_capture(void);
+
+/** Trace of the identifier of each CSP frame exchanged with the NCPs. */
+#define SL_CONNECT_NCP_TRACE_CSP_ID         (1 << 0)
+/** Trace of the content of each CSP frame exchanged with the NCPs. */
+#define SL_CONNECT_NCP_TRACE_CSP_FULL       (1 << 1)
+/** Trace of the callbacks appended to and handled from the callback queues. */
+#define SL_CONNECT_NCP_TRACE_CALLBACK_QUEUE (1 << 2)
+
+/**
+ * @brief
+ * Selects the debug traces of the library, written to the standard output: a combination of SL_CONNECT_NCP_TRACE_* flags,
+ * 0 for none (the default). With async set, the traces are queued to a logger thread instead of being formatted and written by
+ * the thread producing them, which keeps the traces of the CSP traffic from slowing it down.
+ */
+void sl_connect_ncp_set_traces(unsigned int traces, bool async);
+
 /**
  * @brief
  * Gets the GSDK version running on the NCP
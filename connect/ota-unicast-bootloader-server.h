@@ -61,11 +61,45 @@ extern "C" {
 #define EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_UNICAST_ERRORS       4
 
 /**
- * @brief The time in milliseconds after which the server gives up waiting for
- * a response from a client.
+ * @brief The initial time in milliseconds after which the server gives up
+ * waiting for a response from a client. The timeout then follows the measured
+ * round trip time to the client, within the [MIN, MAX] range below, and
+ * doubles after each timeout.
  */
 #define EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_RESPONSE_TIMEOUT_MS    250
 
+/**
+ * @brief The minimum adaptive response timeout in milliseconds.
+ */
+#define EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MIN_RESPONSE_TIMEOUT_MS 50
+
+/**
+ * @brief The maximum adaptive response timeout in milliseconds.
+ */
+#define EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_RESPONSE_TIMEOUT_MS 2000
+
+/**
+ * @brief The amount in segments per second by which the transmission rate to
+ * a target grows for each acknowledged segment. The rate is the inverse of the
+ * interval between transmissions, which starts at
+ * ::EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_TX_INTERVAL_MS, or at 0 for
+ * image distributions with a window of several segments.
+ */
+#define EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_TX_RATE_STEP            5
+
+/**
+ * @brief After a failure (no ACK, stack error or no response) the interval
+ * between transmissions to a target doubles plus this amount in milliseconds.
+ * It is also the minimum amount by which the interval shrinks for each
+ * acknowledged segment.
+ */
+#define EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_TX_INTERVAL_STEP_MS     10
+
+/**
+ * @brief The maximum transmission interval in milliseconds.
+ */
+#define EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_TX_INTERVAL_MS      1000
+
 //------------------------------------------------------------------------------
 // APIs
 
@@ -81,7 +115,9 @@ extern "C" {
  * types.
  *
  * @return An ::EmberAfOtaUnicastBootloaderStatus value of:
- * - ::EMBER_OTA_UNICAST_BOOTLOADER_STATUS_BUSY if an image distribution is
+ * - ::EMBER_OTA_UNICAST_BOOTLOADER_STATUS_BUSY if the target is already
+ * involved in a process or if
+ * ::EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_SESSIONS processes are
  * already in progress
  * - ::EMBER_OTA_UNICAST_BOOTLOADER_STATUS_INVALID_CALL if the given target or
  * the image size is invalid
@@ -114,8 +150,8 @@ EmberAfOtaUnicastBootloaderStatus emberAfPluginOtaUnicastBootloaderServerInitiat
  * is invoked when the request process is completed.
  * - ::EMBER_OTA_UNICAST_BOOTLOADER_STATUS_INVALID_CALL if some of the passed
  * parameters are invalid.
- * - ::EMBER_OTA_UNICAST_BOOTLOADER_STATUS_BUSY if the server is currently
- * involved in another over-the-air process.
+ * - ::EMBER_OTA_UNICAST_BOOTLOADER_STATUS_BUSY if the target is currently
+ * involved in another over-the-air process or if no session is available.
  */
 EmberAfOtaUnicastBootloaderStatus emberAfPluginUnicastBootloaderServerInitiateRequestTargetBootload(
   uint32_t bootloadDelayMs,
@@ -123,11 +159,11 @@ EmberAfOtaUnicastBootloaderStatus emberAfPluginUnicastBootloaderServerInitiateRe
   EmberNodeId targetId
   );
 
-/** @brief  Abort the ongoing process, such as image distribution
- *  or bootload request.
+/** @brief  Abort the ongoing processes, such as image distribution
+ *  or bootload request, of all the targets of the current NCP instance.
  *
  * @return An ::EmberAfOtaUnicastBootloaderStatus value of:
- * - ::EMBER_OTA_UNICAST_BOOTLOADER_STATUS_SUCCESS if the current ongoing
+ * - ::EMBER_OTA_UNICAST_BOOTLOADER_STATUS_SUCCESS if at least one ongoing
  * process was successfully aborted.
  * - ::EMBER_OTA_UNICAST_BOOTLOADER_STATUS_INVALID_CALL if the server is not
  * currently involved in any process.
@@ -136,6 +172,126 @@ EmberAfOtaUnicastBootloaderStatus emberAfPluginOtaUnicastBootloaderServerAbortCu
   void
   );
 
+/** @brief  Abort the ongoing process, such as image distribution
+ *  or bootload request, of a single target.
+ *
+ * @param[in] targetId  The node ID of the target.
+ *
+ * @return An ::EmberAfOtaUnicastBootloaderStatus value of:
+ * - ::EMBER_OTA_UNICAST_BOOTLOADER_STATUS_SUCCESS if the process was
+ * successfully aborted.
+ * - ::EMBER_OTA_UNICAST_BOOTLOADER_STATUS_INVALID_CALL if the target is not
+ * currently involved in any process.
+ */
+EmberAfOtaUnicastBootloaderStatus emberAfPluginOtaUnicastBootloaderServerAbortTargetProcess(
+  EmberNodeId targetId
+  );
+
+/**
+ * @{
+ * @name Image sources
+ *
+ * Images are files mapped in memory. The pages are read from the file on
+ * demand, with readahead, and opening the same file several times returns the
+ * same mapping, so concurrent distributions of an image share one copy.
+ */
+
+/** @brief  An image opened with
+ * ::emberAfPluginOtaUnicastBootloaderServerOpenImage().
+ */
+typedef struct EmberAfOtaUnicastBootloaderImage EmberAfOtaUnicastBootloaderImage;
+
+/** @brief  Open an image file (GBL file, for instance).
+ *
+ * The file is mapped in memory and read while the image is open. It must not
+ * be modified in place meanwhile: the distributions would read the new
+ * content, and a truncated file makes the process crash with SIGBUS. Replace
+ * it atomically instead, by writing the new version to another file of the
+ * same file system and renaming it over the old one. The open image keeps
+ * reading the old version, and the next open maps the new one.
+ *
+ * @param[in] path  The path of the file.
+ *
+ * @return The image, or NULL if the file can't be opened or mapped.
+ */
+EmberAfOtaUnicastBootloaderImage *emberAfPluginOtaUnicastBootloaderServerOpenImage(
+  const char *path
+  );
+
+/** @brief  Release an image. The file is unmapped once all the users of the
+ * image closed it. The image must not be used by an ongoing distribution.
+ */
+void emberAfPluginOtaUnicastBootloaderServerCloseImage(
+  EmberAfOtaUnicastBootloaderImage *image
+  );
+
+/** @brief  Return the size of an image in bytes.
+ */
+uint32_t emberAfPluginOtaUnicastBootloaderServerGetImageSize(
+  const EmberAfOtaUnicastBootloaderImage *image
+  );
+
+/** @brief  Copy a contiguous segment of an image. It can be called from
+ * ::emberAfPluginOtaUnicastBootloaderServerGetImageSegmentCallback().
+ *
+ * @return false if the image is NULL or the segment is out of the image.
+ */
+bool emberAfPluginOtaUnicastBootloaderServerReadImageSegment(
+  EmberAfOtaUnicastBootloaderImage *image,
+  uint32_t startIndex,
+  uint32_t endIndex,
+  uint8_t *imageSegment
+  );
+
+/** @brief  Set the image distributed for an image tag, or NULL to clear it.
+ * The default implementation of
+ * ::emberAfPluginOtaUnicastBootloaderServerGetImageSegmentCallback() reads the
+ * segments from this image.
+ */
+void emberAfPluginOtaUnicastBootloaderServerSetImageSource(
+  uint8_t imageTag,
+  EmberAfOtaUnicastBootloaderImage *image
+  );
+
+/**
+ * @}
+ */
+
+/**
+ * @{
+ * @name Resume journal
+ *
+ * The server can record the progress of the image distributions in a journal
+ * file: the target and its NCP instance, the image tag, size and hash, and the
+ * last segment acknowledged by the target. Distributions interrupted by a
+ * restart of the host are then resumed by the next run of the server.
+ */
+
+/** @brief  Record the image distributions in a journal file, and resume the
+ * distributions left unfinished in this file by a previous run.
+ *
+ * A distribution is resumed on the NCP instance that started it, if the image
+ * provided for its tag still has the same size and hash, so the NCP instances
+ * and the image sources must be initialized before this call. The target then
+ * reports the segment from which the distribution continues. The completion of
+ * resumed distributions is reported by the usual callbacks. Distributions whose
+ * image changed are forgotten.
+ *
+ * @param[in] path  The path of the journal file, created if needed.
+ *
+ * @return An ::EmberAfOtaUnicastBootloaderStatus value of:
+ * - ::EMBER_OTA_UNICAST_BOOTLOADER_STATUS_SUCCESS if the journal is enabled.
+ * - ::EMBER_OTA_UNICAST_BOOTLOADER_STATUS_INVALID_CALL if the journal can't be
+ * read or written.
+ */
+EmberAfOtaUnicastBootloaderStatus emberAfPluginOtaUnicastBootloaderServerEnableJournal(
+  const char *path
+  );
+
+/**
+ * @}
+ */
+
 /**
  * @{
  * @name Callbacks
@@ -212,6 +368,39 @@ void emberAfPluginOtaUnicastBootloaderServerRequestTargetBootloadCompleteCallbac
   EmberAfOtaUnicastBootloaderStatus status
   );
 
+/** @brief  A callback invoked when the image distribution process of a target
+ * is terminated. Several image distributions can run at the same time, this
+ * callback tells which one completed.
+ *
+ * The default implementation calls
+ * ::emberAfPluginOtaUnicastBootloaderServerImageDistributionCompleteCallback().
+ *
+ * @param[in]   targetId  The node ID of the target.
+ *
+ * @param[in]   status    See
+ * ::emberAfPluginOtaUnicastBootloaderServerImageDistributionCompleteCallback().
+ */
+void emberAfPluginOtaUnicastBootloaderServerTargetImageDistributionCompleteCallback(
+  EmberNodeId targetId,
+  EmberAfOtaUnicastBootloaderStatus status
+  );
+
+/** @brief  A callback invoked when the bootload request process of a target
+ * has completed.
+ *
+ * The default implementation calls
+ * ::emberAfPluginOtaUnicastBootloaderServerRequestTargetBootloadCompleteCallback().
+ *
+ * @param[in]   targetId  The node ID of the target.
+ *
+ * @param[in]   status    See
+ * ::emberAfPluginOtaUnicastBootloaderServerRequestTargetBootloadCompleteCallback().
+ */
+void emberAfPluginOtaUnicastBootloaderServerTargetRequestTargetBootloadCompleteCallback(
+  EmberNodeId targetId,
+  EmberAfOtaUnicastBootloaderStatus status
+  );
+
 /**
  * @}
  *
@@ -548,7 +548,9 @@ bool emberOkToHibernate(void);
 
 /** @brief Return the EUI64 ID of the local node.
  *
- * @return The 64-bit ID.
+ * @return The 64-bit ID, in a buffer of the calling thread for the current NCP
+ * instance. It is overwritten by the next call from the same thread to the
+ * same instance.
  */
 uint8_t *emberGetEui64(void);
 
@@ -69,6 +69,7 @@ enum {
   EMBER_OFDM_GET_MCS_IPC_COMMAND_ID                                    = VNCP_CMD_ID + 0x55,
   EMBER_NCP_SET_LONG_MESSAGES_USE_IPC_COMMAND_ID                       = VNCP_CMD_ID + 0x56,
   EMBER_USING_LONG_MESSAGES_IPC_COMMAND_ID                             = VNCP_CMD_ID + 0x57,
+  EMBER_NCP_SET_SEQUENCE_NUMBERS_USE_IPC_COMMAND_ID                    = VNCP_CMD_ID + 0x59,
   EMBER_STACK_STATUS_HANDLER_IPC_COMMAND_ID                            = STACK_CALLBACK_ID + 0x00,
   EMBER_CHILD_JOIN_HANDLER_IPC_COMMAND_ID                              = STACK_CALLBACK_ID + 0x01,
   EMBER_RADIO_NEEDS_CALIBRATING_HANDLER_IPC_COMMAND_ID                 = STACK_CALLBACK_ID + 0x30,
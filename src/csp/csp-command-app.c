@@ -14,391 +14,479 @@
  *
  ******************************************************************************/
 
-// *** Generated file. Do not edit! ***
+// Initially generated from the vNCP API description, now maintained by hand:
+// the encoders and decoders of each command follow csp-format.h, whose
+// encoders only compile with a parameter of the type they write.
 // vNCP Version: 1.0
 
+#include <string.h>
 #include "connect/ember.h"
+#include "connect/ncp-async.h"
 
 #include "csp-format.h"
 #include "csp-command-utils.h"
 #include "csp-api-enum-gen.h"
+#include "host-common/ncp-host-common.h"
+#include "host-common/response-cache.h"
+#include "host-common/ncp-restore.h"
 
 // networkState
-EmberNetworkStatus emberNetworkState(void)
+sl_connect_ncp_request_t *emberNetworkStateAsync(void)
+{
+  return submitCommand(startCommand(EMBER_NETWORK_STATE_IPC_COMMAND_ID));
+}
+
+EmberNetworkStatus emberNetworkStateResult(sl_connect_ncp_request_t *request)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_NETWORK_STATE_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
-  EmberNetworkStatus networkStatus;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &networkStatus);
-  releaseCommandMutex();
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberNetworkStatus networkStatus = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return networkStatus;
 }
 
+EmberNetworkStatus emberNetworkState(void)
+{
+  return emberNetworkStateResult(emberNetworkStateAsync());
+}
+
 // stackIsUp
-bool emberStackIsUp(void)
+sl_connect_ncp_request_t *emberStackIsUpAsync(void)
+{
+  return submitCommand(startCommand(EMBER_STACK_IS_UP_IPC_COMMAND_ID));
+}
+
+bool emberStackIsUpResult(sl_connect_ncp_request_t *request)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_STACK_IS_UP_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
-  bool stackIsUp;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &stackIsUp);
-  releaseCommandMutex();
+  uint8_t *finger = waitForCommandResponse(request);
+  bool stackIsUp = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return stackIsUp;
 }
 
+bool emberStackIsUp(void)
+{
+  return emberStackIsUpResult(emberStackIsUpAsync());
+}
+
 #ifdef SL_CATALOG_CONNECT_AES_SECURITY_PRESENT
 // setSecurityKey
-EmberStatus emberSetSecurityKey(EmberKeyData *key)
+sl_connect_ncp_request_t *emberSetSecurityKeyAsync(EmberKeyData *key)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_SET_SECURITY_KEY_IPC_COMMAND_ID,
-                                          "b",
-                                          key, sizeof(EmberKeyData));
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  uint8_t *finger = startCommand(EMBER_SET_SECURITY_KEY_IPC_COMMAND_ID);
+  cspEncodeBuffer(&finger, key->contents, EMBER_ENCRYPTION_KEY_SIZE);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberSetSecurityKeyResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  if (status == EMBER_SUCCESS) {
+    EmberKeyData key;
+    finger = commandParameters(request);
+    cspDecodeBuffer(&finger, commandParametersEnd(request), key.contents, EMBER_ENCRYPTION_KEY_SIZE);
+    sli_connect_ncp_restore_security_key(&key);
+  }
+  releaseCommandRequest(request);
   return status;
 }
 
+EmberStatus emberSetSecurityKey(EmberKeyData *key)
+{
+  return emberSetSecurityKeyResult(emberSetSecurityKeyAsync(key));
+}
+
 #endif
 
 #ifdef SL_CATALOG_CONNECT_AES_SECURITY_PRESENT
 // GetSecurityKey
-EmberStatus emberGetSecurityKey(EmberKeyData *key)
+sl_connect_ncp_request_t *emberGetSecurityKeyAsync(EmberKeyData *key)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_GET_SECURITY_KEY_IPC_COMMAND_ID,
-                                          "b",
-                                          key->contents,
-                                          EMBER_ENCRYPTION_KEY_SIZE);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
-  EmberStatus status;
+  uint8_t *finger = startCommand(EMBER_GET_SECURITY_KEY_IPC_COMMAND_ID);
+  cspEncodeBuffer(&finger, key->contents, EMBER_ENCRYPTION_KEY_SIZE);
+  return submitCommand(finger);
+}
 
-  uint8_t Size = EMBER_ENCRYPTION_KEY_SIZE;
-  fetchApiParams(apiCommandData,
-                 "ub",
-                 &status,
-                 key->contents,
-                 true,
-                 &Size,
-                 EMBER_ENCRYPTION_KEY_SIZE);
-  releaseCommandMutex();
+EmberStatus emberGetSecurityKeyResult(sl_connect_ncp_request_t *request,
+                                      EmberKeyData *key)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  cspDecodeBuffer(&finger, commandResponseEnd(request), key->contents, EMBER_ENCRYPTION_KEY_SIZE);
+  releaseCommandRequest(request);
   return status;
 }
 
+EmberStatus emberGetSecurityKey(EmberKeyData *key)
+{
+  return emberGetSecurityKeyResult(emberGetSecurityKeyAsync(key),
+                                   key);
+}
+
 #endif
 
 #ifdef SL_CATALOG_CONNECT_AES_SECURITY_PRESENT
 // setPsaSecurityKey
-EmberStatus emberSetPsaSecurityKey(mbedtls_svc_key_id_t key_id)
+sl_connect_ncp_request_t *emberSetPsaSecurityKeyAsync(mbedtls_svc_key_id_t key_id)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_SET_PSA_SECURITY_KEY_IPC_COMMAND_ID,
-                                          "w",
-                                          key_id);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  uint8_t *finger = startCommand(EMBER_SET_PSA_SECURITY_KEY_IPC_COMMAND_ID);
+  cspEncodeUint32(&finger, key_id);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberSetPsaSecurityKeyResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
+EmberStatus emberSetPsaSecurityKey(mbedtls_svc_key_id_t key_id)
+{
+  return emberSetPsaSecurityKeyResult(emberSetPsaSecurityKeyAsync(key_id));
+}
+
 #endif
 
 #ifdef SL_CATALOG_CONNECT_AES_SECURITY_PRESENT
 // RemovePsaSecurityKey
-EmberStatus emberRemovePsaSecurityKey(void)
+sl_connect_ncp_request_t *emberRemovePsaSecurityKeyAsync(void)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_REMOVE_PSA_SECURITY_KEY_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return submitCommand(startCommand(EMBER_REMOVE_PSA_SECURITY_KEY_IPC_COMMAND_ID));
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberRemovePsaSecurityKeyResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
+EmberStatus emberRemovePsaSecurityKey(void)
+{
+  return emberRemovePsaSecurityKeyResult(emberRemovePsaSecurityKeyAsync());
+}
+
 #endif
 
 #ifdef SL_CATALOG_CONNECT_AES_SECURITY_PRESENT
 // setNcpSecurityKeyPersistent
+sl_connect_ncp_request_t *emberSetNcpSecurityKeyPersistentAsync(uint8_t *key,
+                                                                uint8_t keyLength,
+                                                                uint32_t key_id)
+{
+  uint8_t *finger = startCommand(EMBER_SET_NCP_SECURITY_KEY_PERSISTENT_IPC_COMMAND_ID);
+  cspEncodeBuffer(&finger, key, keyLength);
+  cspEncodeUint32(&finger, key_id);
+  return submitCommand(finger);
+}
+
+EmberStatus emberSetNcpSecurityKeyPersistentResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
+  return status;
+}
+
 EmberStatus emberSetNcpSecurityKeyPersistent(uint8_t *key,
                                              uint8_t keyLength,
                                              uint32_t key_id)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_SET_NCP_SECURITY_KEY_PERSISTENT_IPC_COMMAND_ID,
-                                          "bw",
-                                          key,
-                                          keyLength,
-                                          key_id);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
-  return status;
+  return emberSetNcpSecurityKeyPersistentResult(emberSetNcpSecurityKeyPersistentAsync(key,
+                                                                                      keyLength,
+                                                                                      key_id));
 }
 
 #endif
 
 #ifdef SL_CATALOG_CONNECT_AES_SECURITY_PRESENT
 // setNcpSecurityKey
-EmberStatus emberSetNcpSecurityKey(uint8_t *key,
-                                   uint8_t keyLength)
+sl_connect_ncp_request_t *emberSetNcpSecurityKeyAsync(uint8_t *key,
+                                                      uint8_t keyLength)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_SET_NCP_SECURITY_KEY_IPC_COMMAND_ID,
-                                          "b",
-                                          key,
-                                          keyLength);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  uint8_t *finger = startCommand(EMBER_SET_NCP_SECURITY_KEY_IPC_COMMAND_ID);
+  cspEncodeBuffer(&finger, key, keyLength);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberSetNcpSecurityKeyResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
+EmberStatus emberSetNcpSecurityKey(uint8_t *key,
+                                   uint8_t keyLength)
+{
+  return emberSetNcpSecurityKeyResult(emberSetNcpSecurityKeyAsync(key,
+                                                                  keyLength));
+}
+
 #endif
 
 #ifdef SL_CATALOG_CONNECT_AES_SECURITY_PRESENT
 // getKeyId
-mbedtls_svc_key_id_t emberGetKeyId(void)
+sl_connect_ncp_request_t *emberGetKeyIdAsync(void)
+{
+  return submitCommand(startCommand(EMBER_GET_KEY_ID_IPC_COMMAND_ID));
+}
+
+mbedtls_svc_key_id_t emberGetKeyIdResult(sl_connect_ncp_request_t *request)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_GET_KEY_ID_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
-  mbedtls_svc_key_id_t key_id;
-  fetchApiParams(apiCommandData,
-                 "w",
-                 &key_id);
-  releaseCommandMutex();
+  uint8_t *finger = waitForCommandResponse(request);
+  mbedtls_svc_key_id_t key_id = cspDecodeUint32(&finger);
+  releaseCommandRequest(request);
   return key_id;
 }
 
+mbedtls_svc_key_id_t emberGetKeyId(void)
+{
+  return emberGetKeyIdResult(emberGetKeyIdAsync());
+}
+
 #endif
 
 // getCounter
+sl_connect_ncp_request_t *emberGetCounterAsync(EmberCounterType counterType)
+{
+  uint8_t *finger = startCommand(EMBER_GET_COUNTER_IPC_COMMAND_ID);
+  cspEncodeUint8(&finger, counterType);
+  return submitCommand(finger);
+}
+
+EmberStatus emberGetCounterResult(sl_connect_ncp_request_t *request,
+                                  uint32_t* count)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  *count = cspDecodeUint32(&finger);
+  releaseCommandRequest(request);
+  return status;
+}
+
 EmberStatus emberGetCounter(EmberCounterType counterType,
                             uint32_t* count)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_GET_COUNTER_IPC_COMMAND_ID,
-                                          "u",
-                                          counterType);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberGetCounterResult(emberGetCounterAsync(counterType),
+                               count);
+}
 
-  EmberStatus status;
+// setRadioChannelExtended
+sl_connect_ncp_request_t *emberSetRadioChannelExtendedAsync(uint16_t channel,
+                                                            bool persistent)
+{
+  uint8_t *finger = startCommand(EMBER_SET_RADIO_CHANNEL_EXTENDED_IPC_COMMAND_ID);
+  invalidateCacheOnSubmit();
+  cspEncodeUint16(&finger, channel);
+  cspEncodeUint8(&finger, persistent);
+  return submitCommand(finger);
+}
 
-  fetchApiParams(apiCommandData,
-                 "uw",
-                 &status,
-                 count);
-  releaseCommandMutex();
+EmberStatus emberSetRadioChannelExtendedResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  if (status == EMBER_SUCCESS) {
+    finger = commandParameters(request);
+    sli_connect_ncp_restore_radio_channel(cspDecodeUint16(&finger));
+  }
+  releaseCommandRequest(request);
   return status;
 }
 
-// setRadioChannelExtended
 EmberStatus emberSetRadioChannelExtended(uint16_t channel,
                                          bool persistent)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_SET_RADIO_CHANNEL_EXTENDED_IPC_COMMAND_ID,
-                                          "vu",
-                                          channel,
-                                          persistent);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
-  return status;
+  return emberSetRadioChannelExtendedResult(emberSetRadioChannelExtendedAsync(channel,
+                                                                              persistent));
 }
 
 // setRadioChannel
-EmberStatus emberSetRadioChannel(uint16_t channel)
+sl_connect_ncp_request_t *emberSetRadioChannelAsync(uint16_t channel)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_SET_RADIO_CHANNEL_IPC_COMMAND_ID,
-                                          "v",
-                                          channel);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  uint8_t *finger = startCommand(EMBER_SET_RADIO_CHANNEL_IPC_COMMAND_ID);
+  invalidateCacheOnSubmit();
+  cspEncodeUint16(&finger, channel);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberSetRadioChannelResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  if (status == EMBER_SUCCESS) {
+    finger = commandParameters(request);
+    sli_connect_ncp_restore_radio_channel(cspDecodeUint16(&finger));
+  }
+  releaseCommandRequest(request);
   return status;
 }
 
+EmberStatus emberSetRadioChannel(uint16_t channel)
+{
+  return emberSetRadioChannelResult(emberSetRadioChannelAsync(channel));
+}
+
 // getRadioChannel
-uint16_t emberGetRadioChannel(void)
+sl_connect_ncp_request_t *emberGetRadioChannelAsync(void)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_GET_RADIO_CHANNEL_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return submitCommand(startCommand(EMBER_GET_RADIO_CHANNEL_IPC_COMMAND_ID));
+}
 
-  uint16_t channel;
-  fetchApiParams(apiCommandData,
-                 "v",
-                 &channel);
-  releaseCommandMutex();
+uint16_t emberGetRadioChannelResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  uint16_t channel = cspDecodeUint16(&finger);
+  releaseCommandRequest(request);
   return channel;
 }
 
+uint16_t emberGetRadioChannel(void)
+{
+  return emberGetRadioChannelResult(emberGetRadioChannelAsync());
+}
+
 // setRadioPower
-EmberStatus emberSetRadioPower(int16_t power,
-                               bool persistent)
+sl_connect_ncp_request_t *emberSetRadioPowerAsync(int16_t power,
+                                                  bool persistent)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_SET_RADIO_POWER_IPC_COMMAND_ID,
-                                          "vu",
-                                          power,
-                                          persistent);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  uint8_t *finger = startCommand(EMBER_SET_RADIO_POWER_IPC_COMMAND_ID);
+  cspEncodeInt16(&finger, power);
+  cspEncodeUint8(&finger, persistent);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberSetRadioPowerResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  if (status == EMBER_SUCCESS) {
+    finger = commandParameters(request);
+    sli_connect_ncp_restore_radio_power(cspDecodeInt16(&finger));
+  }
+  releaseCommandRequest(request);
   return status;
 }
 
+EmberStatus emberSetRadioPower(int16_t power,
+                               bool persistent)
+{
+  return emberSetRadioPowerResult(emberSetRadioPowerAsync(power,
+                                                          persistent));
+}
+
 // getRadioPower
-int16_t emberGetRadioPower(void)
+sl_connect_ncp_request_t *emberGetRadioPowerAsync(void)
+{
+  return submitCommand(startCommand(EMBER_GET_RADIO_POWER_IPC_COMMAND_ID));
+}
+
+int16_t emberGetRadioPowerResult(sl_connect_ncp_request_t *request)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_GET_RADIO_POWER_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
-  int16_t power;
-  fetchApiParams(apiCommandData,
-                 "v",
-                 &power);
-  releaseCommandMutex();
+  uint8_t *finger = waitForCommandResponse(request);
+  int16_t power = cspDecodeInt16(&finger);
+  releaseCommandRequest(request);
   return power;
 }
 
+int16_t emberGetRadioPower(void)
+{
+  return emberGetRadioPowerResult(emberGetRadioPowerAsync());
+}
+
 // setRadioPowerMode
-EmberStatus emberSetRadioPowerMode(bool radioOn)
+sl_connect_ncp_request_t *emberSetRadioPowerModeAsync(bool radioOn)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_SET_RADIO_POWER_MODE_IPC_COMMAND_ID,
-                                          "u",
-                                          radioOn);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  uint8_t *finger = startCommand(EMBER_SET_RADIO_POWER_MODE_IPC_COMMAND_ID);
+  cspEncodeUint8(&finger, radioOn);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberSetRadioPowerModeResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
+EmberStatus emberSetRadioPowerMode(bool radioOn)
+{
+  return emberSetRadioPowerModeResult(emberSetRadioPowerModeAsync(radioOn));
+}
+
 // setUnencryptedPacketsAcceptance
-EmberStatus emberSetUnencryptedPacketsAcceptance(bool accept)
+sl_connect_ncp_request_t *emberSetUnencryptedPacketsAcceptanceAsync(bool accept)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_SET_UNENCRYPTED_PACKETS_ACCEPTANCE_IPC_COMMAND_ID,
-                                          "u",
-                                          accept);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  uint8_t *finger = startCommand(EMBER_SET_UNENCRYPTED_PACKETS_ACCEPTANCE_IPC_COMMAND_ID);
+  cspEncodeUint8(&finger, accept);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberSetUnencryptedPacketsAcceptanceResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
+EmberStatus emberSetUnencryptedPacketsAcceptance(bool accept)
+{
+  return emberSetUnencryptedPacketsAcceptanceResult(emberSetUnencryptedPacketsAcceptanceAsync(accept));
+}
+
 // setMacParams
+sl_connect_ncp_request_t *emberSetMacParamsAsync(int8_t ccaThreshold,
+                                                 uint8_t maxCcaAttempts,
+                                                 uint8_t minBackoffExp,
+                                                 uint8_t maxBackoffExp,
+                                                 uint16_t ccaBackoff,
+                                                 uint16_t ccaDuration,
+                                                 uint8_t maxRetries,
+                                                 uint32_t csmaTimeout,
+                                                 uint16_t ackTimeout)
+{
+  uint8_t *finger = startCommand(EMBER_SET_MAC_PARAMS_IPC_COMMAND_ID);
+  cspEncodeInt8(&finger, ccaThreshold);
+  cspEncodeUint8(&finger, maxCcaAttempts);
+  cspEncodeUint8(&finger, minBackoffExp);
+  cspEncodeUint8(&finger, maxBackoffExp);
+  cspEncodeUint16(&finger, ccaBackoff);
+  cspEncodeUint16(&finger, ccaDuration);
+  cspEncodeUint8(&finger, maxRetries);
+  cspEncodeUint32(&finger, csmaTimeout);
+  cspEncodeUint16(&finger, ackTimeout);
+  return submitCommand(finger);
+}
+
+EmberStatus emberSetMacParamsResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  if (status == EMBER_SUCCESS) {
+    sli_connect_ncp_mac_params_t params;
+    finger = commandParameters(request);
+    params.ccaThreshold = cspDecodeInt8(&finger);
+    params.maxCcaAttempts = cspDecodeUint8(&finger);
+    params.minBackoffExp = cspDecodeUint8(&finger);
+    params.maxBackoffExp = cspDecodeUint8(&finger);
+    params.ccaBackoff = cspDecodeUint16(&finger);
+    params.ccaDuration = cspDecodeUint16(&finger);
+    params.maxRetries = cspDecodeUint8(&finger);
+    params.csmaTimeout = cspDecodeUint32(&finger);
+    params.ackTimeout = cspDecodeUint16(&finger);
+    sli_connect_ncp_restore_mac_params(&params);
+  }
+  releaseCommandRequest(request);
+  return status;
+}
+
 EmberStatus emberSetMacParams(int8_t ccaThreshold,
                               uint8_t maxCcaAttempts,
                               uint8_t minBackoffExp,
@@ -409,474 +497,558 @@ EmberStatus emberSetMacParams(int8_t ccaThreshold,
                               uint32_t csmaTimeout,
                               uint16_t ackTimeout)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_SET_MAC_PARAMS_IPC_COMMAND_ID,
-                                          "suuuvvuwv",
-                                          ccaThreshold,
-                                          maxCcaAttempts,
-                                          minBackoffExp,
-                                          maxBackoffExp,
-                                          ccaBackoff,
-                                          ccaDuration,
-                                          maxRetries,
-                                          csmaTimeout,
-                                          ackTimeout);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
-  return status;
+  return emberSetMacParamsResult(emberSetMacParamsAsync(ccaThreshold,
+                                                        maxCcaAttempts,
+                                                        minBackoffExp,
+                                                        maxBackoffExp,
+                                                        ccaBackoff,
+                                                        ccaDuration,
+                                                        maxRetries,
+                                                        csmaTimeout,
+                                                        ackTimeout));
 }
 
 // currentStackTasks
-uint16_t emberCurrentStackTasks(void)
+sl_connect_ncp_request_t *emberCurrentStackTasksAsync(void)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_CURRENT_STACK_TASKS_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
-  uint16_t currentTasks;
-  fetchApiParams(apiCommandData,
-                 "v",
-                 &currentTasks);
-  releaseCommandMutex();
+  return submitCommand(startCommand(EMBER_CURRENT_STACK_TASKS_IPC_COMMAND_ID));
+}
+
+uint16_t emberCurrentStackTasksResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  uint16_t currentTasks = cspDecodeUint16(&finger);
+  releaseCommandRequest(request);
   return currentTasks;
 }
 
+uint16_t emberCurrentStackTasks(void)
+{
+  return emberCurrentStackTasksResult(emberCurrentStackTasksAsync());
+}
+
 // okToNap
-bool emberOkToNap(void)
+sl_connect_ncp_request_t *emberOkToNapAsync(void)
+{
+  return submitCommand(startCommand(EMBER_OK_TO_NAP_IPC_COMMAND_ID));
+}
+
+bool emberOkToNapResult(sl_connect_ncp_request_t *request)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_OK_TO_NAP_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
-  bool isOkToNap;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &isOkToNap);
-  releaseCommandMutex();
+  uint8_t *finger = waitForCommandResponse(request);
+  bool isOkToNap = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return isOkToNap;
 }
 
+bool emberOkToNap(void)
+{
+  return emberOkToNapResult(emberOkToNapAsync());
+}
+
 // okToHibernate
-bool emberOkToHibernate(void)
+sl_connect_ncp_request_t *emberOkToHibernateAsync(void)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_OK_TO_HIBERNATE_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
-  bool isOkToHibernate;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &isOkToHibernate);
-  releaseCommandMutex();
+  return submitCommand(startCommand(EMBER_OK_TO_HIBERNATE_IPC_COMMAND_ID));
+}
+
+bool emberOkToHibernateResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  bool isOkToHibernate = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return isOkToHibernate;
 }
 
+bool emberOkToHibernate(void)
+{
+  return emberOkToHibernateResult(emberOkToHibernateAsync());
+}
+
 // getEui64
+// The EUI64 is returned in a buffer of the calling thread for the current
+// instance, so concurrent callers don't overwrite each other's result
+static __thread uint8_t eui64Buffers[SL_CONNECT_NCP_MAX_INSTANCES][EUI64_SIZE];
+
+sl_connect_ncp_request_t *emberGetEui64Async(void)
+{
+  return submitCommand(startCommand(EMBER_GET_EUI64_IPC_COMMAND_ID));
+}
+
+uint8_t* emberGetEui64Result(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  uint8_t *eui64 = eui64Buffers[sli_connect_ncp_current_instance()];
+  cspDecodeBuffer(&finger, commandResponseEnd(request), eui64, EUI64_SIZE);
+  releaseCommandRequest(request);
+  return eui64;
+}
+
 uint8_t* emberGetEui64(void)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_GET_EUI64_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
-  static uint8_t eui64[EUI64_SIZE];
-  uint8_t eui64Size = EUI64_SIZE;
-  fetchApiParams(apiCommandData,
-                 "b",
-                 eui64,
-                 true,
-                 &eui64Size,
-                 EUI64_SIZE);
-  releaseCommandMutex();
+  uint8_t *eui64 = eui64Buffers[sli_connect_ncp_current_instance()];
+  uint32_t generation;
+
+  if (sli_connect_ncp_cache_read(SLI_CONNECT_NCP_CACHE_EUI64, eui64, EUI64_SIZE, &generation)) {
+    return eui64;
+  }
+  emberGetEui64Result(emberGetEui64Async());
+  sli_connect_ncp_cache_write(SLI_CONNECT_NCP_CACHE_EUI64, eui64, EUI64_SIZE, generation);
   return eui64;
 }
 
 // macGetParentAddress
-EmberStatus emberMacGetParentAddress(EmberMacAddress *parentAddress)
+sl_connect_ncp_request_t *emberMacGetParentAddressAsync(EmberMacAddress *parentAddress)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_MAC_GET_PARENT_ADDRESS_IPC_COMMAND_ID,
-                                          "vbu",
-                                          parentAddress->addr.shortAddress,
-                                          parentAddress->addr.longAddress,
-                                          EUI64_SIZE,
-                                          parentAddress->mode);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
-  EmberStatus status;
+  uint8_t *finger = startCommand(EMBER_MAC_GET_PARENT_ADDRESS_IPC_COMMAND_ID);
+  cspEncodeUint16(&finger, parentAddress->addr.shortAddress);
+  cspEncodeBuffer(&finger, parentAddress->addr.longAddress, EUI64_SIZE);
+  cspEncodeUint8(&finger, parentAddress->mode);
+  return submitCommand(finger);
+}
 
-  uint8_t longAddressSize = EUI64_SIZE;
-  fetchApiParams(apiCommandData,
-                 "uvbu",
-                 &status,
-                 &parentAddress->addr.shortAddress,
-                 parentAddress->addr.longAddress,
-                 true,
-                 &longAddressSize,
-                 EUI64_SIZE,
-                 &parentAddress->mode);
-  releaseCommandMutex();
+EmberStatus emberMacGetParentAddressResult(sl_connect_ncp_request_t *request,
+                                           EmberMacAddress *parentAddress)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  parentAddress->addr.shortAddress = cspDecodeUint16(&finger);
+  cspDecodeBuffer(&finger, commandResponseEnd(request), parentAddress->addr.longAddress, EUI64_SIZE);
+  parentAddress->mode = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
+EmberStatus emberMacGetParentAddress(EmberMacAddress *parentAddress)
+{
+  return emberMacGetParentAddressResult(emberMacGetParentAddressAsync(parentAddress),
+                                        parentAddress);
+}
+
 // isLocalEui64
-bool emberIsLocalEui64(EmberEUI64 eui64)
+sl_connect_ncp_request_t *emberIsLocalEui64Async(EmberEUI64 eui64)
+{
+  uint8_t *finger = startCommand(EMBER_IS_LOCAL_EUI64_IPC_COMMAND_ID);
+  cspEncodeBuffer(&finger, eui64, EUI64_SIZE);
+  return submitCommand(finger);
+}
+
+bool emberIsLocalEui64Result(sl_connect_ncp_request_t *request)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_IS_LOCAL_EUI64_IPC_COMMAND_ID,
-                                          "b",
-                                          eui64, EUI64_SIZE);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
-  bool localEui64;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &localEui64);
-  releaseCommandMutex();
+  uint8_t *finger = waitForCommandResponse(request);
+  bool localEui64 = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return localEui64;
 }
 
+bool emberIsLocalEui64(EmberEUI64 eui64)
+{
+  return emberIsLocalEui64Result(emberIsLocalEui64Async(eui64));
+}
+
 // getNodeId
-EmberNodeId emberGetNodeId(void)
+sl_connect_ncp_request_t *emberGetNodeIdAsync(void)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_GET_NODE_ID_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return submitCommand(startCommand(EMBER_GET_NODE_ID_IPC_COMMAND_ID));
+}
+
+EmberNodeId emberGetNodeIdResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberNodeId nodeId = cspDecodeUint16(&finger);
+  releaseCommandRequest(request);
+  return nodeId;
+}
 
+EmberNodeId emberGetNodeId(void)
+{
   EmberNodeId nodeId;
-  fetchApiParams(apiCommandData,
-                 "v",
-                 &nodeId);
-  releaseCommandMutex();
+  uint32_t generation;
+
+  if (sli_connect_ncp_cache_read(SLI_CONNECT_NCP_CACHE_NODE_ID, &nodeId, sizeof(nodeId), &generation)) {
+    return nodeId;
+  }
+  nodeId = emberGetNodeIdResult(emberGetNodeIdAsync());
+  sli_connect_ncp_cache_write(SLI_CONNECT_NCP_CACHE_NODE_ID, &nodeId, sizeof(nodeId), generation);
   return nodeId;
 }
 
 // getPanId
-EmberPanId emberGetPanId(void)
+sl_connect_ncp_request_t *emberGetPanIdAsync(void)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_GET_PAN_ID_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return submitCommand(startCommand(EMBER_GET_PAN_ID_IPC_COMMAND_ID));
+}
 
+EmberPanId emberGetPanIdResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberPanId panId = cspDecodeUint16(&finger);
+  releaseCommandRequest(request);
+  return panId;
+}
+
+EmberPanId emberGetPanId(void)
+{
   EmberPanId panId;
-  fetchApiParams(apiCommandData,
-                 "v",
-                 &panId);
-  releaseCommandMutex();
+  uint32_t generation;
+
+  if (sli_connect_ncp_cache_read(SLI_CONNECT_NCP_CACHE_PAN_ID, &panId, sizeof(panId), &generation)) {
+    return panId;
+  }
+  panId = emberGetPanIdResult(emberGetPanIdAsync());
+  sli_connect_ncp_cache_write(SLI_CONNECT_NCP_CACHE_PAN_ID, &panId, sizeof(panId), generation);
   return panId;
 }
 
 // getParentId
-EmberNodeId emberGetParentId(void)
+sl_connect_ncp_request_t *emberGetParentIdAsync(void)
+{
+  return submitCommand(startCommand(EMBER_GET_PARENT_ID_IPC_COMMAND_ID));
+}
+
+EmberNodeId emberGetParentIdResult(sl_connect_ncp_request_t *request)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_GET_PARENT_ID_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
-  EmberNodeId parentNodeId;
-  fetchApiParams(apiCommandData,
-                 "v",
-                 &parentNodeId);
-  releaseCommandMutex();
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberNodeId parentNodeId = cspDecodeUint16(&finger);
+  releaseCommandRequest(request);
   return parentNodeId;
 }
 
+EmberNodeId emberGetParentId(void)
+{
+  return emberGetParentIdResult(emberGetParentIdAsync());
+}
+
 // getNodeType
-EmberNodeType emberGetNodeType(void)
+sl_connect_ncp_request_t *emberGetNodeTypeAsync(void)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_GET_NODE_TYPE_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return submitCommand(startCommand(EMBER_GET_NODE_TYPE_IPC_COMMAND_ID));
+}
 
+EmberNodeType emberGetNodeTypeResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberNodeType nodeType = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
+  return nodeType;
+}
+
+EmberNodeType emberGetNodeType(void)
+{
   EmberNodeType nodeType;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &nodeType);
-  releaseCommandMutex();
+  uint32_t generation;
+
+  if (sli_connect_ncp_cache_read(SLI_CONNECT_NCP_CACHE_NODE_TYPE, &nodeType, sizeof(nodeType), &generation)) {
+    return nodeType;
+  }
+  nodeType = emberGetNodeTypeResult(emberGetNodeTypeAsync());
+  sli_connect_ncp_cache_write(SLI_CONNECT_NCP_CACHE_NODE_TYPE, &nodeType, sizeof(nodeType), generation);
   return nodeType;
 }
 
 // calibrateCurrentChannelExtended
+sl_connect_ncp_request_t *emberCalibrateCurrentChannelExtendedAsync(uint32_t calValueIn)
+{
+  uint8_t *finger = startCommand(EMBER_CALIBRATE_CURRENT_CHANNEL_EXTENDED_IPC_COMMAND_ID);
+  cspEncodeUint32(&finger, calValueIn);
+  return submitCommand(finger);
+}
+
+EmberStatus emberCalibrateCurrentChannelExtendedResult(sl_connect_ncp_request_t *request,
+                                                       uint32_t* calValueOut)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  *calValueOut = cspDecodeUint32(&finger);
+  releaseCommandRequest(request);
+  return status;
+}
+
 EmberStatus emberCalibrateCurrentChannelExtended(uint32_t calValueIn,
                                                  uint32_t* calValueOut)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_CALIBRATE_CURRENT_CHANNEL_EXTENDED_IPC_COMMAND_ID,
-                                          "w",
-                                          calValueIn);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberCalibrateCurrentChannelExtendedResult(emberCalibrateCurrentChannelExtendedAsync(calValueIn),
+                                                    calValueOut);
+}
 
-  EmberStatus status;
+// applyIrCalibration
+sl_connect_ncp_request_t *emberApplyIrCalibrationAsync(uint32_t calValue)
+{
+  uint8_t *finger = startCommand(EMBER_APPLY_IR_CALIBRATION_IPC_COMMAND_ID);
+  cspEncodeUint32(&finger, calValue);
+  return submitCommand(finger);
+}
 
-  fetchApiParams(apiCommandData,
-                 "uw",
-                 &status,
-                 calValueOut);
-  releaseCommandMutex();
+EmberStatus emberApplyIrCalibrationResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// applyIrCalibration
 EmberStatus emberApplyIrCalibration(uint32_t calValue)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_APPLY_IR_CALIBRATION_IPC_COMMAND_ID,
-                                          "w",
-                                          calValue);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
-  return status;
+  return emberApplyIrCalibrationResult(emberApplyIrCalibrationAsync(calValue));
 }
 
 // tempCalibration
-EmberStatus emberTempCalibration(void)
+sl_connect_ncp_request_t *emberTempCalibrationAsync(void)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_TEMP_CALIBRATION_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return submitCommand(startCommand(EMBER_TEMP_CALIBRATION_IPC_COMMAND_ID));
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberTempCalibrationResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
+EmberStatus emberTempCalibration(void)
+{
+  return emberTempCalibrationResult(emberTempCalibrationAsync());
+}
+
 // getCalType
-EmberCalType emberGetCalType(void)
+sl_connect_ncp_request_t *emberGetCalTypeAsync(void)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_GET_CAL_TYPE_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
-  EmberCalType calType;
-  fetchApiParams(apiCommandData,
-                 "w",
-                 &calType);
-  releaseCommandMutex();
+  return submitCommand(startCommand(EMBER_GET_CAL_TYPE_IPC_COMMAND_ID));
+}
+
+EmberCalType emberGetCalTypeResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberCalType calType = cspDecodeUint32(&finger);
+  releaseCommandRequest(request);
   return calType;
 }
 
+EmberCalType emberGetCalType(void)
+{
+  return emberGetCalTypeResult(emberGetCalTypeAsync());
+}
+
 // getMaximumPayloadLength
+sl_connect_ncp_request_t *emberGetMaximumPayloadLengthAsync(EmberMacAddressMode srcAddressMode,
+                                                            EmberMacAddressMode dstAddressMode,
+                                                            bool interpan,
+                                                            bool secured)
+{
+  uint8_t *finger = startCommand(EMBER_GET_MAXIMUM_PAYLOAD_LENGTH_IPC_COMMAND_ID);
+  cspEncodeUint8(&finger, srcAddressMode);
+  cspEncodeUint8(&finger, dstAddressMode);
+  cspEncodeUint8(&finger, interpan);
+  cspEncodeUint8(&finger, secured);
+  return submitCommand(finger);
+}
+
+uint16_t emberGetMaximumPayloadLengthResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  uint16_t payloadLength = cspDecodeUint16(&finger);
+  releaseCommandRequest(request);
+  return payloadLength;
+}
+
 uint16_t emberGetMaximumPayloadLength(EmberMacAddressMode srcAddressMode,
                                       EmberMacAddressMode dstAddressMode,
                                       bool interpan,
                                       bool secured)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_GET_MAXIMUM_PAYLOAD_LENGTH_IPC_COMMAND_ID,
-                                          "uuuu",
-                                          srcAddressMode,
-                                          dstAddressMode,
-                                          interpan,
-                                          secured);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
+  sli_connect_ncp_cache_entry_t entry = sli_connect_ncp_cache_payload_length_entry(srcAddressMode,
+                                                                                  dstAddressMode,
+                                                                                  interpan,
+                                                                                  secured);
   uint16_t payloadLength;
-  fetchApiParams(apiCommandData,
-                 "v",
-                 &payloadLength);
-  releaseCommandMutex();
+  uint32_t generation;
+
+  if (sli_connect_ncp_cache_read(entry, &payloadLength, sizeof(payloadLength), &generation)) {
+    return payloadLength;
+  }
+  payloadLength = emberGetMaximumPayloadLengthResult(emberGetMaximumPayloadLengthAsync(srcAddressMode,
+                                                                                       dstAddressMode,
+                                                                                       interpan,
+                                                                                       secured));
+  sli_connect_ncp_cache_write(entry, &payloadLength, sizeof(payloadLength), generation);
   return payloadLength;
 }
 
 // setIndirectQueueTimeout
-EmberStatus emberSetIndirectQueueTimeout(uint32_t timeoutMs)
+sl_connect_ncp_request_t *emberSetIndirectQueueTimeoutAsync(uint32_t timeoutMs)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_SET_INDIRECT_QUEUE_TIMEOUT_IPC_COMMAND_ID,
-                                          "w",
-                                          timeoutMs);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  uint8_t *finger = startCommand(EMBER_SET_INDIRECT_QUEUE_TIMEOUT_IPC_COMMAND_ID);
+  cspEncodeUint32(&finger, timeoutMs);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberSetIndirectQueueTimeoutResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
+EmberStatus emberSetIndirectQueueTimeout(uint32_t timeoutMs)
+{
+  return emberSetIndirectQueueTimeoutResult(emberSetIndirectQueueTimeoutAsync(timeoutMs));
+}
+
 // getVersionInfo
+sl_connect_ncp_request_t *emberGetVersionInfoAsync(void)
+{
+  return submitCommand(startCommand(EMBER_GET_VERSION_INFO_IPC_COMMAND_ID));
+}
+
+EmberStatus emberGetVersionInfoResult(sl_connect_ncp_request_t *request,
+                                      uint16_t* gsdkVersion,
+                                      uint16_t* connectStackVersion,
+                                      uint32_t* bootloaderVersion)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  *gsdkVersion = cspDecodeUint16(&finger);
+  *connectStackVersion = cspDecodeUint16(&finger);
+  *bootloaderVersion = cspDecodeUint32(&finger);
+  releaseCommandRequest(request);
+  return status;
+}
+
 EmberStatus emberGetVersionInfo(uint16_t* gsdkVersion,
                                 uint16_t* connectStackVersion,
                                 uint32_t* bootloaderVersion)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_GET_VERSION_INFO_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
+  uint8_t versions[SLI_CONNECT_NCP_CACHE_VALUE_SIZE];
+  uint32_t generation;
   EmberStatus status;
 
-  fetchApiParams(apiCommandData,
-                 "uvvw",
-                 &status,
-                 gsdkVersion,
-                 connectStackVersion,
-                 bootloaderVersion);
-  releaseCommandMutex();
+  if (sli_connect_ncp_cache_read(SLI_CONNECT_NCP_CACHE_VERSION_INFO, versions, sizeof(versions), &generation)) {
+    memcpy(gsdkVersion, &versions[0], sizeof(*gsdkVersion));
+    memcpy(connectStackVersion, &versions[2], sizeof(*connectStackVersion));
+    memcpy(bootloaderVersion, &versions[4], sizeof(*bootloaderVersion));
+    return EMBER_SUCCESS;
+  }
+  status = emberGetVersionInfoResult(emberGetVersionInfoAsync(),
+                                     gsdkVersion,
+                                     connectStackVersion,
+                                     bootloaderVersion);
+  if (status == EMBER_SUCCESS) {
+    memcpy(&versions[0], gsdkVersion, sizeof(*gsdkVersion));
+    memcpy(&versions[2], connectStackVersion, sizeof(*connectStackVersion));
+    memcpy(&versions[4], bootloaderVersion, sizeof(*bootloaderVersion));
+    sli_connect_ncp_cache_write(SLI_CONNECT_NCP_CACHE_VERSION_INFO, versions, sizeof(versions), generation);
+  }
   return status;
 }
 
 // ofdmSetMcs
-EmberStatus emberOfdmSetMcs(uint8_t mcs)
+sl_connect_ncp_request_t *emberOfdmSetMcsAsync(uint8_t mcs)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_OFDM_SET_MCS_IPC_COMMAND_ID,
-                                          "u",
-                                          mcs);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  uint8_t *finger = startCommand(EMBER_OFDM_SET_MCS_IPC_COMMAND_ID);
+  invalidateCacheOnSubmit();
+  cspEncodeUint8(&finger, mcs);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberOfdmSetMcsResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// ofdmGetMcs
-EmberStatus emberOfdmGetMcs(uint8_t* mcs)
+EmberStatus emberOfdmSetMcs(uint8_t mcs)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_OFDM_GET_MCS_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberOfdmSetMcsResult(emberOfdmSetMcsAsync(mcs));
+}
 
-  EmberStatus status;
+// ofdmGetMcs
+sl_connect_ncp_request_t *emberOfdmGetMcsAsync(void)
+{
+  return submitCommand(startCommand(EMBER_OFDM_GET_MCS_IPC_COMMAND_ID));
+}
 
-  fetchApiParams(apiCommandData,
-                 "uu",
-                 &status,
-                 mcs);
-  releaseCommandMutex();
+EmberStatus emberOfdmGetMcsResult(sl_connect_ncp_request_t *request,
+                                  uint8_t* mcs)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  *mcs = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
+EmberStatus emberOfdmGetMcs(uint8_t* mcs)
+{
+  return emberOfdmGetMcsResult(emberOfdmGetMcsAsync(),
+                               mcs);
+}
+
 // ncpSetLongMessagesUse
 EmberStatus emberNcpSetLongMessagesUse(bool useLongMessages)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_NCP_SET_LONG_MESSAGES_USE_IPC_COMMAND_ID,
-                                          "u",
-                                          useLongMessages);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
+  uint8_t *finger = startCommand(EMBER_NCP_SET_LONG_MESSAGES_USE_IPC_COMMAND_ID);
+  invalidateCacheOnSubmit();
+  cspEncodeUint8(&finger, useLongMessages);
+  sl_connect_ncp_request_t *request = submitCommand(finger);
+  finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
   if (status == EMBER_SUCCESS) {
     set_csp_format_long_message_use(useLongMessages);
+    sli_connect_ncp_restore_long_messages(useLongMessages);
   }
-  releaseCommandMutex();
+  releaseCommandRequest(request);
   return status;
 }
 
 // usingLongMessages
-bool emberUsingLongMessages(void)
+sl_connect_ncp_request_t *emberUsingLongMessagesAsync(void)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_USING_LONG_MESSAGES_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
-  bool usingLongMessages;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &usingLongMessages);
-  releaseCommandMutex();
+  return submitCommand(startCommand(EMBER_USING_LONG_MESSAGES_IPC_COMMAND_ID));
+}
+
+bool emberUsingLongMessagesResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  bool usingLongMessages = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return usingLongMessages;
 }
 
+bool emberUsingLongMessages(void)
+{
+  return emberUsingLongMessagesResult(emberUsingLongMessagesAsync());
+}
+
 // messageSend
+sl_connect_ncp_request_t *emberMessageSendAsync(EmberNodeId destination,
+                                                uint8_t endpoint,
+                                                uint8_t messageTag,
+                                                EmberMessageLength messageLength,
+                                                uint8_t *message,
+                                                EmberMessageOptions options)
+{
+  uint8_t *finger = startCommand(EMBER_MESSAGE_SEND_IPC_COMMAND_ID);
+  cspEncodeUint16(&finger, destination);
+  cspEncodeUint8(&finger, endpoint);
+  cspEncodeUint8(&finger, messageTag);
+  cspEncodeLength(&finger, messageLength);
+  cspEncodeBuffer(&finger, message, messageLength);
+  cspEncodeUint8(&finger, options);
+  return submitCommand(finger);
+}
+
+EmberStatus emberMessageSendResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
+  return status;
+}
+
 EmberStatus emberMessageSend(EmberNodeId destination,
                              uint8_t endpoint,
                              uint8_t messageTag,
@@ -884,790 +1056,844 @@ EmberStatus emberMessageSend(EmberNodeId destination,
                              uint8_t *message,
                              EmberMessageOptions options)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_MESSAGE_SEND_IPC_COMMAND_ID,
-                                          "vuulbu",
-                                          destination,
-                                          endpoint,
-                                          messageTag,
-                                          messageLength,
-                                          message,
-                                          messageLength,
-                                          options);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberMessageSendResult(emberMessageSendAsync(destination,
+                                                      endpoint,
+                                                      messageTag,
+                                                      messageLength,
+                                                      message,
+                                                      options));
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+// pollForData
+sl_connect_ncp_request_t *emberPollForDataAsync(void)
+{
+  return submitCommand(startCommand(EMBER_POLL_FOR_DATA_IPC_COMMAND_ID));
+}
+
+EmberStatus emberPollForDataResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// pollForData
 EmberStatus emberPollForData(void)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_POLL_FOR_DATA_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberPollForDataResult(emberPollForDataAsync());
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+// macMessageSend
+sl_connect_ncp_request_t *emberMacMessageSendAsync(EmberMacFrame *macFrame,
+                                                   uint8_t messageTag,
+                                                   EmberMessageLength messageLength,
+                                                   uint8_t *message,
+                                                   EmberMessageOptions options)
+{
+  uint8_t *finger = startCommand(EMBER_MAC_MESSAGE_SEND_IPC_COMMAND_ID);
+  cspEncodeUint16(&finger, macFrame->srcAddress.addr.shortAddress);
+  cspEncodeBuffer(&finger, macFrame->srcAddress.addr.longAddress, EUI64_SIZE);
+  cspEncodeUint8(&finger, macFrame->srcAddress.mode);
+  cspEncodeUint16(&finger, macFrame->dstAddress.addr.shortAddress);
+  cspEncodeBuffer(&finger, macFrame->dstAddress.addr.longAddress, EUI64_SIZE);
+  cspEncodeUint8(&finger, macFrame->dstAddress.mode);
+  cspEncodeUint16(&finger, macFrame->srcPanId);
+  cspEncodeUint16(&finger, macFrame->dstPanId);
+  cspEncodeUint8(&finger, macFrame->srcPanIdSpecified);
+  cspEncodeUint8(&finger, macFrame->dstPanIdSpecified);
+  cspEncodeUint8(&finger, messageTag);
+  cspEncodeLength(&finger, messageLength);
+  cspEncodeBuffer(&finger, message, messageLength);
+  cspEncodeUint8(&finger, options);
+  return submitCommand(finger);
+}
+
+EmberStatus emberMacMessageSendResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// macMessageSend
 EmberStatus emberMacMessageSend(EmberMacFrame *macFrame,
                                 uint8_t messageTag,
                                 EmberMessageLength messageLength,
                                 uint8_t *message,
                                 EmberMessageOptions options)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_MAC_MESSAGE_SEND_IPC_COMMAND_ID,
-                                          "vbuvbuvvuuulbu",
-                                          macFrame->srcAddress.addr.shortAddress,
-                                          macFrame->srcAddress.addr.longAddress,
-                                          EUI64_SIZE,
-                                          macFrame->srcAddress.mode,
-                                          macFrame->dstAddress.addr.shortAddress,
-                                          macFrame->dstAddress.addr.longAddress,
-                                          EUI64_SIZE,
-                                          macFrame->dstAddress.mode,
-                                          macFrame->srcPanId,
-                                          macFrame->dstPanId,
-                                          macFrame->srcPanIdSpecified,
-                                          macFrame->dstPanIdSpecified,
-                                          messageTag,
-                                          messageLength,
-                                          message,
-                                          messageLength,
-                                          options);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberMacMessageSendResult(emberMacMessageSendAsync(macFrame,
+                                                            messageTag,
+                                                            messageLength,
+                                                            message,
+                                                            options));
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+// macSetPanCoordinator
+sl_connect_ncp_request_t *emberMacSetPanCoordinatorAsync(bool isCoordinator)
+{
+  uint8_t *finger = startCommand(EMBER_MAC_SET_PAN_COORDINATOR_IPC_COMMAND_ID);
+  cspEncodeUint8(&finger, isCoordinator);
+  return submitCommand(finger);
+}
+
+EmberStatus emberMacSetPanCoordinatorResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// macSetPanCoordinator
 EmberStatus emberMacSetPanCoordinator(bool isCoordinator)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_MAC_SET_PAN_COORDINATOR_IPC_COMMAND_ID,
-                                          "u",
-                                          isCoordinator);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberMacSetPanCoordinatorResult(emberMacSetPanCoordinatorAsync(isCoordinator));
+}
+
+// setPollDestinationAddress
+sl_connect_ncp_request_t *emberSetPollDestinationAddressAsync(EmberMacAddress *destination)
+{
+  uint8_t *finger = startCommand(EMBER_SET_POLL_DESTINATION_ADDRESS_IPC_COMMAND_ID);
+  cspEncodeUint16(&finger, destination->addr.shortAddress);
+  cspEncodeBuffer(&finger, destination->addr.longAddress, EUI64_SIZE);
+  cspEncodeUint8(&finger, destination->mode);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberSetPollDestinationAddressResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// setPollDestinationAddress
 EmberStatus emberSetPollDestinationAddress(EmberMacAddress *destination)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_SET_POLL_DESTINATION_ADDRESS_IPC_COMMAND_ID,
-                                          "vbu",
-                                          destination->addr.shortAddress,
-                                          destination->addr.longAddress,
-                                          EUI64_SIZE,
-                                          destination->mode);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberSetPollDestinationAddressResult(emberSetPollDestinationAddressAsync(destination));
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+// removeChild
+sl_connect_ncp_request_t *emberRemoveChildAsync(EmberMacAddress *address)
+{
+  uint8_t *finger = startCommand(EMBER_REMOVE_CHILD_IPC_COMMAND_ID);
+  cspEncodeUint16(&finger, address->addr.shortAddress);
+  cspEncodeBuffer(&finger, address->addr.longAddress, EUI64_SIZE);
+  cspEncodeUint8(&finger, address->mode);
+  return submitCommand(finger);
+}
+
+EmberStatus emberRemoveChildResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// removeChild
 EmberStatus emberRemoveChild(EmberMacAddress *address)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_REMOVE_CHILD_IPC_COMMAND_ID,
-                                          "vbu",
-                                          address->addr.shortAddress,
-                                          address->addr.longAddress,
-                                          EUI64_SIZE,
-                                          address->mode);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberRemoveChildResult(emberRemoveChildAsync(address));
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+// getChildFlags
+sl_connect_ncp_request_t *emberGetChildFlagsAsync(EmberMacAddress *address)
+{
+  uint8_t *finger = startCommand(EMBER_GET_CHILD_FLAGS_IPC_COMMAND_ID);
+  cspEncodeUint16(&finger, address->addr.shortAddress);
+  cspEncodeBuffer(&finger, address->addr.longAddress, EUI64_SIZE);
+  cspEncodeUint8(&finger, address->mode);
+  return submitCommand(finger);
+}
+
+EmberStatus emberGetChildFlagsResult(sl_connect_ncp_request_t *request,
+                                     EmberChildFlags* flags)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  *flags = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// getChildFlags
 EmberStatus emberGetChildFlags(EmberMacAddress *address,
                                EmberChildFlags* flags)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_GET_CHILD_FLAGS_IPC_COMMAND_ID,
-                                          "vbu",
-                                          address->addr.shortAddress,
-                                          address->addr.longAddress,
-                                          EUI64_SIZE,
-                                          address->mode);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
-  EmberStatus status;
+  return emberGetChildFlagsResult(emberGetChildFlagsAsync(address),
+                                  flags);
+}
 
-  fetchApiParams(apiCommandData,
-                 "uu",
-                 &status,
-                 flags);
-  releaseCommandMutex();
+// getChildInfo
+sl_connect_ncp_request_t *emberGetChildInfoAsync(EmberMacAddress *address)
+{
+  uint8_t *finger = startCommand(EMBER_GET_CHILD_INFO_IPC_COMMAND_ID);
+  cspEncodeUint16(&finger, address->addr.shortAddress);
+  cspEncodeBuffer(&finger, address->addr.longAddress, EUI64_SIZE);
+  cspEncodeUint8(&finger, address->mode);
+  return submitCommand(finger);
+}
+
+EmberStatus emberGetChildInfoResult(sl_connect_ncp_request_t *request,
+                                    EmberMacAddress *addressResp,
+                                    EmberChildFlags* flags)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  addressResp->addr.shortAddress = cspDecodeUint16(&finger);
+  cspDecodeBuffer(&finger, commandResponseEnd(request), addressResp->addr.longAddress, EUI64_SIZE);
+  addressResp->mode = cspDecodeUint8(&finger);
+  *flags = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// getChildInfo
 EmberStatus emberGetChildInfo(EmberMacAddress *address,
                               EmberMacAddress *addressResp,
                               EmberChildFlags* flags)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_GET_CHILD_INFO_IPC_COMMAND_ID,
-                                          "vbu",
-                                          address->addr.shortAddress,
-                                          address->addr.longAddress,
-                                          EUI64_SIZE,
-                                          address->mode);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberGetChildInfoResult(emberGetChildInfoAsync(address),
+                                 addressResp,
+                                 flags);
+}
 
-  EmberStatus status;
+// purgeIndirectMessages
+sl_connect_ncp_request_t *emberPurgeIndirectMessagesAsync(void)
+{
+  return submitCommand(startCommand(EMBER_PURGE_INDIRECT_MESSAGES_IPC_COMMAND_ID));
+}
 
-  uint8_t longAddressSize = EUI64_SIZE;
-
-  fetchApiParams(apiCommandData,
-                 "uvbuu",
-                 &status,
-                 &addressResp->addr.shortAddress,
-                 addressResp->addr.longAddress,
-                 true,
-                 &longAddressSize,
-                 EUI64_SIZE,
-                 &addressResp->mode,
-                 flags);
-  releaseCommandMutex();
+EmberStatus emberPurgeIndirectMessagesResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// purgeIndirectMessages
 EmberStatus emberPurgeIndirectMessages(void)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_PURGE_INDIRECT_MESSAGES_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberPurgeIndirectMessagesResult(emberPurgeIndirectMessagesAsync());
+}
+
+// macAddShortToLongAddressMapping
+sl_connect_ncp_request_t *emberMacAddShortToLongAddressMappingAsync(EmberNodeId shortId,
+                                                                    EmberEUI64 longId)
+{
+  uint8_t *finger = startCommand(EMBER_MAC_ADD_SHORT_TO_LONG_ADDRESS_MAPPING_IPC_COMMAND_ID);
+  cspEncodeUint16(&finger, shortId);
+  cspEncodeBuffer(&finger, longId, EUI64_SIZE);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberMacAddShortToLongAddressMappingResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// macAddShortToLongAddressMapping
 EmberStatus emberMacAddShortToLongAddressMapping(EmberNodeId shortId,
                                                  EmberEUI64 longId)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_MAC_ADD_SHORT_TO_LONG_ADDRESS_MAPPING_IPC_COMMAND_ID,
-                                          "vb",
-                                          shortId,
-                                          longId, EUI64_SIZE);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberMacAddShortToLongAddressMappingResult(emberMacAddShortToLongAddressMappingAsync(shortId,
+                                                                                              longId));
+}
+
+// macClearShortToLongAddressMappings
+sl_connect_ncp_request_t *emberMacClearShortToLongAddressMappingsAsync(void)
+{
+  return submitCommand(startCommand(EMBER_MAC_CLEAR_SHORT_TO_LONG_ADDRESS_MAPPINGS_IPC_COMMAND_ID));
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberMacClearShortToLongAddressMappingsResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// macClearShortToLongAddressMappings
 EmberStatus emberMacClearShortToLongAddressMappings(void)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_MAC_CLEAR_SHORT_TO_LONG_ADDRESS_MAPPINGS_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberMacClearShortToLongAddressMappingsResult(emberMacClearShortToLongAddressMappingsAsync());
+}
+
+// networkLeave
+sl_connect_ncp_request_t *emberNetworkLeaveAsync(void)
+{
+  uint8_t *finger = startCommand(EMBER_NETWORK_LEAVE_IPC_COMMAND_ID);
+  invalidateCacheOnSubmit();
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberNetworkLeaveResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// networkLeave
 EmberStatus emberNetworkLeave(void)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_NETWORK_LEAVE_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberNetworkLeaveResult(emberNetworkLeaveAsync());
+}
+
+// networkInit
+sl_connect_ncp_request_t *emberNetworkInitAsync(void)
+{
+  uint8_t *finger = startCommand(EMBER_NETWORK_INIT_IPC_COMMAND_ID);
+  invalidateCacheOnSubmit();
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberNetworkInitResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// networkInit
 EmberStatus emberNetworkInit(void)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_NETWORK_INIT_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberNetworkInitResult(emberNetworkInitAsync());
+}
+
+// startActiveScan
+sl_connect_ncp_request_t *emberStartActiveScanAsync(uint16_t channel)
+{
+  uint8_t *finger = startCommand(EMBER_START_ACTIVE_SCAN_IPC_COMMAND_ID);
+  cspEncodeUint16(&finger, channel);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberStartActiveScanResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// startActiveScan
 EmberStatus emberStartActiveScan(uint16_t channel)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_START_ACTIVE_SCAN_IPC_COMMAND_ID,
-                                          "v",
-                                          channel);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberStartActiveScanResult(emberStartActiveScanAsync(channel));
+}
+
+// startEnergyScan
+sl_connect_ncp_request_t *emberStartEnergyScanAsync(uint16_t channel,
+                                                    uint8_t samples)
+{
+  uint8_t *finger = startCommand(EMBER_START_ENERGY_SCAN_IPC_COMMAND_ID);
+  cspEncodeUint16(&finger, channel);
+  cspEncodeUint8(&finger, samples);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberStartEnergyScanResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// startEnergyScan
 EmberStatus emberStartEnergyScan(uint16_t channel,
                                  uint8_t samples)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_START_ENERGY_SCAN_IPC_COMMAND_ID,
-                                          "vu",
-                                          channel,
-                                          samples);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberStartEnergyScanResult(emberStartEnergyScanAsync(channel,
+                                                              samples));
+}
+
+// setApplicationBeaconPayload
+sl_connect_ncp_request_t *emberSetApplicationBeaconPayloadAsync(uint8_t payloadLength,
+                                                                uint8_t *payload)
+{
+  uint8_t *finger = startCommand(EMBER_SET_APPLICATION_BEACON_PAYLOAD_IPC_COMMAND_ID);
+  cspEncodeBuffer(&finger, payload, payloadLength);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberSetApplicationBeaconPayloadResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// setApplicationBeaconPayload
 EmberStatus emberSetApplicationBeaconPayload(uint8_t payloadLength,
                                              uint8_t *payload)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_SET_APPLICATION_BEACON_PAYLOAD_IPC_COMMAND_ID,
-                                          "b",
-                                          payload,
-                                          payloadLength);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberSetApplicationBeaconPayloadResult(emberSetApplicationBeaconPayloadAsync(payloadLength,
+                                                                                      payload));
+}
+
+// setSelectiveJoinPayload
+sl_connect_ncp_request_t *emberSetSelectiveJoinPayloadAsync(uint8_t payloadLength,
+                                                            uint8_t *payload)
+{
+  uint8_t *finger = startCommand(EMBER_SET_SELECTIVE_JOIN_PAYLOAD_IPC_COMMAND_ID);
+  cspEncodeBuffer(&finger, payload, payloadLength);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberSetSelectiveJoinPayloadResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// setSelectiveJoinPayload
 EmberStatus emberSetSelectiveJoinPayload(uint8_t payloadLength,
                                          uint8_t *payload)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_SET_SELECTIVE_JOIN_PAYLOAD_IPC_COMMAND_ID,
-                                          "b",
-                                          payload,
-                                          payloadLength);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberSetSelectiveJoinPayloadResult(emberSetSelectiveJoinPayloadAsync(payloadLength,
+                                                                              payload));
+}
+
+// clearSelectiveJoinPayload
+sl_connect_ncp_request_t *emberClearSelectiveJoinPayloadAsync(void)
+{
+  return submitCommand(startCommand(EMBER_CLEAR_SELECTIVE_JOIN_PAYLOAD_IPC_COMMAND_ID));
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberClearSelectiveJoinPayloadResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// clearSelectiveJoinPayload
 EmberStatus emberClearSelectiveJoinPayload(void)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_CLEAR_SELECTIVE_JOIN_PAYLOAD_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberClearSelectiveJoinPayloadResult(emberClearSelectiveJoinPayloadAsync());
+}
+
+// formNetwork
+sl_connect_ncp_request_t *emberFormNetworkAsync(EmberNetworkParameters *parameters)
+{
+  uint8_t *finger = startCommand(EMBER_FORM_NETWORK_IPC_COMMAND_ID);
+  invalidateCacheOnSubmit();
+  cspEncodeUint16(&finger, parameters->panId);
+  cspEncodeInt16(&finger, parameters->radioTxPower);
+  cspEncodeUint16(&finger, parameters->radioChannel);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberFormNetworkResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// formNetwork
 EmberStatus emberFormNetwork(EmberNetworkParameters *parameters)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_FORM_NETWORK_IPC_COMMAND_ID,
-                                          "vvv",
-                                          parameters->panId,
-                                          parameters->radioTxPower,
-                                          parameters->radioChannel);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberFormNetworkResult(emberFormNetworkAsync(parameters));
+}
+
+// joinNetworkExtended
+sl_connect_ncp_request_t *emberJoinNetworkExtendedAsync(EmberNodeType nodeType,
+                                                        EmberNodeId nodeId,
+                                                        EmberNetworkParameters *parameters)
+{
+  uint8_t *finger = startCommand(EMBER_JOIN_NETWORK_EXTENDED_IPC_COMMAND_ID);
+  invalidateCacheOnSubmit();
+  cspEncodeUint8(&finger, nodeType);
+  cspEncodeUint16(&finger, nodeId);
+  cspEncodeUint16(&finger, parameters->panId);
+  cspEncodeInt16(&finger, parameters->radioTxPower);
+  cspEncodeUint16(&finger, parameters->radioChannel);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberJoinNetworkExtendedResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// joinNetworkExtended
 EmberStatus emberJoinNetworkExtended(EmberNodeType nodeType,
                                      EmberNodeId nodeId,
                                      EmberNetworkParameters *parameters)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_JOIN_NETWORK_EXTENDED_IPC_COMMAND_ID,
-                                          "uvvvv",
-                                          nodeType,
-                                          nodeId,
-                                          parameters->panId,
-                                          parameters->radioTxPower,
-                                          parameters->radioChannel);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberJoinNetworkExtendedResult(emberJoinNetworkExtendedAsync(nodeType,
+                                                                      nodeId,
+                                                                      parameters));
+}
+
+// joinNetwork
+sl_connect_ncp_request_t *emberJoinNetworkAsync(EmberNodeType nodeType,
+                                                EmberNetworkParameters *parameters)
+{
+  uint8_t *finger = startCommand(EMBER_JOIN_NETWORK_IPC_COMMAND_ID);
+  invalidateCacheOnSubmit();
+  cspEncodeUint8(&finger, nodeType);
+  cspEncodeUint16(&finger, parameters->panId);
+  cspEncodeInt16(&finger, parameters->radioTxPower);
+  cspEncodeUint16(&finger, parameters->radioChannel);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberJoinNetworkResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// joinNetwork
 EmberStatus emberJoinNetwork(EmberNodeType nodeType,
                              EmberNetworkParameters *parameters)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_JOIN_NETWORK_IPC_COMMAND_ID,
-                                          "uvvv",
-                                          nodeType,
-                                          parameters->panId,
-                                          parameters->radioTxPower,
-                                          parameters->radioChannel);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberJoinNetworkResult(emberJoinNetworkAsync(nodeType,
+                                                      parameters));
+}
+
+// macFormNetwork
+sl_connect_ncp_request_t *emberMacFormNetworkAsync(EmberNetworkParameters *parameters)
+{
+  uint8_t *finger = startCommand(EMBER_MAC_FORM_NETWORK_IPC_COMMAND_ID);
+  invalidateCacheOnSubmit();
+  cspEncodeUint16(&finger, parameters->panId);
+  cspEncodeInt16(&finger, parameters->radioTxPower);
+  cspEncodeUint16(&finger, parameters->radioChannel);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberMacFormNetworkResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// macFormNetwork
 EmberStatus emberMacFormNetwork(EmberNetworkParameters *parameters)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_MAC_FORM_NETWORK_IPC_COMMAND_ID,
-                                          "vvv",
-                                          parameters->panId,
-                                          parameters->radioTxPower,
-                                          parameters->radioChannel);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberMacFormNetworkResult(emberMacFormNetworkAsync(parameters));
+}
+
+// permitJoining
+sl_connect_ncp_request_t *emberPermitJoiningAsync(uint8_t duration)
+{
+  uint8_t *finger = startCommand(EMBER_PERMIT_JOINING_IPC_COMMAND_ID);
+  cspEncodeUint8(&finger, duration);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberPermitJoiningResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// permitJoining
 EmberStatus emberPermitJoining(uint8_t duration)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_PERMIT_JOINING_IPC_COMMAND_ID,
-                                          "u",
-                                          duration);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberPermitJoiningResult(emberPermitJoiningAsync(duration));
+}
+
+// joinCommissioned
+sl_connect_ncp_request_t *emberJoinCommissionedAsync(EmberNodeType nodeType,
+                                                     EmberNodeId nodeId,
+                                                     EmberNetworkParameters *parameters)
+{
+  uint8_t *finger = startCommand(EMBER_JOIN_COMMISSIONED_IPC_COMMAND_ID);
+  invalidateCacheOnSubmit();
+  cspEncodeUint8(&finger, nodeType);
+  cspEncodeUint16(&finger, nodeId);
+  cspEncodeUint16(&finger, parameters->panId);
+  cspEncodeInt16(&finger, parameters->radioTxPower);
+  cspEncodeUint16(&finger, parameters->radioChannel);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberJoinCommissionedResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// joinCommissioned
 EmberStatus emberJoinCommissioned(EmberNodeType nodeType,
                                   EmberNodeId nodeId,
                                   EmberNetworkParameters *parameters)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_JOIN_COMMISSIONED_IPC_COMMAND_ID,
-                                          "uvvvv",
-                                          nodeType,
-                                          nodeId,
-                                          parameters->panId,
-                                          parameters->radioTxPower,
-                                          parameters->radioChannel);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
-  return status;
+  return emberJoinCommissionedResult(emberJoinCommissionedAsync(nodeType,
+                                                                nodeId,
+                                                                parameters));
 }
 
 // resetNetworkState
+sl_connect_ncp_request_t *emberResetNetworkStateAsync(void)
+{
+  uint8_t *finger = startCommand(EMBER_RESET_NETWORK_STATE_IPC_COMMAND_ID);
+  invalidateCacheOnSubmit();
+  return submitCommand(finger);
+}
+
+void emberResetNetworkStateResult(sl_connect_ncp_request_t *request)
+{
+  waitForCommandResponse(request);
+  releaseCommandRequest(request);
+}
+
 void emberResetNetworkState(void)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_RESET_NETWORK_STATE_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-  releaseCommandMutex();
+  emberResetNetworkStateResult(emberResetNetworkStateAsync());
 }
 
 // frequencyHoppingSetChannelMask
+sl_connect_ncp_request_t *emberFrequencyHoppingSetChannelMaskAsync(uint8_t channelMaskLength,
+                                                                   uint8_t *channelMask)
+{
+  uint8_t *finger = startCommand(EMBER_FREQUENCY_HOPPING_SET_CHANNEL_MASK_IPC_COMMAND_ID);
+  cspEncodeBuffer(&finger, channelMask, channelMaskLength);
+  return submitCommand(finger);
+}
+
+EmberStatus emberFrequencyHoppingSetChannelMaskResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
+  return status;
+}
+
 EmberStatus emberFrequencyHoppingSetChannelMask(uint8_t channelMaskLength,
                                                 uint8_t *channelMask)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_FREQUENCY_HOPPING_SET_CHANNEL_MASK_IPC_COMMAND_ID,
-                                          "b",
-                                          channelMask,
-                                          channelMaskLength);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberFrequencyHoppingSetChannelMaskResult(emberFrequencyHoppingSetChannelMaskAsync(channelMaskLength,
+                                                                                            channelMask));
+}
+
+// frequencyHoppingStartServer
+sl_connect_ncp_request_t *emberFrequencyHoppingStartServerAsync(void)
+{
+  return submitCommand(startCommand(EMBER_FREQUENCY_HOPPING_START_SERVER_IPC_COMMAND_ID));
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberFrequencyHoppingStartServerResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// frequencyHoppingStartServer
 EmberStatus emberFrequencyHoppingStartServer(void)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_FREQUENCY_HOPPING_START_SERVER_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberFrequencyHoppingStartServerResult(emberFrequencyHoppingStartServerAsync());
+}
+
+// frequencyHoppingStartClient
+sl_connect_ncp_request_t *emberFrequencyHoppingStartClientAsync(EmberNodeId serverNodeId,
+                                                                EmberPanId serverPanId)
+{
+  uint8_t *finger = startCommand(EMBER_FREQUENCY_HOPPING_START_CLIENT_IPC_COMMAND_ID);
+  cspEncodeUint16(&finger, serverNodeId);
+  cspEncodeUint16(&finger, serverPanId);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberFrequencyHoppingStartClientResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// frequencyHoppingStartClient
 EmberStatus emberFrequencyHoppingStartClient(EmberNodeId serverNodeId,
                                              EmberPanId serverPanId)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_FREQUENCY_HOPPING_START_CLIENT_IPC_COMMAND_ID,
-                                          "vv",
-                                          serverNodeId,
-                                          serverPanId);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberFrequencyHoppingStartClientResult(emberFrequencyHoppingStartClientAsync(serverNodeId,
+                                                                                      serverPanId));
+}
+
+// frequencyHoppingStop
+sl_connect_ncp_request_t *emberFrequencyHoppingStopAsync(void)
+{
+  return submitCommand(startCommand(EMBER_FREQUENCY_HOPPING_STOP_IPC_COMMAND_ID));
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberFrequencyHoppingStopResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// frequencyHoppingStop
 EmberStatus emberFrequencyHoppingStop(void)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_FREQUENCY_HOPPING_STOP_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return emberFrequencyHoppingStopResult(emberFrequencyHoppingStopAsync());
+}
+
+// setAuxiliaryAddressFilteringEntry
+sl_connect_ncp_request_t *emberSetAuxiliaryAddressFilteringEntryAsync(EmberNodeId nodeId,
+                                                                      uint8_t entryIndex)
+{
+  uint8_t *finger = startCommand(EMBER_SET_AUXILIARY_ADDRESS_FILTERING_ENTRY_IPC_COMMAND_ID);
+  cspEncodeUint16(&finger, nodeId);
+  cspEncodeUint8(&finger, entryIndex);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberSetAuxiliaryAddressFilteringEntryResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
-// setAuxiliaryAddressFilteringEntry
 EmberStatus emberSetAuxiliaryAddressFilteringEntry(EmberNodeId nodeId,
                                                    uint8_t entryIndex)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_SET_AUXILIARY_ADDRESS_FILTERING_ENTRY_IPC_COMMAND_ID,
-                                          "vu",
-                                          nodeId,
-                                          entryIndex);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
-  return status;
+  return emberSetAuxiliaryAddressFilteringEntryResult(emberSetAuxiliaryAddressFilteringEntryAsync(nodeId,
+                                                                                                  entryIndex));
 }
 
 // getAuxiliaryAddressFilteringEntry
-EmberNodeId emberGetAuxiliaryAddressFilteringEntry(uint8_t entryIndex)
+sl_connect_ncp_request_t *emberGetAuxiliaryAddressFilteringEntryAsync(uint8_t entryIndex)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_GET_AUXILIARY_ADDRESS_FILTERING_ENTRY_IPC_COMMAND_ID,
-                                          "u",
-                                          entryIndex);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  uint8_t *finger = startCommand(EMBER_GET_AUXILIARY_ADDRESS_FILTERING_ENTRY_IPC_COMMAND_ID);
+  cspEncodeUint8(&finger, entryIndex);
+  return submitCommand(finger);
+}
 
-  EmberNodeId nodeId;
-  fetchApiParams(apiCommandData,
-                 "v",
-                 &nodeId);
-  releaseCommandMutex();
+EmberNodeId emberGetAuxiliaryAddressFilteringEntryResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberNodeId nodeId = cspDecodeUint16(&finger);
+  releaseCommandRequest(request);
   return nodeId;
 }
 
+EmberNodeId emberGetAuxiliaryAddressFilteringEntry(uint8_t entryIndex)
+{
+  return emberGetAuxiliaryAddressFilteringEntryResult(emberGetAuxiliaryAddressFilteringEntryAsync(entryIndex));
+}
+
 // startTxStream
-EmberStatus emberStartTxStream(EmberTxStreamParameters parameters,
-                               uint16_t channel)
+sl_connect_ncp_request_t *emberStartTxStreamAsync(EmberTxStreamParameters parameters,
+                                                  uint16_t channel)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_START_TX_STREAM_IPC_COMMAND_ID,
-                                          "uv",
-                                          parameters,
-                                          channel);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  uint8_t *finger = startCommand(EMBER_START_TX_STREAM_IPC_COMMAND_ID);
+  cspEncodeUint8(&finger, parameters);
+  cspEncodeUint16(&finger, channel);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberStartTxStreamResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
+EmberStatus emberStartTxStream(EmberTxStreamParameters parameters,
+                               uint16_t channel)
+{
+  return emberStartTxStreamResult(emberStartTxStreamAsync(parameters,
+                                                          channel));
+}
+
 // stopTxStream
-EmberStatus emberStopTxStream(void)
+sl_connect_ncp_request_t *emberStopTxStreamAsync(void)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_STOP_TX_STREAM_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  return submitCommand(startCommand(EMBER_STOP_TX_STREAM_IPC_COMMAND_ID));
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberStopTxStreamResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
+EmberStatus emberStopTxStream(void)
+{
+  return emberStopTxStreamResult(emberStopTxStreamAsync());
+}
+
 // setActiveScanDuration
-EmberStatus emberSetActiveScanDuration(uint16_t durationMs)
+sl_connect_ncp_request_t *emberSetActiveScanDurationAsync(uint16_t durationMs)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_SET_ACTIVE_SCAN_DURATION_IPC_COMMAND_ID,
-                                          "v",
-                                          durationMs);
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
+  uint8_t *finger = startCommand(EMBER_SET_ACTIVE_SCAN_DURATION_IPC_COMMAND_ID);
+  cspEncodeUint16(&finger, durationMs);
+  return submitCommand(finger);
+}
 
-  EmberStatus status;
-  fetchApiParams(apiCommandData,
-                 "u",
-                 &status);
-  releaseCommandMutex();
+EmberStatus emberSetActiveScanDurationResult(sl_connect_ncp_request_t *request)
+{
+  uint8_t *finger = waitForCommandResponse(request);
+  EmberStatus status = cspDecodeUint8(&finger);
+  releaseCommandRequest(request);
   return status;
 }
 
+EmberStatus emberSetActiveScanDuration(uint16_t durationMs)
+{
+  return emberSetActiveScanDurationResult(emberSetActiveScanDurationAsync(durationMs));
+}
+
 // getActiveScanDuration
-uint16_t emberGetActiveScanDuration(void)
+sl_connect_ncp_request_t *emberGetActiveScanDurationAsync(void)
+{
+  return submitCommand(startCommand(EMBER_GET_ACTIVE_SCAN_DURATION_IPC_COMMAND_ID));
+}
+
+uint16_t emberGetActiveScanDurationResult(sl_connect_ncp_request_t *request)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_GET_ACTIVE_SCAN_DURATION_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
-  uint16_t durationMs;
-  fetchApiParams(apiCommandData,
-                 "v",
-                 &durationMs);
-  releaseCommandMutex();
+  uint8_t *finger = waitForCommandResponse(request);
+  uint16_t durationMs = cspDecodeUint16(&finger);
+  releaseCommandRequest(request);
   return durationMs;
 }
 
+uint16_t emberGetActiveScanDuration(void)
+{
+  return emberGetActiveScanDurationResult(emberGetActiveScanDurationAsync());
+}
+
 // getDefaultChannel
-uint16_t emberGetDefaultChannel(void)
+sl_connect_ncp_request_t *emberGetDefaultChannelAsync(void)
+{
+  return submitCommand(startCommand(EMBER_GET_DEFAULT_CHANNEL_IPC_COMMAND_ID));
+}
+
+uint16_t emberGetDefaultChannelResult(sl_connect_ncp_request_t *request)
 {
-  acquireCommandMutex();
-  uint8_t *apiCommandBuffer = getApiCommandPointer();
-  uint16_t length = formatResponseCommand(apiCommandBuffer,
-                                          MAX_STACK_API_COMMAND_SIZE,
-                                          EMBER_GET_DEFAULT_CHANNEL_IPC_COMMAND_ID,
-                                          "");
-  uint8_t *apiCommandData = sendBlockingCommand(apiCommandBuffer, length);
-
-  uint16_t firstChannel;
-  fetchApiParams(apiCommandData,
-                 "v",
-                 &firstChannel);
-  releaseCommandMutex();
+  uint8_t *finger = waitForCommandResponse(request);
+  uint16_t firstChannel = cspDecodeUint16(&finger);
+  releaseCommandRequest(request);
   return firstChannel;
 }
+
+uint16_t emberGetDefaultChannel(void)
+{
+  uint16_t channel;
+  uint32_t generation;
+
+  if (sli_connect_ncp_cache_read(SLI_CONNECT_NCP_CACHE_DEFAULT_CHANNEL, &channel, sizeof(channel), &generation)) {
+    return channel;
+  }
+  channel = emberGetDefaultChannelResult(emberGetDefaultChannelAsync());
+  sli_connect_ncp_cache_write(SLI_CONNECT_NCP_CACHE_DEFAULT_CHANNEL, &channel, sizeof(channel), generation);
+  return channel;
+}
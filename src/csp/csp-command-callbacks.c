@@ -14,7 +14,9 @@
  *
  ******************************************************************************/
 
-// *** Generated file. Do not edit! ***
+// Initially generated from the vNCP API description, now maintained by hand:
+// the encoders and decoders of each command follow csp-format.h, whose
+// encoders only compile with a parameter of the type they write.
 // vNCP Version: 1.0
 
 #include "connect/ember.h"
@@ -29,10 +31,8 @@
 
 static void stackStatusCommandHandler(uint8_t *callbackParams)
 {
-  EmberStatus status;
-  fetchCallbackParams(callbackParams,
-                      "u",
-                      &status);
+  uint8_t *finger = callbackParams;
+  EmberStatus status = cspDecodeUint8(&finger);
 
   emberAfStackStatusCallback(status);
   emberAfStackStatus(status);
@@ -40,12 +40,9 @@ static void stackStatusCommandHandler(uint8_t *callbackParams)
 
 static void childJoinCommandHandler(uint8_t *callbackParams)
 {
-  EmberNodeType nodeType;
-  EmberNodeId nodeId;
-  fetchCallbackParams(callbackParams,
-                      "uv",
-                      &nodeType,
-                      &nodeId);
+  uint8_t *finger = callbackParams;
+  EmberNodeType nodeType = cspDecodeUint8(&finger);
+  EmberNodeId nodeId = cspDecodeUint16(&finger);
 
   emberAfChildJoinCallback(nodeType,
                            nodeId);
@@ -61,26 +58,20 @@ static void radioNeedsCalibratingCommandHandler(uint8_t *callbackParams)
   emberAfRadioNeedsCalibrating();
 }
 
-static void messageSentCommandHandler(uint8_t *callbackParams)
+static void messageSentCommandHandler(uint8_t *callbackParams, uint16_t length)
 {
-  EmberStatus status;
+  uint8_t *finger = callbackParams;
+  const uint8_t *end = callbackParams + length;
   EmberOutgoingMessage message;
-  uint8_t payload[2048];
-  message.payload = payload;
-  fetchCallbackParams(callbackParams,
-                      "uuvuulbuw",
-                      &status,
-                      &message.options,
-                      &message.destination,
-                      &message.endpoint,
-                      &message.tag,
-                      &message.length,
-                      message.payload,
-                      CSP_FETCH_ARG_IS_UINT16,
-                      &message.length,
-                      2048,
-                      &message.ackRssi,
-                      &message.timestamp);
+  EmberStatus status = cspDecodeUint8(&finger);
+  message.options = cspDecodeUint8(&finger);
+  message.destination = cspDecodeUint16(&finger);
+  message.endpoint = cspDecodeUint8(&finger);
+  message.tag = cspDecodeUint8(&finger);
+  message.length = cspDecodeLength(&finger);
+  message.payload = cspDecodeBufferView(&finger, end, &message.length);
+  message.ackRssi = cspDecodeInt8(&finger);
+  message.timestamp = cspDecodeUint32(&finger);
 
   emberAfMessageSentCallback(status,
                              &message);
@@ -88,104 +79,74 @@ static void messageSentCommandHandler(uint8_t *callbackParams)
                      &message);
 }
 
-static void incomingMessageCommandHandler(uint8_t *callbackParams)
+static void incomingMessageCommandHandler(uint8_t *callbackParams, uint16_t length)
 {
+  uint8_t *finger = callbackParams;
+  const uint8_t *end = callbackParams + length;
   EmberIncomingMessage message;
-  uint8_t payload[2048];
-  message.payload = payload;
-  fetchCallbackParams(callbackParams,
-                      "uvuulbwu",
-                      &message.options,
-                      &message.source,
-                      &message.endpoint,
-                      &message.rssi,
-                      &message.length,
-                      message.payload,
-                      CSP_FETCH_ARG_IS_UINT16,
-                      &message.length,
-                      2048,
-                      &message.timestamp,
-                      &message.lqi);
+  message.options = cspDecodeUint8(&finger);
+  message.source = cspDecodeUint16(&finger);
+  message.endpoint = cspDecodeUint8(&finger);
+  message.rssi = cspDecodeInt8(&finger);
+  message.length = cspDecodeLength(&finger);
+  message.payload = cspDecodeBufferView(&finger, end, &message.length);
+  message.timestamp = cspDecodeUint32(&finger);
+  message.lqi = cspDecodeUint8(&finger);
 
   emberAfIncomingMessageCallback(&message);
   emberAfIncomingMessage(&message);
 }
 
-static void incomingMacMessageCommandHandler(uint8_t *callbackParams)
+static void incomingMacMessageCommandHandler(uint8_t *callbackParams, uint16_t length)
 {
+  uint8_t *finger = callbackParams;
+  const uint8_t *end = callbackParams + length;
   EmberIncomingMacMessage message;
-  uint8_t eui64Size = EUI64_SIZE;
-  uint8_t payload[2048];
-  message.payload = payload;
-  fetchCallbackParams(callbackParams,
-                      "uvbuvbuvvuuuuwlbw",
-                      &message.options,
-                      &message.macFrame.srcAddress.addr.shortAddress,
-                      message.macFrame.srcAddress.addr.longAddress,
-                      CSP_FETCH_ARG_IS_UINT8,
-                      &eui64Size,
-                      EUI64_SIZE,
-                      &message.macFrame.srcAddress.mode,
-                      &message.macFrame.dstAddress.addr.shortAddress,
-                      message.macFrame.dstAddress.addr.longAddress,
-                      CSP_FETCH_ARG_IS_UINT8,
-                      &eui64Size,
-                      EUI64_SIZE,
-                      &message.macFrame.dstAddress.mode,
-                      &message.macFrame.srcPanId,
-                      &message.macFrame.dstPanId,
-                      &message.macFrame.srcPanIdSpecified,
-                      &message.macFrame.dstPanIdSpecified,
-                      &message.rssi,
-                      &message.lqi,
-                      &message.frameCounter,
-                      &message.length,
-                      message.payload,
-                      CSP_FETCH_ARG_IS_UINT16,
-                      &message.length,
-                      2048,
-                      &message.timestamp);
+  message.options = cspDecodeUint8(&finger);
+  message.macFrame.srcAddress.addr.shortAddress = cspDecodeUint16(&finger);
+  cspDecodeBuffer(&finger, end, message.macFrame.srcAddress.addr.longAddress, EUI64_SIZE);
+  message.macFrame.srcAddress.mode = cspDecodeUint8(&finger);
+  message.macFrame.dstAddress.addr.shortAddress = cspDecodeUint16(&finger);
+  cspDecodeBuffer(&finger, end, message.macFrame.dstAddress.addr.longAddress, EUI64_SIZE);
+  message.macFrame.dstAddress.mode = cspDecodeUint8(&finger);
+  message.macFrame.srcPanId = cspDecodeUint16(&finger);
+  message.macFrame.dstPanId = cspDecodeUint16(&finger);
+  message.macFrame.srcPanIdSpecified = cspDecodeUint8(&finger);
+  message.macFrame.dstPanIdSpecified = cspDecodeUint8(&finger);
+  message.rssi = cspDecodeInt8(&finger);
+  message.lqi = cspDecodeUint8(&finger);
+  message.frameCounter = cspDecodeUint32(&finger);
+  message.length = cspDecodeLength(&finger);
+  message.payload = cspDecodeBufferView(&finger, end, &message.length);
+  message.timestamp = cspDecodeUint32(&finger);
 
   emberAfIncomingMacMessageCallback(&message);
   emberAfIncomingMacMessage(&message);
 }
 
-static void macMessageSentCommandHandler(uint8_t *callbackParams)
+static void macMessageSentCommandHandler(uint8_t *callbackParams, uint16_t length)
 {
-  EmberStatus status;
+  uint8_t *finger = callbackParams;
+  const uint8_t *end = callbackParams + length;
   EmberOutgoingMacMessage message;
-  uint8_t eui64Size = EUI64_SIZE;
-  uint8_t payload[2048];
-  message.payload = payload;
-  fetchCallbackParams(callbackParams,
-                      "uuvbuvbuvvuuuwlbuw",
-                      &status,
-                      &message.options,
-                      &message.macFrame.srcAddress.addr.shortAddress,
-                      message.macFrame.srcAddress.addr.longAddress,
-                      CSP_FETCH_ARG_IS_UINT8,
-                      &eui64Size,
-                      EUI64_SIZE,
-                      &message.macFrame.srcAddress.mode,
-                      &message.macFrame.dstAddress.addr.shortAddress,
-                      message.macFrame.dstAddress.addr.longAddress,
-                      CSP_FETCH_ARG_IS_UINT8,
-                      &eui64Size,
-                      EUI64_SIZE,
-                      &message.macFrame.dstAddress.mode,
-                      &message.macFrame.srcPanId,
-                      &message.macFrame.dstPanId,
-                      &message.macFrame.srcPanIdSpecified,
-                      &message.macFrame.dstPanIdSpecified,
-                      &message.tag,
-                      &message.frameCounter,
-                      &message.length,
-                      message.payload,
-                      CSP_FETCH_ARG_IS_UINT16,
-                      &message.length,
-                      2048,
-                      &message.ackRssi,
-                      &message.timestamp);
+  EmberStatus status = cspDecodeUint8(&finger);
+  message.options = cspDecodeUint8(&finger);
+  message.macFrame.srcAddress.addr.shortAddress = cspDecodeUint16(&finger);
+  cspDecodeBuffer(&finger, end, message.macFrame.srcAddress.addr.longAddress, EUI64_SIZE);
+  message.macFrame.srcAddress.mode = cspDecodeUint8(&finger);
+  message.macFrame.dstAddress.addr.shortAddress = cspDecodeUint16(&finger);
+  cspDecodeBuffer(&finger, end, message.macFrame.dstAddress.addr.longAddress, EUI64_SIZE);
+  message.macFrame.dstAddress.mode = cspDecodeUint8(&finger);
+  message.macFrame.srcPanId = cspDecodeUint16(&finger);
+  message.macFrame.dstPanId = cspDecodeUint16(&finger);
+  message.macFrame.srcPanIdSpecified = cspDecodeUint8(&finger);
+  message.macFrame.dstPanIdSpecified = cspDecodeUint8(&finger);
+  message.tag = cspDecodeUint8(&finger);
+  message.frameCounter = cspDecodeUint32(&finger);
+  message.length = cspDecodeLength(&finger);
+  message.payload = cspDecodeBufferView(&finger, end, &message.length);
+  message.ackRssi = cspDecodeInt8(&finger);
+  message.timestamp = cspDecodeUint32(&finger);
 
   emberAfMacMessageSentCallback(status,
                                 &message);
@@ -193,38 +154,26 @@ static void macMessageSentCommandHandler(uint8_t *callbackParams)
                         &message);
 }
 
-static void incomingBeaconCommandHandler(uint8_t *callbackParams)
+static void incomingBeaconCommandHandler(uint8_t *callbackParams, uint16_t length)
 {
-  EmberPanId panId;
+  uint8_t *finger = callbackParams;
+  const uint8_t *end = callbackParams + length;
   EmberMacAddress source;
-  int8_t rssi;
-  bool permitJoining;
-  uint8_t beaconFieldsLength;
-  uint8_t beaconPayloadLength;
-  uint8_t eui64Size = EUI64_SIZE;
-  static uint8_t beaconFields[EMBER_MAC_MAX_BEACON_FIELDS_LENGTH];
-  static uint8_t beaconPayload[EMBER_MAC_STACK_BEACON_PAYLOAD_LENGTH + EMBER_MAC_MAX_APP_BEACON_PAYLOAD_LENGTH];
-  fetchCallbackParams(callbackParams,
-                      "vvbuuuubub",
-                      &panId,
-                      &source.addr.shortAddress,
-                      source.addr.longAddress,
-                      CSP_FETCH_ARG_IS_UINT8,
-                      &eui64Size,
-                      EUI64_SIZE,
-                      &source.mode,
-                      &rssi,
-                      &permitJoining,
-                      &beaconFieldsLength,
-                      beaconFields,
-                      CSP_FETCH_ARG_IS_UINT8,
-                      &beaconFieldsLength,
-                      EMBER_MAC_MAX_BEACON_FIELDS_LENGTH,
-                      &beaconPayloadLength,
-                      beaconPayload,
-                      CSP_FETCH_ARG_IS_UINT8,
-                      &beaconPayloadLength,
-                      EMBER_MAC_STACK_BEACON_PAYLOAD_LENGTH + EMBER_MAC_MAX_APP_BEACON_PAYLOAD_LENGTH);
+  uint16_t bufferLength;
+  EmberPanId panId = cspDecodeUint16(&finger);
+  source.addr.shortAddress = cspDecodeUint16(&finger);
+  cspDecodeBuffer(&finger, end, source.addr.longAddress, EUI64_SIZE);
+  source.mode = cspDecodeUint8(&finger);
+  int8_t rssi = cspDecodeInt8(&finger);
+  bool permitJoining = cspDecodeUint8(&finger);
+  uint8_t beaconFieldsLength = cspDecodeUint8(&finger);
+  uint8_t *beaconFields = cspDecodeBufferView(&finger, end, &bufferLength);
+  beaconFieldsLength = (bufferLength <= EMBER_MAC_MAX_BEACON_FIELDS_LENGTH)
+                       ? bufferLength : EMBER_MAC_MAX_BEACON_FIELDS_LENGTH;
+  uint8_t beaconPayloadLength = cspDecodeUint8(&finger);
+  uint8_t *beaconPayload = cspDecodeBufferView(&finger, end, &bufferLength);
+  beaconPayloadLength = (bufferLength <= EMBER_MAC_STACK_BEACON_PAYLOAD_LENGTH + EMBER_MAC_MAX_APP_BEACON_PAYLOAD_LENGTH)
+                        ? bufferLength : EMBER_MAC_STACK_BEACON_PAYLOAD_LENGTH + EMBER_MAC_MAX_APP_BEACON_PAYLOAD_LENGTH;
 
   emberAfIncomingBeaconCallback(panId,
                                 &source,
@@ -254,16 +203,11 @@ static void activeScanCompleteCommandHandler(uint8_t *callbackParams)
 
 static void energyScanCompleteCommandHandler(uint8_t *callbackParams)
 {
-  int8_t mean;
-  int8_t min;
-  int8_t max;
-  uint16_t variance;
-  fetchCallbackParams(callbackParams,
-                      "uuuv",
-                      &mean,
-                      &min,
-                      &max,
-                      &variance);
+  uint8_t *finger = callbackParams;
+  int8_t mean = cspDecodeInt8(&finger);
+  int8_t min = cspDecodeInt8(&finger);
+  int8_t max = cspDecodeInt8(&finger);
+  uint16_t variance = cspDecodeUint16(&finger);
 
   emberAfEnergyScanCompleteCallback(mean,
                                     min,
@@ -277,10 +221,8 @@ static void energyScanCompleteCommandHandler(uint8_t *callbackParams)
 
 static void frequencyHoppingStartClientCompleteCommandHandler(uint8_t *callbackParams)
 {
-  EmberStatus status;
-  fetchCallbackParams(callbackParams,
-                      "u",
-                      &status);
+  uint8_t *finger = callbackParams;
+  EmberStatus status = cspDecodeUint8(&finger);
 
   emberAfFrequencyHoppingStartClientCompleteCallback(status);
   emberAfFrequencyHoppingStartClientComplete(status);
@@ -290,7 +232,8 @@ static void frequencyHoppingStartClientCompleteCommandHandler(uint8_t *callbackP
 // Callback command dispatcher (Application side)
 
 void sli_connect_ncp_handle_indication(uint16_t commandId,
-                                       uint8_t *callbackParams)
+                                       uint8_t *callbackParams,
+                                       uint16_t length)
 {
   assert(!isCurrentTaskStackTask());
 
@@ -305,19 +248,19 @@ void sli_connect_ncp_handle_indication(uint16_t commandId,
       radioNeedsCalibratingCommandHandler(callbackParams);
       break;
     case EMBER_MESSAGE_SENT_HANDLER_IPC_COMMAND_ID:
-      messageSentCommandHandler(callbackParams);
+      messageSentCommandHandler(callbackParams, length);
       break;
     case EMBER_INCOMING_MESSAGE_HANDLER_IPC_COMMAND_ID:
-      incomingMessageCommandHandler(callbackParams);
+      incomingMessageCommandHandler(callbackParams, length);
       break;
     case EMBER_INCOMING_MAC_MESSAGE_HANDLER_IPC_COMMAND_ID:
-      incomingMacMessageCommandHandler(callbackParams);
+      incomingMacMessageCommandHandler(callbackParams, length);
       break;
     case EMBER_MAC_MESSAGE_SENT_HANDLER_IPC_COMMAND_ID:
-      macMessageSentCommandHandler(callbackParams);
+      macMessageSentCommandHandler(callbackParams, length);
       break;
     case EMBER_INCOMING_BEACON_HANDLER_IPC_COMMAND_ID:
-      incomingBeaconCommandHandler(callbackParams);
+      incomingBeaconCommandHandler(callbackParams, length);
       break;
     case EMBER_ACTIVE_SCAN_COMPLETE_HANDLER_IPC_COMMAND_ID:
       activeScanCompleteCommandHandler(callbackParams);
@@ -329,7 +272,7 @@ void sli_connect_ncp_handle_indication(uint16_t commandId,
       frequencyHoppingStartClientCompleteCommandHandler(callbackParams);
       break;
     default: {
-      FATAL(1, "Unknown incoming callback command id: %04X", commandId);
+      WARN("Dropping unknown incoming callback command id: %04X", commandId);
     }
   }
 }
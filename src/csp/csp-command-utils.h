@@ -17,23 +17,62 @@
 #ifndef __CSP_COMMAND_UTILS_H__
 #define __CSP_COMMAND_UTILS_H__
 
+#include "connect/ncp-async.h"
+
 //------------------------------------------------------------------------------
 // Functions to implement in RTOS or NCP files
 
-uint8_t *sendBlockingCommand(uint8_t *apiCommandBuffer, uint16_t commandLength);
+/**
+ * Reserve a request and write the command identifier in its command buffer,
+ * which belongs to the calling thread until submitCommand(). The command
+ * parameters are then encoded from the returned position with the csp-format
+ * encoders.
+ */
+uint8_t *startCommand(uint16_t identifier);
 
-uint8_t *getApiCommandPointer();
+/**
+ * Send the command encoded up to commandEnd to the NCP without waiting for its
+ * response. Only the write to the NCP is serialized with the other threads.
+ * The returned request must be passed to waitForCommandResponse() then to
+ * releaseCommandRequest().
+ */
+sl_connect_ncp_request_t *submitCommand(uint8_t *commandEnd);
 
-void acquireCommandMutex(void);
+/**
+ * Invalidate the response cache when the command being encoded is queued, as
+ * it may change cached values. A getter queued before it may still answer
+ * with the previous value, so its answer is not cached; a getter queued after
+ * it is answered once the NCP executed it.
+ */
+void invalidateCacheOnSubmit(void);
 
-void releaseCommandMutex(void);
+/**
+ * Wait for the response of a request and return its parameters, right after
+ * the command identifier. They stay valid until releaseCommandRequest() is
+ * called.
+ */
+uint8_t *waitForCommandResponse(sl_connect_ncp_request_t *request);
 
-bool isCurrentTaskStackTask(void);
+/**
+ * End of the response returned by waitForCommandResponse(), to bound the
+ * decoding of its variable length parameters.
+ */
+const uint8_t *commandResponseEnd(sl_connect_ncp_request_t *request);
+
+/**
+ * Parameters of the command sent by a request, right after the command
+ * identifier, and their end, so that a setter records what the NCP accepted
+ * once it answered. They stay valid until releaseCommandRequest() is called.
+ */
+uint8_t *commandParameters(sl_connect_ncp_request_t *request);
+const uint8_t *commandParametersEnd(sl_connect_ncp_request_t *request);
 
-void sendCallbackCommand(uint8_t *callbackCommandBuffer, uint16_t commandLength);
+void releaseCommandRequest(sl_connect_ncp_request_t *request);
+
+bool isCurrentTaskStackTask(void);
 
 //------------------------------------------------------------------------------
 // Internal APIs defined in csp-command-vncp.c or csp-command-app.c
-void sli_connect_ncp_handle_indication(uint16_t command_id, uint8_t *rx_buffer);
+void sli_connect_ncp_handle_indication(uint16_t command_id, uint8_t *rx_buffer, uint16_t length);
 
 #endif
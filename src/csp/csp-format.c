@@ -15,319 +15,93 @@
  ******************************************************************************/
 
 #include <stdint.h>
-#include <stdio.h>
 #include <stdbool.h>
-#include <stdarg.h>
-#include <assert.h>
 #include <string.h>
-#include <connect/ember.h>
+#include "csp-format.h"
+#include "host-common/ncp-host-common.h"
 #include "log/log.h"
-#include "connect/byte-utilities.h"
-#include "host-common/cpc-host.h"
 
-static bool use_long_message_length = false;
+// The message length encoding is negotiated with each NCP
+static bool use_long_message_length[SL_CONNECT_NCP_MAX_INSTANCES];
 
-// TODO: the two functions below can be consolidated
-
-void fetchParams(uint8_t *readPointer, char *format, va_list args)
+static bool using_long_message_length(void)
 {
-  char *c = (char *)format;
-  void* ptr;
-
-  while (*c) {
-    ptr = va_arg(args, void*);
-
-    switch (*c) {
-      case 's': {
-        uint8_t *realPointer = (uint8_t *)ptr;
-        if (ptr) {
-          *realPointer = (uint8_t)*readPointer;
-        }
-        readPointer++;
-      }
-      break;
-      case 'u': {
-        uint8_t *realPointer = (uint8_t *)ptr;
-        if (ptr) {
-          *realPointer = (uint8_t)*readPointer;
-        }
-        readPointer++;
-      }
-      break;
-      case 'v': {
-        uint16_t *realPointer = (uint16_t *)ptr;
-        *realPointer = emberFetchHighLowInt16u(readPointer);
-        readPointer += 2;
-      }
-      break;
-      case 'l': {
-        uint16_t *realPointer = (uint16_t *)ptr;
-        if (use_long_message_length) {
-          *realPointer = emberFetchHighLowInt16u(readPointer);
-          readPointer += 2;
-        } else {
-          if (ptr) {
-            *realPointer = (uint16_t)*readPointer;
-          }
-          readPointer++;
-        }
-      }
-      break;
-      case 'w': {
-        uint32_t *realPointer = (uint32_t *)ptr;
-        if (ptr) {
-          *realPointer = emberFetchHighLowInt32u(readPointer);
-        }
-        readPointer += 4;
-      }
-      break;
-      case 'b': {
-        uint8_t *realArray = (uint8_t *)ptr;
-        uint16_t bufferAvailableSize;
-        uint16_t bufferLength = 0;
-        if (use_long_message_length) {
-          bufferLength = emberFetchHighLowInt16u(readPointer);
-          readPointer += sizeof(uint16_t);
-        } else {
-          bufferLength = (uint16_t)*readPointer;
-          readPointer++;
-        }
-
-        uint8_t isUint8 = (uint8_t)va_arg(args, unsigned int);
-        if (isUint8) {
-          uint8_t *lengthPointer = (uint8_t *)va_arg(args, void*);
-          bufferAvailableSize = (uint16_t)va_arg(args, unsigned int);
-          *lengthPointer = (uint8_t)(bufferLength & 0xFF);
-          // Propagate correct length value in calling function
-          if (*lengthPointer > bufferAvailableSize) {
-            *lengthPointer = bufferAvailableSize;
-          }
-        } else {
-          uint16_t *lengthPointer = (uint16_t *)va_arg(args, void*);
-          bufferAvailableSize = (uint16_t)va_arg(args, unsigned int);
-          *lengthPointer = bufferLength;
-          // Propagate correct length value in calling function
-          if (*lengthPointer > bufferAvailableSize) {
-            *lengthPointer = bufferAvailableSize;
-          }
-        }
-
-        if (ptr) {
-          if (bufferLength <= bufferAvailableSize) {
-            memmove(realArray, readPointer, bufferLength);
-          } else {
-            memmove(realArray, readPointer, bufferAvailableSize);
-          }
-        }
-        readPointer += bufferLength;
-      }
-      break;
-      case 'p': {
-        uint8_t **realPointer = (uint8_t **)ptr;
-        uint16_t bufferLength;
-        if (use_long_message_length) {
-          bufferLength = emberFetchHighLowInt16u(readPointer);
-          readPointer += sizeof(uint16_t);
-        } else {
-          bufferLength = (uint16_t)*readPointer;
-          readPointer++;
-        }
+  return use_long_message_length[sli_connect_ncp_current_instance()];
+}
 
-        uint8_t isUint8 = (uint8_t)va_arg(args, unsigned int);
-        if (isUint8) {
-          uint8_t *lengthPointer = (uint8_t *)va_arg(args, void*);
-          *lengthPointer = (uint8_t)(bufferLength & 0xFF);
-        } else {
-          uint16_t *lengthPointer = (uint16_t *)va_arg(args, void*);
-          *lengthPointer = bufferLength;
-        }
-        if (ptr) {
-          *realPointer = readPointer;
-        }
-        readPointer += bufferLength;
-      }
-      break;
-      default:
-        ; // meh
-    }
-    c++;
+void cspEncodeLength(uint8_t **finger, uint16_t length)
+{
+  if (using_long_message_length()) {
+    cspEncodeUint16(finger, length);
+  } else {
+    cspEncodeUint8(finger, (uint8_t)(length & 0xFF));
   }
 }
 
-uint8_t computeCommandLength(uint8_t initialLength, const char* format, va_list argumentList)
+void cspEncodeBuffer(uint8_t **finger, const uint8_t *data, uint16_t size)
 {
-  uint8_t commandLength = initialLength;
-  const char *formatFinger;
-  for (formatFinger = (char *) format; *formatFinger != 0; formatFinger++) {
-    switch (*formatFinger) {
-      case 'u':
-        va_arg(argumentList, unsigned int);
-        commandLength++;
-        break;
-      case 's':
-        va_arg(argumentList, int);
-        commandLength++;
-        break;
-      case 'v':
-        va_arg(argumentList, unsigned int);
-        commandLength += sizeof(uint16_t);
-        break;
-      case 'l': {
-        va_arg(argumentList, unsigned int);
-        if (use_long_message_length) {
-          commandLength += sizeof(uint16_t);
-        } else {
-          commandLength++;
-        }
-        break;
-      }
-      case 'w':
-        va_arg(argumentList, uint32_t);
-        commandLength += sizeof(uint32_t);
-        break;
-      case 'b': {
-        va_arg(argumentList, const uint8_t*);
-        if (use_long_message_length) {
-          commandLength += va_arg(argumentList, int) + 2;
-        } else {
-          commandLength += va_arg(argumentList, int) + 1;
-        }
-        break;
-      }
-      default:
-        FATAL(1, "Invalid argument type");
-        break;
+  cspEncodeLength(finger, size);
+
+  if (size > 0) {
+    // Checking for NULL here save's every caller from checking.  We assume
+    // the if size is not zero then we should send all zeroes.
+    if (data != NULL) {
+      memcpy(*finger, data, size);
+    } else {
+      memset(*finger, 0, size);
     }
   }
-  return commandLength;
+  *finger += size;
 }
 
-void fetchApiParams(uint8_t *apiCommandData, char *format, ...)
+uint16_t cspDecodeLength(uint8_t **finger)
 {
-  va_list argumentList;
-  va_start(argumentList, format);
-  // Start fetching right after the command ID
-  fetchParams(apiCommandData + 2, format, argumentList);
-  va_end(argumentList);
+  if (using_long_message_length()) {
+    return cspDecodeUint16(finger);
+  }
+  return cspDecodeUint8(finger);
 }
 
-void fetchCallbackParams(uint8_t *callbackParams, char *format, ...)
+// A buffer running past the end of the frame is truncated rather than read
+// out of the frame
+static uint16_t clampBufferLength(const uint8_t *finger, const uint8_t *end, uint16_t length)
 {
-  va_list argumentList;
-  va_start(argumentList, format);
-  fetchParams(callbackParams, format, argumentList);
-  va_end(argumentList);
+  uint16_t available = (finger < end) ? (uint16_t)(end - finger) : 0;
+
+  if (length > available) {
+    WARN("CSP buffer of %u bytes truncated to the %u bytes left in the frame", length, available);
+    return available;
+  }
+  return length;
 }
 
-uint16_t formatResponseCommandFromArgList(uint8_t *buffer,
-                                          uint16_t bufferSize,
-                                          uint16_t identifier,
-                                          const char *format,
-                                          va_list argumentList)
+uint16_t cspDecodeBuffer(uint8_t **finger, const uint8_t *end, uint8_t *data, uint16_t capacity)
 {
-  uint8_t *finger = buffer;
-  const char *formatFinger;
-
-  memset(buffer, 0, bufferSize);
-
-  // store the identifier
-  emberStoreHighLowInt16u(finger, identifier);
-  finger += sizeof(uint16_t);
+  uint16_t length = cspDecodeLength(finger);
+  uint16_t copied;
 
-  // We use primitive types to retrieve va_args because gcc on some
-  // platforms (eg., unix hosts) complains about automatic variable
-  // promotion in variadic functions.
-  // [eg: warning: 'uint8_t' is promoted to 'int' when passed through '...']
-  //
-  // An exception is made for the uint32_t case:  Here we need to check the size
-  // of unsigned int, which can be smaller on platforms such as the c8051.
+  length = clampBufferLength(*finger, end, length);
+  copied = (length <= capacity) ? length : capacity;
 
-  for (formatFinger = (char *) format; *formatFinger != 0; formatFinger++) {
-    switch (*formatFinger) {
-      case 'u':
-        *finger++ = va_arg(argumentList, unsigned int);
-        break;
-      case 's':
-        *finger++ = va_arg(argumentList, int);
-        break;
-      case 'v':
-        emberStoreHighLowInt16u(finger, va_arg(argumentList, unsigned int));
-        finger += sizeof(uint16_t);
-        break;
-      case 'l': {
-        if (use_long_message_length) {
-          emberStoreHighLowInt16u(finger, va_arg(argumentList, unsigned int));
-          finger += sizeof(uint16_t);
-        } else {
-          *finger++ = (uint8_t)(va_arg(argumentList, unsigned int) & 0xFF);
-        }
-        break;
-      }
-      case 'w':
-        if (sizeof(unsigned int) < sizeof(uint32_t)) {
-          emberStoreHighLowInt32u(finger, va_arg(argumentList, uint32_t));
-        } else {
-          emberStoreHighLowInt32u(finger, va_arg(argumentList, unsigned int));
-        }
-        finger += sizeof(uint32_t);
-        break;
-      case 'b': {
-        const uint8_t *data = va_arg(argumentList, const uint8_t*);
-        uint16_t dataSize = (uint16_t)va_arg(argumentList, int);
-        if (use_long_message_length) {
-          // store the size, must fit into 2 bytes
-          emberStoreHighLowInt16u(finger, dataSize);
-          finger += sizeof(uint16_t);
-        } else {
-          // store the size, must fit into a byte
-          *finger++ = (uint8_t)(dataSize & 0xFF);
-        }
-
-        if (dataSize > 0) {
-          // Checking for NULL here save's every caller from checking.  We assume
-          // the if dataSize is not zero then we should send all zeroes.
-          if (data != NULL) {
-            memcpy(finger, data, dataSize);
-          } else {
-            memset(finger, 0, dataSize);
-          }
-        }
-
-        finger += dataSize;
-        break;
-      }
-      default:
-        // confused!
-        BUG("Invalid argument type while formating serialized command");
-        break;
-    }
+  if (data != NULL) {
+    memmove(data, *finger, copied);
   }
-
-  uint16_t length = finger - buffer;
-  // sanity check
-  BUG_ON(length > bufferSize, "Buffer overflow: command length is longer than the command buffer size");
-
-  return length;
+  *finger += length;
+  return copied;
 }
 
-uint16_t formatResponseCommand(uint8_t *buffer,
-                               uint16_t bufferSize,
-                               uint16_t identifier,
-                               char *format,
-                               ...)
+uint8_t *cspDecodeBufferView(uint8_t **finger, const uint8_t *end, uint16_t *length)
 {
-  va_list argumentList;
-  va_start(argumentList, format);
-  uint16_t length = formatResponseCommandFromArgList(buffer,
-                                                     bufferSize,
-                                                     identifier,
-                                                     format,
-                                                     argumentList);
-  va_end(argumentList);
-  return length;
+  uint8_t *data;
+
+  *length = cspDecodeLength(finger);
+  *length = clampBufferLength(*finger, end, *length);
+  data = *finger;
+  *finger += *length;
+  return data;
 }
 
 void set_csp_format_long_message_use(bool use_long_messages)
 {
-  use_long_message_length = use_long_messages;
+  use_long_message_length[sli_connect_ncp_current_instance()] = use_long_messages;
 }
@@ -18,8 +18,8 @@
 #ifndef __CSP_FORMAT_H__
 #define __CSP_FORMAT_H__
 
-#include <stdio.h>
-#include <stdarg.h>
+#include <stdint.h>
+#include <stdbool.h>
 
 // These 2 defines should be generated by actually setting them to the maximum
 // needed size for both APIs and stack callbacks. For now they are set to some
@@ -27,49 +27,110 @@
 #define MAX_STACK_API_COMMAND_SIZE                      2096
 #define MAX_STACK_CALLBACK_COMMAND_SIZE                 2096
 
-#define CSP_FETCH_ARG_IS_UINT16                         0
-#define CSP_FETCH_ARG_IS_UINT8                          1
+//------------------------------------------------------------------------------
+// Encoders and decoders used by the command and callback handlers. Each one
+// works on a finger pointing to the next byte to write or read, and moves the
+// finger past the parameter. Multi-byte integers are big endian.
+//
+// The encoders only accept a value of the type they write, so that passing a
+// parameter of another width fails to compile instead of being converted.
+// Constants, and expressions promoted to int, are cast to the parameter type
+// by the caller.
+
+#define cspEncodeUint8(finger, value)  cspEncodeUint8Value(finger, _Generic((value), uint8_t: (value), bool: (value)))
+#define cspEncodeInt8(finger, value)   cspEncodeInt8Value(finger, _Generic((value), int8_t: (value)))
+#define cspEncodeUint16(finger, value) cspEncodeUint16Value(finger, _Generic((value), uint16_t: (value)))
+#define cspEncodeInt16(finger, value)  cspEncodeUint16Value(finger, (uint16_t)_Generic((value), int16_t: (value)))
+#define cspEncodeUint32(finger, value) cspEncodeUint32Value(finger, _Generic((value), uint32_t: (value)))
+
+static inline void cspEncodeUint8Value(uint8_t **finger, uint8_t value)
+{
+  *(*finger)++ = value;
+}
+
+static inline void cspEncodeInt8Value(uint8_t **finger, int8_t value)
+{
+  *(*finger)++ = (uint8_t)value;
+}
+
+static inline void cspEncodeUint16Value(uint8_t **finger, uint16_t value)
+{
+  (*finger)[0] = (uint8_t)(value >> 8);
+  (*finger)[1] = (uint8_t)value;
+  *finger += sizeof(uint16_t);
+}
+
+static inline void cspEncodeUint32Value(uint8_t **finger, uint32_t value)
+{
+  (*finger)[0] = (uint8_t)(value >> 24);
+  (*finger)[1] = (uint8_t)(value >> 16);
+  (*finger)[2] = (uint8_t)(value >> 8);
+  (*finger)[3] = (uint8_t)value;
+  *finger += sizeof(uint32_t);
+}
+
+static inline uint8_t cspDecodeUint8(uint8_t **finger)
+{
+  return *(*finger)++;
+}
+
+static inline int8_t cspDecodeInt8(uint8_t **finger)
+{
+  return (int8_t)*(*finger)++;
+}
+
+static inline uint16_t cspDecodeUint16(uint8_t **finger)
+{
+  uint16_t value = (uint16_t)(((*finger)[0] << 8) | (*finger)[1]);
+  *finger += sizeof(uint16_t);
+  return value;
+}
+
+static inline int16_t cspDecodeInt16(uint8_t **finger)
+{
+  return (int16_t)cspDecodeUint16(finger);
+}
+
+static inline uint32_t cspDecodeUint32(uint8_t **finger)
+{
+  uint32_t value = ((uint32_t)(*finger)[0] << 24)
+                   | ((uint32_t)(*finger)[1] << 16)
+                   | ((uint32_t)(*finger)[2] << 8)
+                   | (uint32_t)(*finger)[3];
+  *finger += sizeof(uint32_t);
+  return value;
+}
 
 /**
- * Extract data from the buffer into va_list according to the format
+ * Encode a message length, on 1 or 2 bytes depending on the long message use
  */
-void fetchParams(uint8_t *readPointer, char *format, va_list args);
-
-uint8_t computeCommandLength(uint8_t initialLength, char* formatFinger, char* format, va_list argumentList);
+void cspEncodeLength(uint8_t **finger, uint16_t length);
 
 /**
- * Extract data from the buffer into the argument list according to the format
- * Call fetchParams after initializing a va_list.
- * apiCommandData begins with a command name on 16bits, so fetchParams is called
- * with apiCommandData + 2
+ * Encode a buffer prefixed by its length. The buffer is filled with zeroes if
+ * data is NULL.
  */
-void fetchApiParams(uint8_t *apiCommandData, char *format, ...);
+void cspEncodeBuffer(uint8_t **finger, const uint8_t *data, uint16_t size);
 
 /**
- * Extract data from the buffer into the argument list according to the format
- * Call fetchParams after initializing a va_list
+ * Decode a message length, on 1 or 2 bytes depending on the long message use
  */
-void fetchCallbackParams(uint8_t *callbackParams, char *format, ...);
+uint16_t cspDecodeLength(uint8_t **finger);
 
 /**
- * Format a buffer to be sent through CSP from an argument list according to the format.
- * Fill the buffer according to the format and the given va_list
+ * Decode a buffer prefixed by its length into data, if not NULL. The length
+ * sent by the NCP is clamped to the bytes left before end, the end of the
+ * frame being decoded, and at most capacity bytes are copied. Returns the
+ * number of bytes copied.
  */
-uint16_t formatResponseCommandFromArgList(uint8_t *buffer,
-                                          uint16_t bufferSize,
-                                          uint16_t identifier,
-                                          const char *format,
-                                          va_list argumentList);
+uint16_t cspDecodeBuffer(uint8_t **finger, const uint8_t *end, uint8_t *data, uint16_t capacity);
 
 /**
- * Format a buffer to be sent through CSP from an argument list according to the format.
- * Initialize a va_list from the given format and call formatResponseCommandFromArgList()
+ * Decode a buffer prefixed by its length without copying it: returns a pointer
+ * to the buffer in the frame being decoded and sets length, clamped to the
+ * bytes left before end.
  */
-uint16_t formatResponseCommand(uint8_t *buffer,
-                               uint16_t bufferSize,
-                               uint16_t identifier,
-                               char *format,
-                               ...);
+uint8_t *cspDecodeBufferView(uint8_t **finger, const uint8_t *end, uint16_t *length);
 
 void set_csp_format_long_message_use(bool use_long_messages);
 
@@ -2,69 +2,396 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
 #include <assert.h>
 #include <poll.h>
+#include <sys/eventfd.h>
 #include "log/log.h"
 #include "connect/ncp.h"
 #include "csp/csp-format.h"
 #include "callback-queue.h"
 #include "csp/csp-command-utils.h"
+#include "ncp-host-common.h"
+#include "csp/csp-api-enum-gen.h"
 
-#define MAX_CALLBACK_COMMAND_QUEUE_SIZE 50 //this is set arbitrarily for now
-#define MAX_PIPE_QUEUE_SIZE             MAX_CALLBACK_COMMAND_QUEUE_SIZE * MAX_STACK_API_COMMAND_SIZE
+// A power of two, so that the free running indexes still map to consecutive
+// slots when they wrap
+#define MAX_CALLBACK_COMMAND_QUEUE_SIZE SL_CONNECT_NCP_CALLBACK_QUEUE_SIZE
+#define CALLBACK_QUEUE_MASK             (MAX_CALLBACK_COMMAND_QUEUE_SIZE - 1)
 
-static int pipe_fds[2];
-static struct pollfd poll_fds;
+_Static_assert(MAX_CALLBACK_COMMAND_QUEUE_SIZE > 0 && MAX_CALLBACK_COMMAND_QUEUE_SIZE <= UINT16_MAX
+               && (MAX_CALLBACK_COMMAND_QUEUE_SIZE & CALLBACK_QUEUE_MASK) == 0,
+               "SL_CONNECT_NCP_CALLBACK_QUEUE_SIZE must be a power of two");
 
-void sli_init_callback_queue()
+// Single producer (NCP poll thread) / single consumer (callback thread) ring.
+// head and tail are free running counters, a slot being owned by the consumer
+// from the moment it is published until head moves past it. The eventfd is
+// only used to wake the consumer up when the ring goes from empty to non-empty.
+//
+// The drop oldest and coalesce policies let the producer modify pending slots,
+// so with them both sides update the ring under queue_lock and the consumer
+// handles a copy of the slot instead of handling it in place. The consumer
+// picks the mode from the policy once it sees a slot, so only the producer
+// changes the policy, and only while the ring is empty.
+//
+// With the block policy, a command received while the ring is full is held in
+// an overflow list instead, so that the endpoint reader goes on reading the
+// responses. While commands are held, nothing is appended to the ring but them:
+// whichever of the producer or the consumer sees room moves them in, under
+// overflow_lock. The poll thread then waits for the list to be emptied before
+// reading again, which holds the NCP back as the pipe used to.
+typedef struct CallbackOverflow {
+  struct CallbackOverflow *next;
+  uint16_t length;
+  uint8_t command[];
+} CallbackOverflow;
+
+typedef struct {
+  uint16_t length;
+  uint8_t command[MAX_STACK_CALLBACK_COMMAND_SIZE];
+} CallbackQueueSlot;
+
+typedef struct {
+  CallbackQueueSlot slots[MAX_CALLBACK_COMMAND_QUEUE_SIZE];
+  atomic_uint head;
+  atomic_uint tail;
+  int event_fd;
+  struct pollfd poll_fds;
+
+  atomic_int requested_policy;
+  atomic_int policy;
+  pthread_mutex_t queue_lock;
+  uint8_t consumer_command[MAX_STACK_CALLBACK_COMMAND_SIZE];
+
+  pthread_mutex_t overflow_lock;
+  pthread_cond_t overflow_cond;
+  CallbackOverflow *overflow_head;
+  CallbackOverflow **overflow_tail;
+  atomic_uint overflow_count;
+
+  atomic_uint high_water_mark;
+  atomic_uint dropped;
+  atomic_uint coalesced;
+} CallbackQueue;
+
+static CallbackQueue queues[SL_CONNECT_NCP_MAX_INSTANCES];
+
+// Set once the thread handled the callbacks of an instance: it must never
+// wait for the held commands to be queued, as nobody else would make room
+static __thread bool callback_consumer[SL_CONNECT_NCP_MAX_INSTANCES];
+
+void sli_init_callback_queue(uint8_t instance)
+{
+  CallbackQueue *queue = &queues[instance];
+
+  queue->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (queue->event_fd < 0) {
+    FATAL(1, "Could not initialize callback queue (can't open eventfd)");
+  }
+  pthread_mutex_init(&queue->queue_lock, NULL);
+  pthread_mutex_init(&queue->overflow_lock, NULL);
+  pthread_cond_init(&queue->overflow_cond, NULL);
+  queue->overflow_tail = &queue->overflow_head;
+  atomic_init(&queue->requested_policy, SL_CONNECT_NCP_CALLBACK_QUEUE_BLOCK);
+  atomic_init(&queue->policy, SL_CONNECT_NCP_CALLBACK_QUEUE_BLOCK);
+  queue->poll_fds.fd = queue->event_fd;
+  queue->poll_fds.events = POLLIN;
+}
+
+int sl_connect_ncp_get_callback_fd(void)
+{
+  return queues[sli_connect_ncp_current_instance()].event_fd;
+}
+
+void sl_connect_ncp_set_callback_queue_policy(sl_connect_ncp_callback_queue_policy_t policy)
+{
+  atomic_store(&queues[sli_connect_ncp_current_instance()].requested_policy, policy);
+}
+
+bool sli_callback_queue_is_full(uint8_t instance)
+{
+  CallbackQueue *queue = &queues[instance];
+
+  return atomic_load(&queue->overflow_count) > 0
+         || atomic_load(&queue->tail) - atomic_load(&queue->head) >= MAX_CALLBACK_COMMAND_QUEUE_SIZE;
+}
+
+void sl_connect_ncp_get_callback_queue_stats(sl_connect_ncp_callback_queue_stats_t *stats)
+{
+  CallbackQueue *queue = &queues[sli_connect_ncp_current_instance()];
+
+  stats->capacity = MAX_CALLBACK_COMMAND_QUEUE_SIZE;
+  stats->high_water_mark = atomic_load_explicit(&queue->high_water_mark, memory_order_relaxed);
+  stats->dropped = atomic_load_explicit(&queue->dropped, memory_order_relaxed);
+  stats->coalesced = atomic_load_explicit(&queue->coalesced, memory_order_relaxed);
+}
+
+static bool policy_modifies_pending_slots(sl_connect_ncp_callback_queue_policy_t policy)
+{
+  return policy == SL_CONNECT_NCP_CALLBACK_QUEUE_DROP_OLDEST
+         || policy == SL_CONNECT_NCP_CALLBACK_QUEUE_COALESCE;
+}
+
+// Called by the producer only. While a slot is pending the consumer may be
+// handling it in place, so a new policy waits for the ring to be drained.
+static sl_connect_ncp_callback_queue_policy_t producer_policy(CallbackQueue *queue, unsigned int slot_index)
 {
-  if (pipe(pipe_fds) < 0) {
-    FATAL(1, "Could not initialize callback queue (can't open pipe)");
+  sl_connect_ncp_callback_queue_policy_t policy = atomic_load(&queue->policy);
+  sl_connect_ncp_callback_queue_policy_t requested = atomic_load(&queue->requested_policy);
+
+  if (requested != policy && slot_index == atomic_load(&queue->head)) {
+    atomic_store(&queue->policy, requested);
+    policy = requested;
   }
-  poll_fds.fd = pipe_fds[0];
-  poll_fds.events = POLLIN;
+  return policy;
+}
+
+// Only the callbacks reporting a state can be replaced by a newer one, the
+// others carry data such as incoming messages
+static bool is_state_callback(uint16_t command_id)
+{
+  return command_id == EMBER_STACK_STATUS_HANDLER_IPC_COMMAND_ID
+         || command_id == EMBER_RADIO_NEEDS_CALIBRATING_HANDLER_IPC_COMMAND_ID;
+}
+
+static void signal_fd(int fd)
+{
+  uint64_t wakeup = 1;
+  write(fd, &wakeup, sizeof(wakeup));
+}
+
+// Returns the number of pending commands, this one included
+static unsigned int write_slot(CallbackQueue *queue, unsigned int slot_index,
+                               uint8_t *callback_command, uint16_t command_length)
+{
+  CallbackQueueSlot *slot = &queue->slots[slot_index & CALLBACK_QUEUE_MASK];
+  slot->length = command_length;
+  memcpy(slot->command, callback_command, command_length);
+  atomic_store(&queue->tail, slot_index + 1);
+
+  // Both indexes are sequentially consistent: either the consumer sees the new
+  // tail before going idle, or the producer sees that the ring was drained.
+  return slot_index + 1 - atomic_load(&queue->head);
 }
 
-void sli_connect_ncp_append_callback_command(uint8_t *callback_command, uint16_t command_length)
+static void command_appended(CallbackQueue *queue, unsigned int pending,
+                             uint8_t *callback_command, uint16_t command_length)
 {
-  //add command length at the beginning of the command
-  uint8_t pipe_command[command_length + 2];
-  emberStoreHighLowInt16u(pipe_command, command_length);
-  memcpy(pipe_command + 2, callback_command, command_length);
+  TRACE_FRAME(TR_CB_QUEUE, "Appending CB", callback_command, command_length);
 
-  write(pipe_fds[1], pipe_command, command_length + 2);
+  if (pending > atomic_load_explicit(&queue->high_water_mark, memory_order_relaxed)) {
+    atomic_store_explicit(&queue->high_water_mark, pending, memory_order_relaxed);
+  }
+  if (pending == 1) {
+    signal_fd(queue->event_fd);
+  }
+}
 
-  TRACE(TR_CB_QUEUE, "Appending CB: %s", tr_csp_full(callback_command, command_length));
+static void drop_newest(CallbackQueue *queue, uint8_t *callback_command)
+{
+  atomic_fetch_add_explicit(&queue->dropped, 1, memory_order_relaxed);
+  WARN("Callback queue full, dropping CB: %s", tr_csp_id(emberFetchHighLowInt16u(callback_command)));
+}
+
+// Moves the held commands into the ring as long as there is room. Same
+// handshake as the consumer wakeup: either the consumer sees the held commands
+// after moving head, or the producer sees the new head after holding one.
+static void queue_held_commands(CallbackQueue *queue)
+{
+  pthread_mutex_lock(&queue->overflow_lock);
+  while (queue->overflow_head != NULL) {
+    CallbackOverflow *held = queue->overflow_head;
+    unsigned int slot_index = atomic_load(&queue->tail);
+    if (slot_index - atomic_load(&queue->head) >= MAX_CALLBACK_COMMAND_QUEUE_SIZE) {
+      break;
+    }
+    unsigned int pending = write_slot(queue, slot_index, held->command, held->length);
+    command_appended(queue, pending, held->command, held->length);
+    queue->overflow_head = held->next;
+    if (queue->overflow_head == NULL) {
+      queue->overflow_tail = &queue->overflow_head;
+    }
+    free(held);
+    if (atomic_fetch_sub(&queue->overflow_count, 1) == 1) {
+      pthread_cond_broadcast(&queue->overflow_cond);
+    }
+  }
+  pthread_mutex_unlock(&queue->overflow_lock);
+}
+
+static void hold_command(CallbackQueue *queue, uint8_t *callback_command, uint16_t command_length)
+{
+  CallbackOverflow *held = malloc(sizeof(CallbackOverflow) + command_length);
+
+  if (held == NULL) {
+    drop_newest(queue, callback_command);
+    return;
+  }
+  TRACE(TR_CB_QUEUE, "Callback queue full, holding CB: %s", tr_csp_id(emberFetchHighLowInt16u(callback_command)));
+  held->next = NULL;
+  held->length = command_length;
+  memcpy(held->command, callback_command, command_length);
+  pthread_mutex_lock(&queue->overflow_lock);
+  *queue->overflow_tail = held;
+  queue->overflow_tail = &held->next;
+  atomic_fetch_add(&queue->overflow_count, 1);
+  pthread_mutex_unlock(&queue->overflow_lock);
+  queue_held_commands(queue);
+}
+
+void sli_callback_queue_wait_for_room(uint8_t instance)
+{
+  CallbackQueue *queue = &queues[instance];
+
+  if (callback_consumer[instance] || atomic_load(&queue->overflow_count) == 0) {
+    return;
+  }
+  TRACE(TR_CB_QUEUE, "Callback queue full, waiting");
+  pthread_mutex_lock(&queue->overflow_lock);
+  while (atomic_load(&queue->overflow_count) > 0) {
+    pthread_cond_wait(&queue->overflow_cond, &queue->overflow_lock);
+  }
+  pthread_mutex_unlock(&queue->overflow_lock);
+}
+
+// Returns true if the command has been merged into a pending slot
+static bool coalesce_command(CallbackQueue *queue, uint8_t *callback_command, uint16_t command_length, unsigned int slot_index)
+{
+  uint16_t command_id = emberFetchHighLowInt16u(callback_command);
+
+  if (!is_state_callback(command_id)) {
+    return false;
+  }
+  for (unsigned int i = slot_index; i != atomic_load(&queue->head); i--) {
+    CallbackQueueSlot *slot = &queue->slots[(i - 1) & CALLBACK_QUEUE_MASK];
+    if (emberFetchHighLowInt16u(slot->command) == command_id) {
+      slot->length = command_length;
+      memcpy(slot->command, callback_command, command_length);
+      return true;
+    }
+  }
+  return false;
+}
+
+void sli_connect_ncp_append_callback_command(uint8_t instance, uint8_t *callback_command, uint16_t command_length)
+{
+  CallbackQueue *queue = &queues[instance];
+
+  if (command_length > MAX_STACK_CALLBACK_COMMAND_SIZE) {
+    WARN("Dropping callback command of %d bytes (too long)", command_length);
+    atomic_fetch_add_explicit(&queue->dropped, 1, memory_order_relaxed);
+    return;
+  }
+  // Only the block policy holds commands, and it can't change before they are
+  // queued as the ring is not empty meanwhile
+  if (atomic_load(&queue->overflow_count) > 0) {
+    hold_command(queue, callback_command, command_length);
+    return;
+  }
+
+  unsigned int slot_index = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+  sl_connect_ncp_callback_queue_policy_t policy = producer_policy(queue, slot_index);
+  bool locked = policy_modifies_pending_slots(policy);
+  if (locked) {
+    pthread_mutex_lock(&queue->queue_lock);
+  }
+  if (slot_index - atomic_load_explicit(&queue->head, memory_order_acquire) >= MAX_CALLBACK_COMMAND_QUEUE_SIZE) {
+    switch (policy) {
+      case SL_CONNECT_NCP_CALLBACK_QUEUE_BLOCK:
+        hold_command(queue, callback_command, command_length);
+        return;
+      case SL_CONNECT_NCP_CALLBACK_QUEUE_DROP_OLDEST:
+        atomic_fetch_add(&queue->head, 1);
+        atomic_fetch_add_explicit(&queue->dropped, 1, memory_order_relaxed);
+        break;
+      case SL_CONNECT_NCP_CALLBACK_QUEUE_COALESCE:
+        if (coalesce_command(queue, callback_command, command_length, slot_index)) {
+          pthread_mutex_unlock(&queue->queue_lock);
+          atomic_fetch_add_explicit(&queue->coalesced, 1, memory_order_relaxed);
+          TRACE_FRAME(TR_CB_QUEUE, "Coalescing CB", callback_command, command_length);
+          return;
+        }
+      // fall through
+      default:
+        if (locked) {
+          pthread_mutex_unlock(&queue->queue_lock);
+        }
+        drop_newest(queue, callback_command);
+        return;
+    }
+  }
+
+  unsigned int pending = write_slot(queue, slot_index, callback_command, command_length);
+  if (locked) {
+    pthread_mutex_unlock(&queue->queue_lock);
+  }
+  command_appended(queue, pending, callback_command, command_length);
+}
+
+// Copies the oldest pending command out of the ring, returns its length or 0
+// if the ring is empty
+static uint16_t pop_command_copy(CallbackQueue *queue)
+{
+  uint16_t command_length = 0;
+
+  pthread_mutex_lock(&queue->queue_lock);
+  unsigned int slot_index = atomic_load(&queue->head);
+  if (slot_index != atomic_load(&queue->tail)) {
+    CallbackQueueSlot *slot = &queue->slots[slot_index & CALLBACK_QUEUE_MASK];
+    command_length = slot->length;
+    memcpy(queue->consumer_command, slot->command, command_length);
+    atomic_store(&queue->head, slot_index + 1);
+  }
+  pthread_mutex_unlock(&queue->queue_lock);
+  return command_length;
+}
+
+static void handle_command(uint8_t *command, uint16_t command_length)
+{
+  uint16_t command_id = emberFetchHighLowInt16u(command);
+  TRACE_FRAME(TR_CB_QUEUE, "Handling CB", command, command_length);
+  sli_connect_ncp_handle_indication(command_id, command + 2, command_length - 2);
 }
 
 void sl_connect_ncp_handle_pending_callback_commands()
 {
-  uint8_t pipe_buffer[MAX_PIPE_QUEUE_SIZE];
-  ssize_t bytes_to_read = read(pipe_fds[0], pipe_buffer, MAX_PIPE_QUEUE_SIZE);
-  TRACE(TR_CB_QUEUE, "%d bytes in callback queue", bytes_to_read);
-  uint8_t *finger = pipe_buffer;
-  while (bytes_to_read > 0) {
-    uint16_t command_length = emberFetchHighLowInt16u(finger);
-    //move past the command length indicator
-    finger += sizeof(uint16_t);
-    //execute the callback
-    uint16_t command_id = emberFetchHighLowInt16u(finger);
-    TRACE(TR_CB_QUEUE, "Handling CB: %s", tr_csp_full(finger, command_length));
-    sli_connect_ncp_handle_indication(command_id, finger + 2);
-    //pop the first command from the queue
-    finger += command_length;
-    bytes_to_read += -(command_length + sizeof(uint16_t));
+  CallbackQueue *queue = &queues[sli_connect_ncp_current_instance()];
+  uint64_t wakeups;
+  callback_consumer[sli_connect_ncp_current_instance()] = true;
+  read(queue->event_fd, &wakeups, sizeof(wakeups));
 
-    FATAL_ON(bytes_to_read < 0, 1, "Missing data in callback queue");
+  for (;;) {
+    unsigned int slot_index = atomic_load(&queue->head);
+    if (slot_index == atomic_load(&queue->tail)) {
+      break;
+    }
+    // Read after tail: the policy can't change until head moves past this slot
+    if (policy_modifies_pending_slots(atomic_load(&queue->policy))) {
+      uint16_t command_length = pop_command_copy(queue);
+      if (command_length > 0) {
+        handle_command(queue->consumer_command, command_length);
+      }
+      continue;
+    }
+    CallbackQueueSlot *slot = &queue->slots[slot_index & CALLBACK_QUEUE_MASK];
+    //execute the callback in place, the slot can't be reused before head moves
+    handle_command(slot->command, slot->length);
+    //pop the first command from the queue
+    atomic_store(&queue->head, slot_index + 1);
+    if (atomic_load(&queue->overflow_count) > 0) {
+      queue_held_commands(queue);
+    }
   }
 }
 
 EmberStatus sl_connect_ncp_poll_callback_command(int32_t timeout)
 {
-  int ret = poll(&poll_fds, 1, timeout);
+  struct pollfd *poll_fds = &queues[sli_connect_ncp_current_instance()].poll_fds;
+  int ret = poll(poll_fds, 1, timeout);
 
   if (ret > 0) {
-    if (poll_fds.revents & POLLIN) {
+    if (poll_fds->revents & POLLIN) {
       sl_connect_ncp_handle_pending_callback_commands();
     }
   }
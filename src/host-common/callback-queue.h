@@ -1,7 +1,14 @@
 #ifndef __CALLBACK_QUEUE_H__
 #define __CALLBACK_QUEUE_H__
 
-void sli_init_callback_queue();
-void sli_connect_ncp_append_callback_command(uint8_t *callback_command, uint16_t command_length);
+#include <stdbool.h>
+#include <stdint.h>
+
+void sli_init_callback_queue(uint8_t instance);
+void sli_connect_ncp_append_callback_command(uint8_t instance, uint8_t *callback_command, uint16_t command_length);
+bool sli_callback_queue_is_full(uint8_t instance);
+// Waits until the callbacks held because the queue was full have been queued,
+// unless the calling thread is the one handling them
+void sli_callback_queue_wait_for_room(uint8_t instance);
 
 #endif
@@ -0,0 +1,242 @@
+/***************************************************************************//**
+ * @brief Registry of the runtime subscriptions to the stack callbacks.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "log/log.h"
+#include "connect/ncp-subscriptions.h"
+#include "callback-subscriptions.h"
+
+typedef enum {
+  SUBSCRIPTION_STACK_STATUS,
+  SUBSCRIPTION_INCOMING_MESSAGE,
+  SUBSCRIPTION_MESSAGE_SENT,
+  SUBSCRIPTION_CALLBACK_COUNT
+} SubscriptionCallback;
+
+// One list per endpoint, and a last one for SL_CONNECT_ANY_ENDPOINT
+#define ENDPOINT_LIST_COUNT 257
+#define ANY_ENDPOINT_LIST   256
+
+// Lists are kept in subscription order, tail points to the last next field
+typedef struct {
+  sl_connect_subscription_t *head;
+  sl_connect_subscription_t **tail;
+} SubscriptionList;
+
+struct sl_connect_subscription {
+  union {
+    sl_connect_stack_status_handler_t stack_status;
+    sl_connect_incoming_message_handler_t incoming_message;
+    sl_connect_message_sent_handler_t message_sent;
+  } handler;
+  void *context;
+  // A subscription removed during a dispatch stays linked until the dispatch
+  // is done with it, so that the dispatch can move on to the next one.
+  unsigned int refs;
+  bool removed;
+  SubscriptionList *list;
+  sl_connect_subscription_t *next;
+  sl_connect_subscription_t **pprev;
+};
+
+static SubscriptionList subscriptions[SUBSCRIPTION_CALLBACK_COUNT][ENDPOINT_LIST_COUNT];
+static pthread_mutex_t subscriptions_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static sl_connect_subscription_t *alloc_subscription(uint16_t endpoint, void *context)
+{
+  sl_connect_subscription_t *subscription;
+
+  if (endpoint != SL_CONNECT_ANY_ENDPOINT && endpoint >= ANY_ENDPOINT_LIST) {
+    return NULL;
+  }
+  subscription = calloc(1, sizeof(sl_connect_subscription_t));
+  FATAL_ON(subscription == NULL, 1, "Can't allocate subscription");
+  subscription->context = context;
+  return subscription;
+}
+
+// The handler must be set before the subscription is visible to the dispatch
+static void link_subscription(sl_connect_subscription_t *subscription,
+                              SubscriptionCallback callback,
+                              uint16_t endpoint)
+{
+  SubscriptionList *list;
+
+  if (endpoint == SL_CONNECT_ANY_ENDPOINT) {
+    endpoint = ANY_ENDPOINT_LIST;
+  }
+  list = &subscriptions[callback][endpoint];
+  pthread_mutex_lock(&subscriptions_lock);
+  if (list->tail == NULL) {
+    list->tail = &list->head;
+  }
+  subscription->list = list;
+  subscription->pprev = list->tail;
+  *list->tail = subscription;
+  list->tail = &subscription->next;
+  pthread_mutex_unlock(&subscriptions_lock);
+}
+
+// Must be called with subscriptions_lock held
+static void unlink_subscription(sl_connect_subscription_t *subscription)
+{
+  *subscription->pprev = subscription->next;
+  if (subscription->next != NULL) {
+    subscription->next->pprev = subscription->pprev;
+  } else {
+    subscription->list->tail = subscription->pprev;
+  }
+  free(subscription);
+}
+
+// Calls the handlers of a list. The lock is released around each handler call,
+// a reference keeps the current subscription linked.
+#define DISPATCH(callback, endpoint, handler_field, ...)                           \
+  do {                                                                            \
+    SubscriptionList *list = &subscriptions[callback][endpoint];                 \
+    sl_connect_subscription_t *subscription;                                     \
+                                                                                  \
+    pthread_mutex_lock(&subscriptions_lock);                                     \
+    for (subscription = list->head; subscription != NULL; ) {                    \
+      sl_connect_subscription_t *next;                                           \
+                                                                                  \
+      if (!subscription->removed) {                                              \
+        subscription->refs++;                                                    \
+        pthread_mutex_unlock(&subscriptions_lock);                               \
+        subscription->handler.handler_field(__VA_ARGS__, subscription->context); \
+        pthread_mutex_lock(&subscriptions_lock);                                 \
+        subscription->refs--;                                                    \
+      }                                                                           \
+      next = subscription->next;                                                 \
+      if (subscription->removed && subscription->refs == 0) {                    \
+        unlink_subscription(subscription);                                       \
+      }                                                                           \
+      subscription = next;                                                       \
+    }                                                                             \
+    pthread_mutex_unlock(&subscriptions_lock);                                   \
+  } while (0)
+
+//------------------------------------------------------------------------------
+// Public APIs
+
+sl_connect_subscription_t *sl_connect_subscribe_stack_status(sl_connect_stack_status_handler_t handler,
+                                                             void *context)
+{
+  sl_connect_subscription_t *subscription = alloc_subscription(SL_CONNECT_ANY_ENDPOINT, context);
+
+  subscription->handler.stack_status = handler;
+  link_subscription(subscription, SUBSCRIPTION_STACK_STATUS, SL_CONNECT_ANY_ENDPOINT);
+  return subscription;
+}
+
+sl_connect_subscription_t *sl_connect_subscribe_incoming_message(uint16_t endpoint,
+                                                                 sl_connect_incoming_message_handler_t handler,
+                                                                 void *context)
+{
+  sl_connect_subscription_t *subscription = alloc_subscription(endpoint, context);
+
+  if (subscription != NULL) {
+    subscription->handler.incoming_message = handler;
+    link_subscription(subscription, SUBSCRIPTION_INCOMING_MESSAGE, endpoint);
+  }
+  return subscription;
+}
+
+sl_connect_subscription_t *sl_connect_subscribe_message_sent(uint16_t endpoint,
+                                                             sl_connect_message_sent_handler_t handler,
+                                                             void *context)
+{
+  sl_connect_subscription_t *subscription = alloc_subscription(endpoint, context);
+
+  if (subscription != NULL) {
+    subscription->handler.message_sent = handler;
+    link_subscription(subscription, SUBSCRIPTION_MESSAGE_SENT, endpoint);
+  }
+  return subscription;
+}
+
+void sl_connect_unsubscribe(sl_connect_subscription_t *subscription)
+{
+  if (subscription == NULL) {
+    return;
+  }
+  pthread_mutex_lock(&subscriptions_lock);
+  subscription->removed = true;
+  // Otherwise the last dispatch using the subscription unlinks it
+  if (subscription->refs == 0) {
+    unlink_subscription(subscription);
+  }
+  pthread_mutex_unlock(&subscriptions_lock);
+}
+
+// The payload is stored right after the message
+#define RETAIN_MESSAGE(type, message)                               \
+  do {                                                              \
+    type *copy = malloc(sizeof(type) + (message)->length);          \
+                                                                    \
+    FATAL_ON(copy == NULL, 1, "Can't allocate message");            \
+    *copy = *(message);                                             \
+    copy->payload = (uint8_t *)(copy + 1);                          \
+    memcpy(copy->payload, (message)->payload, (message)->length);   \
+    return copy;                                                    \
+  } while (0)
+
+EmberIncomingMessage *sl_connect_retain_incoming_message(const EmberIncomingMessage *message)
+{
+  RETAIN_MESSAGE(EmberIncomingMessage, message);
+}
+
+EmberOutgoingMessage *sl_connect_retain_outgoing_message(const EmberOutgoingMessage *message)
+{
+  RETAIN_MESSAGE(EmberOutgoingMessage, message);
+}
+
+EmberIncomingMacMessage *sl_connect_retain_incoming_mac_message(const EmberIncomingMacMessage *message)
+{
+  RETAIN_MESSAGE(EmberIncomingMacMessage, message);
+}
+
+EmberOutgoingMacMessage *sl_connect_retain_outgoing_mac_message(const EmberOutgoingMacMessage *message)
+{
+  RETAIN_MESSAGE(EmberOutgoingMacMessage, message);
+}
+
+void sl_connect_release_message(void *message)
+{
+  free(message);
+}
+
+//------------------------------------------------------------------------------
+// Internal APIs
+
+void sli_connect_dispatch_stack_status(EmberStatus status)
+{
+  DISPATCH(SUBSCRIPTION_STACK_STATUS, ANY_ENDPOINT_LIST, stack_status, status);
+}
+
+void sli_connect_dispatch_incoming_message(EmberIncomingMessage *message)
+{
+  DISPATCH(SUBSCRIPTION_INCOMING_MESSAGE, message->endpoint, incoming_message, message);
+  DISPATCH(SUBSCRIPTION_INCOMING_MESSAGE, ANY_ENDPOINT_LIST, incoming_message, message);
+}
+
+void sli_connect_dispatch_message_sent(EmberStatus status, EmberOutgoingMessage *message)
+{
+  DISPATCH(SUBSCRIPTION_MESSAGE_SENT, message->endpoint, message_sent, status, message);
+  DISPATCH(SUBSCRIPTION_MESSAGE_SENT, ANY_ENDPOINT_LIST, message_sent, status, message);
+}
@@ -0,0 +1,26 @@
+/***************************************************************************//**
+ * @brief Dispatch of the stack callbacks to the runtime subscriptions.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef __CALLBACK_SUBSCRIPTIONS_H__
+#define __CALLBACK_SUBSCRIPTIONS_H__
+
+#include "connect/ember.h"
+
+void sli_connect_dispatch_stack_status(EmberStatus status);
+void sli_connect_dispatch_incoming_message(EmberIncomingMessage *message);
+void sli_connect_dispatch_message_sent(EmberStatus status, EmberOutgoingMessage *message);
+
+#endif
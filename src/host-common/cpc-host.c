@@ -19,9 +19,11 @@
 #include <string.h>
 #include <stdlib.h>
 #include <poll.h>
+#include <pthread.h>
 #include <assert.h>
+#include <stdatomic.h>
+#include <time.h>
 #include "log/log.h"
-#include "sl_cpc.h"
 #include "cpc-host.h"
 #include "csp/csp-format.h"
 #include "csp/csp-api-enum-gen.h"
@@ -29,158 +31,321 @@
 #include "connect/byte-utilities.h"
 #include "connect/ncp.h"
 #include "callback-queue.h"
+#include "response-cache.h"
+#include "csp-capture.h"
+#include "ncp-stats.h"
+#include "ncp-restore.h"
+#include "ncp-host-common.h"
 
-static cpc_handle_t lib_handle;
-static cpc_endpoint_t endpoint;
-static volatile bool crash_happened = false;
-static uint8_t responseBuffer[4096]; //CPC read needs a buffer size of 4096
+typedef enum {
+  LINK_UP,
+  // The endpoint is being reopened
+  LINK_RECONNECTING,
+  // The endpoint is open again, only the thread restoring the configuration
+  // of the NCP sends commands
+  LINK_RESTORING,
+  LINK_DOWN,
+} LinkState;
 
-struct pollfd ncp_fds;
-struct pollfd response_fds;
-static int pipe_fds[2];
+typedef struct {
+  sl_connect_ncp_transport_t transport;
+  uint8_t rxBufferStorage[CPC_RX_BUFFER_SIZE];
+  // Responses are handed over to their request along with the buffer they were
+  // read into, the request giving back a free buffer for the next read.
+  uint8_t *responseBuffer;
+  struct pollfd ncp_fds;
+  // Held by the thread reading the endpoint, either the application poll thread
+  // or a thread waiting for a command response.
+  pthread_mutex_t rx_lock;
+  // Changed with linkLock held, so that linkCond waiters do not miss it
+  _Atomic LinkState linkState;
+  pthread_mutex_t linkLock;
+  pthread_cond_t linkCond;
+  uint32_t reconnectTimeoutMs;
+  bool reconnectionThreadRunning;
+  // Serializes the reconnections
+  pthread_mutex_t reconnectLock;
+  // The link state handler is called once no lock is held anymore
+  atomic_bool stateNotification;
+} CpcHostInstance;
 
-static void init_file_descriptor(int fd)
+static CpcHostInstance cpcInstances[SL_CONNECT_NCP_MAX_INSTANCES];
+static sl_connect_ncp_link_state_handler_t linkStateHandler;
+// Set on the thread restoring the configuration of an NCP
+static __thread bool restoringLink;
+
+static void init_file_descriptor(CpcHostInstance *cpc, int fd)
+{
+  cpc->ncp_fds.fd = fd;
+  cpc->ncp_fds.events = POLLIN;
+}
+
+void cpc_host_startup(uint8_t instance, const sl_connect_ncp_transport_t *transport)
 {
-  ncp_fds.fd = fd;
-  ncp_fds.events = POLLIN;
+  CpcHostInstance *cpc = &cpcInstances[instance];
 
-  if (pipe(pipe_fds) < 0) {
-    FATAL(1, "Could not initialize NCP response file descriptor (can't open pipe)");
+  cpc->transport = *transport;
+  int fd = cpc->transport.open(cpc->transport.context);
+  if (fd < 0) {
+    FATAL(1, "Secondary endpoint not opened");
+  }
+
+  cpc->responseBuffer = cpc->rxBufferStorage;
+  memset(cpc->responseBuffer, 0, CPC_RX_BUFFER_SIZE);
+  pthread_mutex_init(&cpc->rx_lock, NULL);
+  pthread_mutex_init(&cpc->linkLock, NULL);
+  pthread_mutex_init(&cpc->reconnectLock, NULL);
+  pthread_condattr_t condAttributes;
+  if (pthread_condattr_init(&condAttributes) != 0
+      || pthread_condattr_setclock(&condAttributes, CLOCK_MONOTONIC) != 0
+      || pthread_cond_init(&cpc->linkCond, &condAttributes) != 0) {
+    FATAL(1, "Condition variable init has failed");
   }
-  response_fds.fd = pipe_fds[0];
-  response_fds.events = POLLIN;
+  pthread_condattr_destroy(&condAttributes);
+  cpc->reconnectTimeoutMs = SL_CONNECT_NCP_RECONNECT_TIMEOUT_MS;
+  // Set the file descriptor and start the ncp message thread
+  init_file_descriptor(cpc, fd);
 }
 
-//The reset callback is called in the context of the USR1 signal handler. Same care must be taken as to what is happening as when writing any other signal handler.
-static void reset_crash_callback(void)
+static void set_link_state(CpcHostInstance *cpc, LinkState state)
 {
-  crash_happened = true;
-  FATAL(1, "Communication with CPC daemon has been severed");
+  pthread_mutex_lock(&cpc->linkLock);
+  atomic_store(&cpc->linkState, state);
+  pthread_cond_broadcast(&cpc->linkCond);
+  pthread_mutex_unlock(&cpc->linkLock);
 }
 
-bool gsdk_version_is_younger_than_v_4_4(void)
+static sl_connect_ncp_link_state_t public_link_state(LinkState state)
 {
-  char undefined_version[10] = "UNDEFINED";
-  char gsdk_message_version[5] = "4.3.";
-  const char* current_gsdk_version = sl_connect_get_ncp_gsdk_version();
-  return ((memcmp(current_gsdk_version, undefined_version, sizeof(undefined_version)) == 0)
-          || (memcmp(current_gsdk_version, gsdk_message_version, sizeof(gsdk_message_version) - 1) == 0));
+  switch (state) {
+    case LINK_UP:
+      return SL_CONNECT_NCP_LINK_UP;
+    case LINK_RECONNECTING:
+    case LINK_RESTORING:
+      return SL_CONNECT_NCP_LINK_RECONNECTING;
+    default:
+      return SL_CONNECT_NCP_LINK_DOWN;
+  }
 }
 
-void cpc_host_startup(void)
+// Must be called without any lock held
+static void notify_link_state(uint8_t instance)
 {
-  int ret;
-  INFO("Trying to init cpc...");
-  do {
-    ret = cpc_init(&lib_handle,
-                   NULL,     //default instance name (cpcd_0)
-                   false,     //no debug traces in stderr
-                   reset_crash_callback);     // user reset_crash_callback. Could be null
-    usleep(100000);
-  } while (ret != 0);
-
-  INFO("CPC initialized on Host");
-
-  int fd = cpc_open_endpoint(lib_handle,
-                             &endpoint,
-                             SL_CPC_ENDPOINT_CONNECT,
-                             1); // transmit window
-
-  if (fd >= 0) {
-    // The endpoint was successfully opened, which means the secondary was ready.
-
-    // We send an initial frame to confirm to the secondary that the host is connected
-    // This message is only needed with GSDK version 4.3.X. Version 4.4.0 introduces the
-    // CPC connection callback that makes this unlock message useless.
-    {
-      if (gsdk_version_is_younger_than_v_4_4()) {
-        uint32_t magic_value = 0xDEADBEEFu;
-        size_t size;
-
-        size = cpc_write_endpoint(endpoint,
-                                  &magic_value,
-                                  sizeof(magic_value),
-                                  0); // No flags
-        (void) size;
-      }
+  CpcHostInstance *cpc = &cpcInstances[instance];
+  sl_connect_ncp_link_state_handler_t handler = linkStateHandler;
 
-      memset(responseBuffer, 0, sizeof(responseBuffer));
-      // Set the file descriptor and start the ncp message thread
-      init_file_descriptor(fd);
-    }
+  atomic_store(&cpc->stateNotification, false);
+  if (handler != NULL) {
+    handler(sli_connect_ncp_instance(instance), public_link_state(atomic_load(&cpc->linkState)));
+  }
+}
+
+void cpc_notify_link_state(uint8_t instance)
+{
+  if (atomic_load(&cpcInstances[instance].stateNotification)) {
+    notify_link_state(instance);
+  }
+}
+
+static void *reconnection_thread(void *arg);
+
+// Can be called with any lock held: the handler is only called by
+// cpc_notify_link_state()
+static void cpc_link_down(uint8_t instance)
+{
+  CpcHostInstance *cpc = &cpcInstances[instance];
+  bool startReconnection = false;
+
+  pthread_mutex_lock(&cpc->linkLock);
+  LinkState state = atomic_load(&cpc->linkState);
+  if (state != LINK_UP && state != LINK_RESTORING) {
+    pthread_mutex_unlock(&cpc->linkLock);
+    return;
+  }
+  if (cpc->reconnectTimeoutMs != 0) {
+    startReconnection = !cpc->reconnectionThreadRunning;
+    cpc->reconnectionThreadRunning = true;
+    state = LINK_RECONNECTING;
   } else {
-    FATAL(1, "Secondary endpoint not opened");
+    state = LINK_DOWN;
+  }
+  atomic_store(&cpc->linkState, state);
+  pthread_cond_broadcast(&cpc->linkCond);
+  pthread_mutex_unlock(&cpc->linkLock);
+
+  WARN("Secondary can not be reached");
+  sli_connect_ncp_fail_pending_requests(instance);
+  sli_connect_ncp_cache_invalidate(instance);
+  atomic_store(&cpc->stateNotification, true);
+
+  if (startReconnection) {
+    pthread_t thread;
+    pthread_attr_t attributes;
+
+    pthread_attr_init(&attributes);
+    pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&thread, &attributes, reconnection_thread, (void *)(uintptr_t)instance) != 0) {
+      WARN("Reconnection thread creation failed");
+      pthread_mutex_lock(&cpc->linkLock);
+      cpc->reconnectionThreadRunning = false;
+      pthread_mutex_unlock(&cpc->linkLock);
+      set_link_state(cpc, LINK_DOWN);
+    }
+    pthread_attr_destroy(&attributes);
   }
 }
 
-int cpc_tx(const void *buf, unsigned int buf_len)
+bool cpc_link_is_up(uint8_t instance)
 {
-  TRACE(TR_CSP_FULL, "CPC TX: %s", tr_csp_full(buf, buf_len));
-  TRACE(TR_CSP_ID, "CPC TX: %s", tr_csp_id(emberFetchHighLowInt16u(buf)));
-  return cpc_write_endpoint(endpoint, buf, buf_len, 0);
+  LinkState state = atomic_load(&cpcInstances[instance].linkState);
+
+  return state == LINK_UP || state == LINK_RESTORING;
 }
 
-int cpc_rx(void *buf, unsigned int buf_len)
+void cpc_wait_link(uint8_t instance)
 {
-  int len = cpc_read_endpoint(endpoint, buf, buf_len, 0);
-  if (!len || len < 0) {
-    FATAL(1, "Secondary can not be reached");
+  CpcHostInstance *cpc = &cpcInstances[instance];
+
+  if (restoringLink || atomic_load(&cpc->linkState) == LINK_UP) {
+    return;
   }
-  return len;
+  pthread_mutex_lock(&cpc->linkLock);
+  while (atomic_load(&cpc->linkState) == LINK_RECONNECTING
+         || atomic_load(&cpc->linkState) == LINK_RESTORING) {
+    pthread_cond_wait(&cpc->linkCond, &cpc->linkLock);
+  }
+  pthread_mutex_unlock(&cpc->linkLock);
 }
 
-uint8_t *wait_for_response(void)
+// Waits up to timeout milliseconds (forever if negative) for the link to leave
+// the given state
+static void wait_link_state_change(CpcHostInstance *cpc, LinkState state, int32_t timeout)
 {
-  uint8_t exp;
-  int ret = poll(&response_fds, 1, 1000);
-  if (ret > 0) {
-    read(pipe_fds[0], &exp, sizeof(uint8_t));
-  } else if (ret == 0) {
-    read(pipe_fds[0], &exp, sizeof(uint8_t));
-    FATAL(1, "NCP response timed out");
-  } else {
-    BUG("Poll failed in wait_for_response, with status: %d", ret);
+  struct timespec deadline;
+
+  sli_connect_ncp_compute_deadline(&deadline, timeout);
+  pthread_mutex_lock(&cpc->linkLock);
+  while (atomic_load(&cpc->linkState) == state) {
+    if (timeout < 0) {
+      pthread_cond_wait(&cpc->linkCond, &cpc->linkLock);
+    } else if (pthread_cond_timedwait(&cpc->linkCond, &cpc->linkLock, &deadline) != 0) {
+      break;
+    }
   }
-  return responseBuffer;
+  pthread_mutex_unlock(&cpc->linkLock);
 }
 
-void sl_connect_ncp_handle_response(void)
+int cpc_tx(uint8_t instance, const void *buf, unsigned int buf_len)
 {
-  uint8_t resp = 0;
-  write(pipe_fds[1], &resp, sizeof(uint8_t));
+  CpcHostInstance *cpc = &cpcInstances[instance];
+
+  TRACE_FRAME(TR_CSP_FULL, "CPC TX", buf, buf_len);
+  TRACE(TR_CSP_ID, "CPC TX: %s", tr_csp_id(emberFetchHighLowInt16u(buf)));
+  sli_connect_capture_frame(instance, SLI_CONNECT_CAPTURE_HOST_TO_NCP, buf, buf_len);
+  sli_connect_ncp_stats_frame_sent(instance, buf_len);
+  int ret = cpc->transport.write(cpc->transport.context, buf, buf_len);
+  if (ret < 0) {
+    cpc_link_down(instance);
+  }
+  return ret;
 }
 
-void sl_connect_ncp_poll_cb(void)
+int cpc_rx(uint8_t instance, void *buf, unsigned int buf_len)
 {
-  uint16_t command_length = cpc_rx(responseBuffer, 4096);
-  uint8_t commandOrigin = responseBuffer[0];
+  CpcHostInstance *cpc = &cpcInstances[instance];
+  int len = cpc->transport.read(cpc->transport.context, buf, buf_len);
+  if (len <= 0) {
+    cpc_link_down(instance);
+    return -1;
+  }
+  return len;
+}
 
-  TRACE(TR_CSP_FULL, "CPC RX: %s", tr_csp_full(responseBuffer, command_length));
-  TRACE(TR_CSP_ID, "CPC RX: %s", tr_csp_id(emberFetchHighLowInt16u(responseBuffer)));
+void sl_connect_ncp_poll_cb(uint8_t instance)
+{
+  CpcHostInstance *cpc = &cpcInstances[instance];
+  int len = cpc_rx(instance, cpc->responseBuffer, CPC_RX_BUFFER_SIZE);
+  if (len < 0) {
+    return;
+  }
+  uint16_t command_length = len;
+  uint8_t commandOrigin = cpc->responseBuffer[0];
+
+  TRACE_FRAME(TR_CSP_FULL, "CPC RX", cpc->responseBuffer, command_length);
+  TRACE(TR_CSP_ID, "CPC RX: %s", tr_csp_id(emberFetchHighLowInt16u(cpc->responseBuffer)));
+  sli_connect_capture_frame(instance, SLI_CONNECT_CAPTURE_NCP_TO_HOST, cpc->responseBuffer, command_length);
+  sli_connect_ncp_stats_frame_received(instance, command_length);
 
   switch (commandOrigin) {
     case (VNCP_CMD_ID & 0xFF00) >> 8:
-      sl_connect_ncp_handle_response();
+      cpc->responseBuffer = sli_connect_ncp_handle_response(instance, cpc->responseBuffer, command_length);
       break;
     case (STACK_CALLBACK_ID & 0xFF00) >> 8:
-      sli_connect_ncp_append_callback_command(responseBuffer, command_length);
+      // Invalidate on reception: the handler may run much later
+      if (emberFetchHighLowInt16u(cpc->responseBuffer) == EMBER_STACK_STATUS_HANDLER_IPC_COMMAND_ID) {
+        sli_connect_ncp_cache_invalidate(instance);
+      }
+      sli_connect_ncp_append_callback_command(instance, cpc->responseBuffer, command_length);
       break;
     default:
-      FATAL(1, "Unknown incoming command type");
+      WARN("Dropping NCP frame of unknown type 0x%02x", commandOrigin);
       break;
   }
 }
 
-EmberStatus sl_connect_poll_ncp_msg(int32_t timeout)
+// Must be called with rx_lock held. Returns -1 while the link is down.
+static int poll_ncp_fd(uint8_t instance, int32_t timeout)
 {
-  int ret = poll(&ncp_fds, 1, timeout);
+  struct pollfd *ncp_fds = &cpcInstances[instance].ncp_fds;
+
+  if (!cpc_link_is_up(instance)) {
+    return -1;
+  }
+  int ret = poll(ncp_fds, 1, timeout);
 
   if (ret > 0) {
-    if (ncp_fds.revents & POLLIN) {
-      sl_connect_ncp_poll_cb();
+    if (ncp_fds->revents & POLLIN) {
+      sl_connect_ncp_poll_cb(instance);
     }
   }
+  return ret;
+}
+
+bool cpc_try_poll(uint8_t instance, int32_t timeout)
+{
+  pthread_mutex_t *rx_lock = &cpcInstances[instance].rx_lock;
+
+  if (pthread_mutex_trylock(rx_lock) != 0) {
+    return false;
+  }
+  poll_ncp_fd(instance, timeout);
+  pthread_mutex_unlock(rx_lock);
+  sli_connect_ncp_poller_released(instance);
+  cpc_notify_link_state(instance);
+  return true;
+}
+
+EmberStatus sl_connect_poll_ncp_msg(int32_t timeout)
+{
+  uint8_t instance = sli_connect_ncp_current_instance();
+  pthread_mutex_t *rx_lock = &cpcInstances[instance].rx_lock;
 
+  pthread_mutex_lock(rx_lock);
+  int ret = poll_ncp_fd(instance, timeout);
+  pthread_mutex_unlock(rx_lock);
+  sli_connect_ncp_poller_released(instance);
+  cpc_notify_link_state(instance);
+  // The threads waiting for a response keep reading the endpoint meanwhile
+  sli_callback_queue_wait_for_room(instance);
+
+  LinkState state = atomic_load(&cpcInstances[instance].linkState);
+  if (state != LINK_UP && state != LINK_RESTORING) {
+    // Do not let polling threads spin until the link is reconnected
+    if (ret < 0) {
+      wait_link_state_change(&cpcInstances[instance], state, timeout);
+    }
+    return EMBER_NCP_NO_RESPONSE;
+  }
   if (ret < 0) {
     return EMBER_ERR_FATAL;
   }
@@ -188,7 +353,174 @@ EmberStatus sl_connect_poll_ncp_msg(int32_t timeout)
   return EMBER_SUCCESS;
 }
 
+int sl_connect_ncp_get_fd(void)
+{
+  return cpcInstances[sli_connect_ncp_current_instance()].ncp_fds.fd;
+}
+
+EmberStatus sl_connect_ncp_process_events(void)
+{
+  uint8_t instance = sli_connect_ncp_current_instance();
+  pthread_mutex_t *rx_lock = &cpcInstances[instance].rx_lock;
+  int ret;
+
+  // The reading stops whenever the callback queue is full, so that this
+  // thread makes room in it instead of dropping callbacks
+  do {
+    pthread_mutex_lock(rx_lock);
+    do {
+      ret = poll_ncp_fd(instance, 0);
+    } while (ret > 0 && !sli_callback_queue_is_full(instance));
+    pthread_mutex_unlock(rx_lock);
+    sli_connect_ncp_poller_released(instance);
+    cpc_notify_link_state(instance);
+
+    // The callbacks received before the link went down are still handled
+    sl_connect_ncp_handle_pending_callback_commands();
+  } while (ret > 0);
+  if (!cpc_link_is_up(instance)) {
+    return EMBER_NCP_NO_RESPONSE;
+  }
+  if (ret < 0) {
+    return EMBER_ERR_FATAL;
+  }
+  return EMBER_SUCCESS;
+}
+
+void sl_connect_ncp_set_link_state_handler(sl_connect_ncp_link_state_handler_t handler)
+{
+  linkStateHandler = handler;
+}
+
+sl_connect_ncp_link_state_t sl_connect_ncp_get_link_state(void)
+{
+  return public_link_state(atomic_load(&cpcInstances[sli_connect_ncp_current_instance()].linkState));
+}
+
+bool sl_connect_ncp_link_is_up(void)
+{
+  return atomic_load(&cpcInstances[sli_connect_ncp_current_instance()].linkState) == LINK_UP;
+}
+
+void sl_connect_ncp_set_auto_reconnect(uint32_t timeout_ms)
+{
+  CpcHostInstance *cpc = &cpcInstances[sli_connect_ncp_current_instance()];
+
+  pthread_mutex_lock(&cpc->linkLock);
+  cpc->reconnectTimeoutMs = timeout_ms;
+  pthread_mutex_unlock(&cpc->linkLock);
+}
+
+// Must be called with reconnectLock held
+static bool reopen_endpoint(uint8_t instance)
+{
+  CpcHostInstance *cpc = &cpcInstances[instance];
+
+  pthread_mutex_lock(&cpc->rx_lock);
+  if (cpc->transport.close != NULL) {
+    cpc->transport.close(cpc->transport.context);
+  }
+  int fd = cpc->transport.open(cpc->transport.context);
+  if (fd < 0) {
+    pthread_mutex_unlock(&cpc->rx_lock);
+    return false;
+  }
+  init_file_descriptor(cpc, fd);
+  // Nothing sent before the reconnection will be answered
+  sli_connect_ncp_fail_pending_requests(instance);
+  sli_connect_ncp_cache_invalidate(instance);
+  set_link_state(cpc, LINK_RESTORING);
+  pthread_mutex_unlock(&cpc->rx_lock);
+  sli_connect_ncp_poller_released(instance);
+  return true;
+}
+
+// Reopens the endpoint and restores the configuration of the NCP. The commands
+// of the other threads are held meanwhile. Unless forced, nothing is done if
+// the link is already up.
+static EmberStatus reconnect(uint8_t instance, bool force)
+{
+  CpcHostInstance *cpc = &cpcInstances[instance];
+  EmberStatus status = EMBER_NCP_NO_RESPONSE;
+
+  pthread_mutex_lock(&cpc->reconnectLock);
+  if (!force && atomic_load(&cpc->linkState) == LINK_UP) {
+    pthread_mutex_unlock(&cpc->reconnectLock);
+    return EMBER_SUCCESS;
+  }
+  if (reopen_endpoint(instance)) {
+    restoringLink = true;
+    status = sli_connect_ncp_restore_apply();
+    restoringLink = false;
+  }
+
+  pthread_mutex_lock(&cpc->linkLock);
+  if (status == EMBER_SUCCESS && atomic_load(&cpc->linkState) == LINK_RESTORING) {
+    atomic_store(&cpc->linkState, LINK_UP);
+  } else {
+    status = EMBER_NCP_NO_RESPONSE;
+    atomic_store(&cpc->linkState, cpc->reconnectionThreadRunning ? LINK_RECONNECTING : LINK_DOWN);
+  }
+  pthread_cond_broadcast(&cpc->linkCond);
+  pthread_mutex_unlock(&cpc->linkLock);
+  pthread_mutex_unlock(&cpc->reconnectLock);
+
+  if (status == EMBER_SUCCESS) {
+    INFO("Secondary endpoint reopened");
+    notify_link_state(instance);
+  }
+  return status;
+}
+
+static void *reconnection_thread(void *arg)
+{
+  uint8_t instance = (uintptr_t)arg;
+  CpcHostInstance *cpc = &cpcInstances[instance];
+  struct timespec start, now;
+
+  sl_connect_ncp_select_instance(sli_connect_ncp_instance(instance));
+  cpc_notify_link_state(instance);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (;;) {
+    bool reconnected = reconnect(instance, false) == EMBER_SUCCESS;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    pthread_mutex_lock(&cpc->linkLock);
+    // The thread keeps running when the link went down again meanwhile
+    if (atomic_load(&cpc->linkState) == LINK_UP) {
+      cpc->reconnectionThreadRunning = false;
+      pthread_mutex_unlock(&cpc->linkLock);
+      return NULL;
+    }
+    if (reconnected) {
+      start = now;
+    }
+    int64_t elapsed = (now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000;
+    if (elapsed >= cpc->reconnectTimeoutMs) {
+      cpc->reconnectionThreadRunning = false;
+      atomic_store(&cpc->linkState, LINK_DOWN);
+      pthread_cond_broadcast(&cpc->linkCond);
+      pthread_mutex_unlock(&cpc->linkLock);
+      WARN("Secondary not reconnected after %d ms", (int)elapsed);
+      notify_link_state(instance);
+      return NULL;
+    }
+    pthread_mutex_unlock(&cpc->linkLock);
+    usleep(SL_CONNECT_NCP_RECONNECT_PERIOD_MS * 1000);
+  }
+}
+
+EmberStatus sl_connect_ncp_reconnect(void)
+{
+  return reconnect(sli_connect_ncp_current_instance(), true);
+}
+
 const char *sl_connect_get_ncp_gsdk_version()
 {
-  return cpc_get_secondary_app_version(lib_handle);
+  CpcHostInstance *cpc = &cpcInstances[sli_connect_ncp_current_instance()];
+
+  if (cpc->transport.get_version == NULL) {
+    return "UNDEFINED";
+  }
+  return cpc->transport.get_version(cpc->transport.context);
 }
@@ -24,12 +24,25 @@ extern "C" {
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "connect/ncp.h"
 
-void cpc_host_startup(void);
-int cpc_tx(const void *buf, unsigned int buf_len);
-int cpc_rx(void *buf, unsigned int buf_len);
-uint8_t *wait_for_response(void);
-bool gsdk_version_is_younger_than_v_4_4(void);
+// CPC read needs a buffer size of 4096
+#define CPC_RX_BUFFER_SIZE 4096
+
+void cpc_host_startup(uint8_t instance, const sl_connect_ncp_transport_t *transport);
+int cpc_tx(uint8_t instance, const void *buf, unsigned int buf_len);
+int cpc_rx(uint8_t instance, void *buf, unsigned int buf_len);
+// Reads the endpoint for up to timeout milliseconds unless another thread is
+// already reading it, returns false in that case.
+bool cpc_try_poll(uint8_t instance, int32_t timeout);
+// False from the first failed read or write until the endpoint is reopened
+bool cpc_link_is_up(uint8_t instance);
+// Blocks while the link is being reconnected, except on the thread restoring
+// the configuration of the NCP.
+void cpc_wait_link(uint8_t instance);
+// Calls the link state handler if the link went down since the last call. Must
+// be called without any lock held.
+void cpc_notify_link_state(uint8_t instance);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,140 @@
+/***************************************************************************//**
+ * @brief Transport to an NCP attached to a CPC daemon
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#include <unistd.h>
+#include <string.h>
+#include <pthread.h>
+#include "log/log.h"
+#include "sl_cpc.h"
+#include "ncp-host-common.h"
+#include "cpc-transport.h"
+
+typedef struct {
+  const char *instance_name;
+  bool initialized;
+  cpc_handle_t lib_handle;
+  cpc_endpoint_t endpoint;
+  sl_connect_ncp_transport_t transport;
+} CpcTransport;
+
+static CpcTransport cpcTransports[SL_CONNECT_NCP_MAX_INSTANCES];
+static uint8_t cpcTransportCount;
+static pthread_mutex_t cpcTransportLock = PTHREAD_MUTEX_INITIALIZER;
+
+static bool gsdk_version_is_younger_than_v_4_4(CpcTransport *cpc)
+{
+  char undefined_version[10] = "UNDEFINED";
+  char gsdk_message_version[5] = "4.3.";
+  const char* current_gsdk_version = cpc_get_secondary_app_version(cpc->lib_handle);
+  return ((memcmp(current_gsdk_version, undefined_version, sizeof(undefined_version)) == 0)
+          || (memcmp(current_gsdk_version, gsdk_message_version, sizeof(gsdk_message_version) - 1) == 0));
+}
+
+static int cpc_transport_open(void *context)
+{
+  CpcTransport *cpc = (CpcTransport *)context;
+  int ret;
+
+  if (cpc->initialized) {
+    // Reconnection: the daemon is expected to be back, do not wait for it
+    INFO("Restarting cpc...");
+    if (cpc_restart(&cpc->lib_handle) != 0) {
+      return -1;
+    }
+  } else {
+    INFO("Trying to init cpc...");
+    do {
+      ret = cpc_init(&cpc->lib_handle,
+                     cpc->instance_name,     //NULL for the default instance name (cpcd_0)
+                     false,     //no debug traces in stderr
+                     NULL);     // no reset callback: the endpoint reads and writes fail after a reset, which reports the link as down
+      usleep(100000);
+    } while (ret != 0);
+    cpc->initialized = true;
+  }
+
+  INFO("CPC initialized on Host");
+
+  int fd = cpc_open_endpoint(cpc->lib_handle,
+                             &cpc->endpoint,
+                             SL_CPC_ENDPOINT_CONNECT,
+                             SL_CONNECT_NCP_CPC_TX_WINDOW_SIZE); // transmit window
+  if (fd < 0 && SL_CONNECT_NCP_CPC_TX_WINDOW_SIZE > 1) {
+    INFO("CPC transmit window of %d refused, falling back to 1", SL_CONNECT_NCP_CPC_TX_WINDOW_SIZE);
+    fd = cpc_open_endpoint(cpc->lib_handle,
+                           &cpc->endpoint,
+                           SL_CPC_ENDPOINT_CONNECT,
+                           1); // transmit window
+  }
+
+  if (fd >= 0) {
+    // The endpoint was successfully opened, which means the secondary was ready.
+
+    // We send an initial frame to confirm to the secondary that the host is connected
+    // This message is only needed with GSDK version 4.3.X. Version 4.4.0 introduces the
+    // CPC connection callback that makes this unlock message useless.
+    if (gsdk_version_is_younger_than_v_4_4(cpc)) {
+      uint32_t magic_value = 0xDEADBEEFu;
+      size_t size;
+
+      size = cpc_write_endpoint(cpc->endpoint,
+                                &magic_value,
+                                sizeof(magic_value),
+                                0); // No flags
+      (void) size;
+    }
+  }
+  return fd;
+}
+
+static int cpc_transport_write(void *context, const void *frame, unsigned int length)
+{
+  return cpc_write_endpoint(((CpcTransport *)context)->endpoint, frame, length, 0);
+}
+
+static int cpc_transport_read(void *context, void *frame, unsigned int capacity)
+{
+  return cpc_read_endpoint(((CpcTransport *)context)->endpoint, frame, capacity, 0);
+}
+
+static void cpc_transport_close(void *context)
+{
+  cpc_close_endpoint(&((CpcTransport *)context)->endpoint);
+}
+
+static const char *cpc_transport_get_version(void *context)
+{
+  return cpc_get_secondary_app_version(((CpcTransport *)context)->lib_handle);
+}
+
+const sl_connect_ncp_transport_t *sli_connect_ncp_cpc_transport(const char *instance_name)
+{
+  pthread_mutex_lock(&cpcTransportLock);
+  if (cpcTransportCount >= SL_CONNECT_NCP_MAX_INSTANCES) {
+    FATAL(1, "Too many CPC daemon instances (%d max)", SL_CONNECT_NCP_MAX_INSTANCES);
+  }
+  CpcTransport *cpc = &cpcTransports[cpcTransportCount++];
+  pthread_mutex_unlock(&cpcTransportLock);
+
+  cpc->instance_name = instance_name;
+  cpc->transport.open = cpc_transport_open;
+  cpc->transport.write = cpc_transport_write;
+  cpc->transport.read = cpc_transport_read;
+  cpc->transport.get_version = cpc_transport_get_version;
+  cpc->transport.context = cpc;
+  cpc->transport.close = cpc_transport_close;
+  return &cpc->transport;
+}
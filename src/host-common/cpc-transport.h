@@ -0,0 +1,33 @@
+/***************************************************************************//**
+ * @brief Transport to an NCP attached to a CPC daemon
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef __CPC_TRANSPORT_H__
+#define __CPC_TRANSPORT_H__
+
+#include "connect/ncp.h"
+
+// Number of frames CPC may have in flight on the endpoint. Daemons that do not
+// support a larger window are opened with a window of 1.
+#ifndef SL_CONNECT_NCP_CPC_TX_WINDOW_SIZE
+#define SL_CONNECT_NCP_CPC_TX_WINDOW_SIZE 4
+#endif
+
+// Returns the transport to the Connect endpoint of the CPC daemon instance of
+// the given name (NULL for cpcd_0). Only available when the library is built
+// with libcpc.
+const sl_connect_ncp_transport_t *sli_connect_ncp_cpc_transport(const char *instance_name);
+
+#endif
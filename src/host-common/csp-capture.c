@@ -0,0 +1,320 @@
+/***************************************************************************//**
+ * @brief pcapng capture of the CSP frames exchanged with the NCPs.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include "log/log.h"
+#include "connect/ncp.h"
+#include "csp-capture.h"
+#include "timer-wheel.h"
+#include "ncp-host-common.h"
+
+// Blocks are written in host byte order, which pcapng readers detect from the
+// byte order magic of the section header.
+#define PCAPNG_SECTION_HEADER_BLOCK   0x0A0D0D0A
+#define PCAPNG_INTERFACE_BLOCK        0x00000001
+#define PCAPNG_ENHANCED_PACKET_BLOCK  0x00000006
+#define PCAPNG_BYTE_ORDER_MAGIC       0x1A2B3C4D
+
+#define PCAPNG_OPT_ENDOFOPT           0
+#define PCAPNG_OPT_SHB_USERAPPL       4
+#define PCAPNG_OPT_IF_NAME            2
+#define PCAPNG_OPT_IF_TSRESOL         9
+#define PCAPNG_OPT_EPB_FLAGS          2
+
+#define PCAPNG_EPB_FLAGS_INBOUND      0x00000001
+#define PCAPNG_EPB_FLAGS_OUTBOUND     0x00000002
+
+// Timestamps are in nanoseconds
+#define CAPTURE_TIMESTAMP_RESOLUTION  9
+
+// Buffered packets are written at least this often, even if no frame follows
+// them, so that a capture of a process that did not exit cleanly is still
+// useful
+#define CAPTURE_FLUSH_INTERVAL_MS     1000
+#define CAPTURE_BUFFER_SIZE           (64 * 1024)
+
+static pthread_mutex_t capture_lock = PTHREAD_MUTEX_INITIALIZER;
+static atomic_bool capturing;
+static bool exit_handler_registered;
+static FILE *capture_file;
+static char *capture_path;
+static uint32_t capture_max_file_size;
+static uint8_t capture_file_count;
+static uint8_t capture_file_index;
+static uint64_t capture_file_size;
+static uint64_t capture_header_size;
+// Packets are timestamped with the monotonic clock, shifted by the wall clock
+// time of the capture start: they never go backwards within a capture.
+static int64_t capture_clock_offset_ns;
+static sli_connect_timer_t capture_flush_timer;
+
+static uint64_t monotonic_ns(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+static uint32_t padded_length(uint32_t length)
+{
+  return (length + 3) & ~3u;
+}
+
+static bool put(const void *data, size_t length)
+{
+  if (length && fwrite(data, 1, length, capture_file) != length) {
+    return false;
+  }
+  capture_file_size += length;
+  return true;
+}
+
+static bool put_u16(uint16_t value)
+{
+  return put(&value, sizeof(value));
+}
+
+static bool put_u32(uint32_t value)
+{
+  return put(&value, sizeof(value));
+}
+
+static bool put_padding(uint32_t length)
+{
+  static const uint8_t zeros[3];
+
+  return put(zeros, padded_length(length) - length);
+}
+
+static bool put_option(uint16_t code, const void *value, uint16_t length)
+{
+  return put_u16(code)
+         && put_u16(length)
+         && put(value, length)
+         && put_padding(length);
+}
+
+static bool put_section_header(void)
+{
+  static const char application[] = "Connect NCP Host library";
+  uint32_t total_length = 28
+                          + 4 + padded_length(sizeof(application) - 1)
+                          + 4;
+  uint64_t section_length = UINT64_MAX;
+
+  return put_u32(PCAPNG_SECTION_HEADER_BLOCK)
+         && put_u32(total_length)
+         && put_u32(PCAPNG_BYTE_ORDER_MAGIC)
+         && put_u16(1)
+         && put_u16(0)
+         && put(&section_length, sizeof(section_length))
+         && put_option(PCAPNG_OPT_SHB_USERAPPL, application, sizeof(application) - 1)
+         && put_option(PCAPNG_OPT_ENDOFOPT, NULL, 0)
+         && put_u32(total_length);
+}
+
+static bool put_interface(uint8_t instance)
+{
+  char name[16];
+  uint8_t resolution = CAPTURE_TIMESTAMP_RESOLUTION;
+  uint16_t name_length = snprintf(name, sizeof(name), "ncp%u", instance);
+  uint32_t total_length = 20
+                          + 4 + padded_length(name_length)
+                          + 4 + padded_length(sizeof(resolution))
+                          + 4;
+
+  return put_u32(PCAPNG_INTERFACE_BLOCK)
+         && put_u32(total_length)
+         && put_u16(SLI_CONNECT_CAPTURE_LINKTYPE)
+         && put_u16(0)
+         && put_u32(0)
+         && put_option(PCAPNG_OPT_IF_NAME, name, name_length)
+         && put_option(PCAPNG_OPT_IF_TSRESOL, &resolution, sizeof(resolution))
+         && put_option(PCAPNG_OPT_ENDOFOPT, NULL, 0)
+         && put_u32(total_length);
+}
+
+static bool put_packet(uint8_t instance, uint8_t direction, const void *frame, unsigned int length)
+{
+  uint64_t timestamp = monotonic_ns() + capture_clock_offset_ns;
+  uint32_t flags = (direction == SLI_CONNECT_CAPTURE_NCP_TO_HOST)
+                   ? PCAPNG_EPB_FLAGS_INBOUND : PCAPNG_EPB_FLAGS_OUTBOUND;
+  uint32_t total_length = 32
+                          + padded_length(1 + length)
+                          + 4 + sizeof(flags)
+                          + 4;
+
+  return put_u32(PCAPNG_ENHANCED_PACKET_BLOCK)
+         && put_u32(total_length)
+         && put_u32(instance)
+         && put_u32(timestamp >> 32)
+         && put_u32(timestamp & 0xFFFFFFFF)
+         && put_u32(1 + length)
+         && put_u32(1 + length)
+         && put(&direction, 1)
+         && put(frame, length)
+         && put_padding(1 + length)
+         && put_option(PCAPNG_OPT_EPB_FLAGS, &flags, sizeof(flags))
+         && put_option(PCAPNG_OPT_ENDOFOPT, NULL, 0)
+         && put_u32(total_length);
+}
+
+// Must be called with capture_lock held
+static bool open_capture_file(void)
+{
+  char path[strlen(capture_path) + sizeof(".255")];
+
+  if (capture_file_count > 1) {
+    snprintf(path, sizeof(path), "%s.%u", capture_path, capture_file_index);
+  } else {
+    strcpy(path, capture_path);
+  }
+  capture_file = fopen(path, "wb");
+  if (capture_file == NULL) {
+    return false;
+  }
+  setvbuf(capture_file, NULL, _IOFBF, CAPTURE_BUFFER_SIZE);
+
+  capture_file_size = 0;
+  bool ok = put_section_header();
+  for (uint8_t instance = 0; ok && instance < SL_CONNECT_NCP_MAX_INSTANCES; instance++) {
+    ok = put_interface(instance);
+  }
+  capture_header_size = capture_file_size;
+  return ok;
+}
+
+// Must be called with capture_lock held
+static void close_capture(void)
+{
+  atomic_store(&capturing, false);
+  sli_connect_timer_stop(&capture_flush_timer);
+  if (capture_file != NULL) {
+    fclose(capture_file);
+    capture_file = NULL;
+  }
+  free(capture_path);
+  capture_path = NULL;
+}
+
+// Must be called with capture_lock held
+static bool rotate_capture_file(void)
+{
+  if (fclose(capture_file) != 0) {
+    capture_file = NULL;
+    return false;
+  }
+  capture_file_index = (capture_file_index + 1) % capture_file_count;
+  return open_capture_file();
+}
+
+void sli_connect_capture_frame(uint8_t instance,
+                               uint8_t direction,
+                               const void *frame,
+                               unsigned int length)
+{
+  if (!atomic_load_explicit(&capturing, memory_order_relaxed)) {
+    return;
+  }
+
+  pthread_mutex_lock(&capture_lock);
+  if (capture_file != NULL) {
+    uint64_t packet_size = 32 + padded_length(1 + length) + 12;
+    bool ok = true;
+
+    if (capture_max_file_size != 0
+        && capture_file_size > capture_header_size
+        && capture_file_size + packet_size > capture_max_file_size) {
+      ok = rotate_capture_file();
+    }
+    ok = ok && put_packet(instance, direction, frame, length);
+    if (!ok) {
+      WARN("CSP capture stopped: %s", strerror(errno));
+      close_capture();
+    }
+  }
+  pthread_mutex_unlock(&capture_lock);
+}
+
+// Called from the timer thread
+static void flush_capture(void *context)
+{
+  (void)context;
+  pthread_mutex_lock(&capture_lock);
+  // The capture may have been stopped while this callback was waiting for
+  // the lock
+  if (capture_file != NULL) {
+    if (fflush(capture_file) == 0) {
+      sli_connect_timer_start(&capture_flush_timer, CAPTURE_FLUSH_INTERVAL_MS);
+    } else {
+      WARN("CSP capture stopped: %s", strerror(errno));
+      close_capture();
+    }
+  }
+  pthread_mutex_unlock(&capture_lock);
+}
+
+EmberStatus sl_connect_ncp_start_capture(const char *path, uint32_t max_file_size, uint8_t file_count)
+{
+  struct timespec now;
+  EmberStatus status = EMBER_SUCCESS;
+
+  if (path == NULL || file_count == 0) {
+    return EMBER_BAD_ARGUMENT;
+  }
+
+  pthread_mutex_lock(&capture_lock);
+  if (capture_file != NULL) {
+    status = EMBER_INVALID_CALL;
+  } else {
+    capture_path = strdup(path);
+    capture_max_file_size = max_file_size;
+    capture_file_count = file_count;
+    capture_file_index = 0;
+    clock_gettime(CLOCK_REALTIME, &now);
+    capture_clock_offset_ns = (int64_t)((uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec) - (int64_t)monotonic_ns();
+    if (capture_path == NULL || !open_capture_file()) {
+      WARN("CSP capture to %s failed: %s", path, strerror(errno));
+      close_capture();
+      status = EMBER_ERR_FATAL;
+    } else {
+      if (!exit_handler_registered) {
+        sli_connect_timer_init(&capture_flush_timer, flush_capture, NULL);
+        atexit(sl_connect_ncp_stop_capture);
+        exit_handler_registered = true;
+      }
+      sli_connect_timer_start(&capture_flush_timer, CAPTURE_FLUSH_INTERVAL_MS);
+      atomic_store(&capturing, true);
+    }
+  }
+  pthread_mutex_unlock(&capture_lock);
+  return status;
+}
+
+void sl_connect_ncp_stop_capture(void)
+{
+  pthread_mutex_lock(&capture_lock);
+  close_capture();
+  pthread_mutex_unlock(&capture_lock);
+}
@@ -0,0 +1,37 @@
+/***************************************************************************//**
+ * @brief pcapng capture of the CSP frames exchanged with the NCPs.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef __CSP_CAPTURE_H__
+#define __CSP_CAPTURE_H__
+
+#include <stdint.h>
+
+// Packets use the first user link type (LINKTYPE_USER0), wtap.USER0 in the
+// generated Wireshark dissector. Each packet is one direction byte followed by
+// the CSP frame as read from or written to the transport. Each instance is a
+// pcapng interface.
+#define SLI_CONNECT_CAPTURE_LINKTYPE     147
+
+#define SLI_CONNECT_CAPTURE_HOST_TO_NCP  0
+#define SLI_CONNECT_CAPTURE_NCP_TO_HOST  1
+
+// Records a frame if a capture is running
+void sli_connect_capture_frame(uint8_t instance,
+                               uint8_t direction,
+                               const void *frame,
+                               unsigned int length);
+
+#endif
@@ -14,14 +14,97 @@
  *
  ******************************************************************************/
 
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "log/log.h"
+#include "connect/ncp.h"
 #include "ncp-host-common.h"
 #include "cpc-host.h"
+#ifdef SL_CONNECT_NCP_CPC_PRESENT
+#include "cpc-transport.h"
+#endif
 #include "callback-queue.h"
+#include "response-cache.h"
+#include "ncp-stats.h"
+#include "ncp-restore.h"
 #include "csp/csp-format.h"
 
+struct sl_connect_ncp_instance {
+  uint8_t index;
+};
+
+static sl_connect_ncp_instance_t instances[SL_CONNECT_NCP_MAX_INSTANCES];
+// Only counts the instances whose initialization completed: an instance is
+// published with a release store once all its modules are ready
+static atomic_uint_fast8_t instanceCount;
+// Serializes the initializations
+static pthread_mutex_t instanceLock = PTHREAD_MUTEX_INITIALIZER;
+static __thread sl_connect_ncp_instance_t *currentInstance;
+
+uint8_t sli_connect_ncp_current_instance(void)
+{
+  return (currentInstance != NULL) ? currentInstance->index : 0;
+}
+
+sl_connect_ncp_instance_t *sli_connect_ncp_instance(uint8_t index)
+{
+  if (index >= atomic_load_explicit(&instanceCount, memory_order_acquire)) {
+    return NULL;
+  }
+  return &instances[index];
+}
+
+uint8_t sli_connect_ncp_instance_index(const sl_connect_ncp_instance_t *instance)
+{
+  return instance->index;
+}
+
+sl_connect_ncp_instance_t *sl_connect_ncp_init_instance_with_transport(const sl_connect_ncp_transport_t *transport)
+{
+  pthread_mutex_lock(&instanceLock);
+  uint8_t index = atomic_load_explicit(&instanceCount, memory_order_relaxed);
+  if (index >= SL_CONNECT_NCP_MAX_INSTANCES) {
+    FATAL(1, "Too many NCP instances (%d max)", SL_CONNECT_NCP_MAX_INSTANCES);
+  }
+  sl_connect_ncp_instance_t *instance = &instances[index];
+  instance->index = index;
+
+  // The initialization steps exit on failure, so the count only moves once
+  // they all succeeded
+  cpc_host_startup(index, transport);
+  commandMutexInit(index);
+  sli_init_callback_queue(index);
+  sli_connect_ncp_cache_init(index);
+  sli_connect_ncp_stats_init(index);
+  sli_connect_ncp_restore_init(index);
+  atomic_store_explicit(&instanceCount, index + 1, memory_order_release);
+  pthread_mutex_unlock(&instanceLock);
+  return instance;
+}
+
+sl_connect_ncp_instance_t *sl_connect_ncp_init_instance(const char *cpcd_instance_name)
+{
+#ifdef SL_CONNECT_NCP_CPC_PRESENT
+  return sl_connect_ncp_init_instance_with_transport(sli_connect_ncp_cpc_transport(cpcd_instance_name));
+#else
+  (void)cpcd_instance_name;
+  FATAL(1, "Library built without CPC support");
+  return NULL;
+#endif
+}
+
 void sl_connect_ncp_init(void)
 {
-  cpc_host_startup();
-  commandMutexInit();
-  sli_init_callback_queue();
+  sl_connect_ncp_init_instance(NULL);
+}
+
+void sl_connect_ncp_select_instance(sl_connect_ncp_instance_t *instance)
+{
+  currentInstance = instance;
+}
+
+sl_connect_ncp_instance_t *sl_connect_ncp_get_current_instance(void)
+{
+  return (currentInstance != NULL) ? currentInstance : &instances[0];
 }
@@ -0,0 +1,73 @@
+/***************************************************************************//**
+ * @brief Runs series of NCP commands with several of them in flight.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include "connect/ncp-async.h"
+#include "ncp-host-common.h"
+
+typedef struct {
+  uint32_t *counters;
+  EmberStatus status;
+} CounterBatch;
+
+// The NCP handles one command per CPC frame, so a batch can not be written at
+// once. It is streamed instead: the next command is sent while the responses
+// to the previous ones are on their way.
+void sl_connect_ncp_run_batch(uint16_t count,
+                              sl_connect_ncp_batch_submit_t submit,
+                              sl_connect_ncp_batch_collect_t collect,
+                              void *context)
+{
+  sl_connect_ncp_request_t *inFlight[SL_CONNECT_NCP_BATCH_WINDOW];
+  uint16_t submitted = 0;
+  uint16_t collected = 0;
+
+  while (collected < count) {
+    while (submitted < count && submitted - collected < SL_CONNECT_NCP_BATCH_WINDOW) {
+      inFlight[submitted % SL_CONNECT_NCP_BATCH_WINDOW] = submit(submitted, context);
+      submitted++;
+    }
+    collect(collected, inFlight[collected % SL_CONNECT_NCP_BATCH_WINDOW], context);
+    collected++;
+  }
+}
+
+static sl_connect_ncp_request_t *submitGetCounter(uint16_t index, void *context)
+{
+  (void)context;
+  return emberGetCounterAsync((EmberCounterType)index);
+}
+
+static void collectGetCounter(uint16_t index, sl_connect_ncp_request_t *request, void *context)
+{
+  CounterBatch *batch = (CounterBatch *)context;
+  EmberStatus status = emberGetCounterResult(request, &batch->counters[index]);
+
+  if (status != EMBER_SUCCESS) {
+    batch->counters[index] = 0;
+    if (batch->status == EMBER_SUCCESS) {
+      batch->status = status;
+    }
+  }
+}
+
+EmberStatus sl_connect_ncp_get_counters(uint32_t counters[EMBER_COUNTER_TYPE_COUNT])
+{
+  CounterBatch batch = { counters, EMBER_SUCCESS };
+
+  sl_connect_ncp_run_batch(EMBER_COUNTER_TYPE_COUNT, submitGetCounter, collectGetCounter, &batch);
+  return batch.status;
+}
@@ -16,44 +16,645 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <errno.h>
 #include <string.h>
 #include <stdlib.h>
+#include <time.h>
 #include <pthread.h>
 #include <assert.h>
+#include <unistd.h>
 #include "log/log.h"
 #include "csp/csp-format.h"
 #include "csp/csp-command-utils.h"
+#include "csp/csp-api-enum-gen.h"
+#include "ncp-host-common.h"
 #include "cpc-host.h"
+#include "ncp-stats.h"
+#include "ncp-restore.h"
+#include "response-cache.h"
 
-static uint8_t apiCommandData[MAX_STACK_API_COMMAND_SIZE];
-static pthread_mutex_t lock;
+struct sl_connect_ncp_request {
+  uint8_t instance;
+  bool inUse;
+  bool complete;
+  // Completed without a response: it timed out or the link went down
+  bool failed;
+  uint16_t responseLength;
+  uint8_t *response;
+  uint16_t commandId;
+  // First send of the command, so that the latency of a retried command
+  // includes its retries, and timeout of the thread that sent it
+  uint64_t sentAtUs;
+  uint32_t responseTimeoutMs;
+  // The response cache is invalidated when the request is queued
+  bool invalidatesCache;
+  // The command is encoded in the request, which keeps it for the retries
+  uint16_t commandLength;
+  uint8_t command[MAX_STACK_API_COMMAND_SIZE];
+};
 
-uint8_t *sendBlockingCommand(uint8_t *apiCommandBuffer, uint16_t length)
+// An entry whose request gave up waiting is kept in the FIFO, abandoned, so
+// that a late response does not complete the next request. While the request
+// is retried, the abandoned entry still refers to it: whichever response comes
+// first completes it.
+//
+// When the NCP accepted the sequence numbers, each frame sent to it ends with
+// the sequence number of its entry, which the NCP appends to the response. Each
+// send of a retried command gets its own number.
+typedef struct {
+  sl_connect_ncp_request_t *request;
+  uint16_t commandId;
+  bool abandoned;
+  bool sequenced;
+  uint8_t sequence;
+} PendingEntry;
+
+typedef struct {
+  // Serializes the writes to the endpoint with the FIFO updates, so that the
+  // FIFO follows the order the NCP receives the commands in
+  pthread_mutex_t txLock;
+
+  // Requests are answered by the NCP in the order they were sent, so the
+  // pending ones are kept in a FIFO and each response completes its head.
+  sl_connect_ncp_request_t requests[SL_CONNECT_NCP_MAX_PENDING_REQUESTS];
+  uint8_t responseBuffers[SL_CONNECT_NCP_MAX_PENDING_REQUESTS][CPC_RX_BUFFER_SIZE];
+  PendingEntry pendingRequests[SL_CONNECT_NCP_MAX_PENDING_REQUESTS];
+  uint8_t pendingHead;
+  uint8_t pendingCount;
+  pthread_mutex_t requestLock;
+  pthread_cond_t requestCond;
+  uint32_t pollerGeneration;
+
+  // Changed with txLock and requestLock held, once the NCP answered every
+  // command sent before the change
+  bool sequenceNumbers;
+  uint8_t nextSequence;
+
+  // Returned instead of a request when the command can not be sent
+  sl_connect_ncp_request_t failedRequest;
+  uint32_t responseTimeoutMs;
+  uint8_t maxRetries;
+  uint32_t retryBackoffMs;
+} CommandInstance;
+
+static CommandInstance commandInstances[SL_CONNECT_NCP_MAX_INSTANCES];
+
+// What the Result functions decode when a request failed: a status of
+// EMBER_NCP_NO_RESPONSE followed by zeroes
+static uint8_t noResponse[CPC_RX_BUFFER_SIZE] = { 0, 0, EMBER_NCP_NO_RESPONSE };
+
+static __thread uint32_t threadResponseTimeoutMs;
+static __thread EmberStatus lastCallStatus;
+
+// Request whose command the thread is encoding, between startCommand() and
+// submitCommand(). NULL if the command will not be sent, in which case it is
+// encoded in discardedCommand.
+static __thread sl_connect_ncp_request_t *encodingRequest;
+static __thread uint8_t discardedCommand[MAX_STACK_API_COMMAND_SIZE];
+
+void sli_connect_ncp_compute_deadline(struct timespec *deadline, int32_t timeout)
+{
+  clock_gettime(CLOCK_MONOTONIC, deadline);
+  deadline->tv_sec += timeout / 1000;
+  deadline->tv_nsec += (timeout % 1000) * 1000000L;
+  if (deadline->tv_nsec >= 1000000000L) {
+    deadline->tv_sec++;
+    deadline->tv_nsec -= 1000000000L;
+  }
+}
+
+static int32_t remainingTime(const struct timespec *deadline)
+{
+  struct timespec now;
+
+  if (deadline == NULL) {
+    return -1;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  int64_t remaining = (deadline->tv_sec - now.tv_sec) * 1000
+                      + (deadline->tv_nsec - now.tv_nsec) / 1000000;
+  return (remaining > 0) ? (int32_t)remaining : 0;
+}
+
+static uint32_t responseTimeout(CommandInstance *command)
+{
+  return (threadResponseTimeoutMs != 0) ? threadResponseTimeoutMs : command->responseTimeoutMs;
+}
+
+// The backoff doubles with each attempt, up to SL_CONNECT_NCP_MAX_RETRY_BACKOFF_MS
+static void sleepBeforeRetry(CommandInstance *command, uint8_t attempt)
+{
+  uint64_t backoffMs = command->retryBackoffMs;
+  struct timespec deadline;
+
+  for (uint8_t i = 0; i < attempt && backoffMs < SL_CONNECT_NCP_MAX_RETRY_BACKOFF_MS; i++) {
+    backoffMs <<= 1;
+  }
+  if (backoffMs > SL_CONNECT_NCP_MAX_RETRY_BACKOFF_MS) {
+    backoffMs = SL_CONNECT_NCP_MAX_RETRY_BACKOFF_MS;
+  }
+  sli_connect_ncp_compute_deadline(&deadline, (int32_t)backoffMs);
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR) {
+  }
+}
+
+// Must be called with requestLock held
+static bool waitRequestCondition(CommandInstance *command, const struct timespec *deadline)
+{
+  if (deadline == NULL) {
+    pthread_cond_wait(&command->requestCond, &command->requestLock);
+    return true;
+  }
+  return pthread_cond_timedwait(&command->requestCond, &command->requestLock, deadline) == 0;
+}
+
+// Returns NULL if no request slot was released in time.
+static sl_connect_ncp_request_t *allocateRequest(CommandInstance *command)
+{
+  struct timespec deadline;
+
+  sli_connect_ncp_compute_deadline(&deadline, responseTimeout(command));
+  pthread_mutex_lock(&command->requestLock);
+  for (;;) {
+    for (uint8_t i = 0; i < SL_CONNECT_NCP_MAX_PENDING_REQUESTS; i++) {
+      sl_connect_ncp_request_t *request = &command->requests[i];
+      if (!request->inUse) {
+        request->inUse = true;
+        request->complete = false;
+        request->failed = false;
+        request->responseLength = 0;
+        request->commandLength = 0;
+        request->invalidatesCache = false;
+        pthread_mutex_unlock(&command->requestLock);
+        return request;
+      }
+    }
+    if (!waitRequestCondition(command, &deadline)) {
+      pthread_mutex_unlock(&command->requestLock);
+      WARN("No NCP request slot released in time");
+      return NULL;
+    }
+  }
+}
+
+// Must be called with requestLock held. Abandoned entries may fill the FIFO
+// until their late responses are received.
+static bool waitQueueRoom(CommandInstance *command)
+{
+  struct timespec deadline;
+
+  sli_connect_ncp_compute_deadline(&deadline, responseTimeout(command));
+  while (command->pendingCount >= SL_CONNECT_NCP_MAX_PENDING_REQUESTS) {
+    if (!waitRequestCondition(command, &deadline)) {
+      WARN("No room released in time in the NCP request FIFO");
+      return false;
+    }
+  }
+  return true;
+}
+
+static PendingEntry *pendingEntry(CommandInstance *command, uint8_t index)
+{
+  return &command->pendingRequests[(command->pendingHead + index) % SL_CONNECT_NCP_MAX_PENDING_REQUESTS];
+}
+
+// Must be called with txLock and requestLock held. Returns the length of the
+// frame to send, sequence number included, or 0 if the FIFO is full.
+static uint16_t queueRequest(CommandInstance *command, sl_connect_ncp_request_t *request)
+{
+  uint16_t frameLength = request->commandLength;
+
+  if (command->pendingCount >= SL_CONNECT_NCP_MAX_PENDING_REQUESTS) {
+    return 0;
+  }
+  PendingEntry *entry = pendingEntry(command, command->pendingCount);
+  entry->request = request;
+  entry->commandId = request->commandId;
+  entry->abandoned = false;
+  entry->sequenced = command->sequenceNumbers;
+  if (entry->sequenced) {
+    entry->sequence = command->nextSequence++;
+    request->command[frameLength++] = entry->sequence;
+  }
+  command->pendingCount++;
+  return frameLength;
+}
+
+// Must be called with requestLock held. The entries keep the request when it
+// is about to be sent again.
+static void abandonRequest(CommandInstance *command, sl_connect_ncp_request_t *request, bool retried)
+{
+  for (uint8_t i = 0; i < command->pendingCount; i++) {
+    PendingEntry *entry = pendingEntry(command, i);
+    if (entry->request == request) {
+      entry->abandoned = true;
+      if (!retried) {
+        entry->request = NULL;
+      }
+    }
+  }
+}
+
+uint8_t *startCommand(uint16_t identifier)
+{
+  uint8_t instance = sli_connect_ncp_current_instance();
+  CommandInstance *command = &commandInstances[instance];
+  uint8_t *finger = discardedCommand;
+
+  // Commands sent while the link is reconnected are held until the
+  // configuration of the NCP is restored
+  cpc_wait_link(instance);
+  encodingRequest = cpc_link_is_up(instance) ? allocateRequest(command) : NULL;
+  if (encodingRequest != NULL) {
+    finger = encodingRequest->command;
+  }
+  cspEncodeUint16(&finger, identifier);
+  return finger;
+}
+
+void invalidateCacheOnSubmit(void)
+{
+  if (encodingRequest != NULL) {
+    encodingRequest->invalidatesCache = true;
+  }
+}
+
+// Returns the request the thread encoded its command in, NULL if the command
+// will not be sent
+static sl_connect_ncp_request_t *takeEncodedRequest(uint8_t *commandEnd)
+{
+  sl_connect_ncp_request_t *request = encodingRequest;
+
+  encodingRequest = NULL;
+  if (request == NULL) {
+    return NULL;
+  }
+  uint16_t length = commandEnd - request->command;
+
+  // sanity check, with room for the sequence number
+  BUG_ON(length >= MAX_STACK_API_COMMAND_SIZE, "Buffer overflow: command length is longer than the command buffer size");
+  request->commandId = emberFetchHighLowInt16u(request->command);
+  request->commandLength = length;
+  return request;
+}
+
+// Must be called with txLock held. The request is queued before being sent so
+// that its response can not be received before the poll thread knows about it.
+static void sendRequest(uint8_t instance, CommandInstance *command, sl_connect_ncp_request_t *request)
+{
+  pthread_mutex_lock(&command->requestLock);
+  if (!cpc_link_is_up(instance) || !waitQueueRoom(command)) {
+    request->complete = true;
+    request->failed = true;
+    pthread_mutex_unlock(&command->requestLock);
+    return;
+  }
+  uint16_t length = queueRequest(command, request);
+  request->sentAtUs = sli_connect_ncp_stats_now_us();
+  request->responseTimeoutMs = responseTimeout(command);
+  // Under requestLock, so that the getters queued before the command read the
+  // previous cache generation
+  if (request->invalidatesCache) {
+    sli_connect_ncp_cache_invalidate(instance);
+  }
+  pthread_mutex_unlock(&command->requestLock);
+
+  sli_connect_ncp_stats_command_sent(instance, request->commandId, length);
+  cpc_tx(instance, request->command, length);
+}
+
+sl_connect_ncp_request_t *submitCommand(uint8_t *commandEnd)
+{
+  uint8_t instance = sli_connect_ncp_current_instance();
+  CommandInstance *command = &commandInstances[instance];
+  sl_connect_ncp_request_t *request = takeEncodedRequest(commandEnd);
+
+  if (request == NULL) {
+    return &command->failedRequest;
+  }
+  pthread_mutex_lock(&command->txLock);
+  sendRequest(instance, command, request);
+  pthread_mutex_unlock(&command->txLock);
+  cpc_notify_link_state(instance);
+  return request;
+}
+
+// Sends the command of a request that timed out again, its previous entry in
+// the FIFO waiting for the late response
+static void resendCommand(CommandInstance *command, sl_connect_ncp_request_t *request)
 {
-  cpc_tx(apiCommandBuffer, length);
-  uint8_t *resp_buffer = wait_for_response();
-  memcpy(apiCommandData, resp_buffer, MAX_STACK_API_COMMAND_SIZE);
-  return apiCommandData;
+  pthread_mutex_lock(&command->txLock);
+  pthread_mutex_lock(&command->requestLock);
+  if (request->complete) {
+    pthread_mutex_unlock(&command->requestLock);
+    pthread_mutex_unlock(&command->txLock);
+    return;
+  }
+  abandonRequest(command, request, true);
+  uint16_t length = queueRequest(command, request);
+  pthread_mutex_unlock(&command->requestLock);
+
+  if (length > 0) {
+    sli_connect_ncp_stats_command_sent(request->instance, request->commandId, length);
+    cpc_tx(request->instance, request->command, length);
+  }
+  pthread_mutex_unlock(&command->txLock);
+  cpc_notify_link_state(request->instance);
 }
 
-void sendCallbackCommand(uint8_t *callbackCommandBuffer, uint16_t commandLength)
+uint8_t *waitForCommandResponse(sl_connect_ncp_request_t *request)
 {
-  cpc_tx(callbackCommandBuffer, commandLength);
+  CommandInstance *command = &commandInstances[request->instance];
+  uint32_t timeout = responseTimeout(command);
+
+  for (uint8_t attempt = 0; !sl_connect_ncp_request_wait(request, timeout); attempt++) {
+    sli_connect_ncp_stats_command_timed_out(request->instance, request->commandId);
+    if (attempt >= command->maxRetries || !cpc_link_is_up(request->instance)) {
+      WARN("NCP response to %s timed out", tr_csp_id(request->commandId));
+      pthread_mutex_lock(&command->requestLock);
+      if (!request->complete) {
+        abandonRequest(command, request, false);
+        request->complete = true;
+        request->failed = true;
+      }
+      pthread_mutex_unlock(&command->requestLock);
+      break;
+    }
+    WARN("NCP response to %s timed out, retrying", tr_csp_id(request->commandId));
+    sleepBeforeRetry(command, attempt);
+    resendCommand(command, request);
+  }
+
+  if (request->failed) {
+    lastCallStatus = EMBER_NCP_NO_RESPONSE;
+    return noResponse + sizeof(uint16_t);
+  }
+  lastCallStatus = EMBER_SUCCESS;
+  // Skip the command identifier
+  return request->response + sizeof(uint16_t);
 }
 
-uint8_t *getApiCommandPointer()
+const uint8_t *commandResponseEnd(sl_connect_ncp_request_t *request)
 {
-  return apiCommandData;
+  if (request->failed) {
+    return noResponse + sizeof(noResponse);
+  }
+  return request->response + request->responseLength;
 }
 
-void acquireCommandMutex(void)
+uint8_t *commandParameters(sl_connect_ncp_request_t *request)
 {
-  pthread_mutex_lock(&lock);
+  return request->command + sizeof(uint16_t);
 }
 
-void releaseCommandMutex(void)
+const uint8_t *commandParametersEnd(sl_connect_ncp_request_t *request)
 {
-  pthread_mutex_unlock(&lock);
+  return request->command + request->commandLength;
+}
+
+void releaseCommandRequest(sl_connect_ncp_request_t *request)
+{
+  CommandInstance *command = &commandInstances[request->instance];
+
+  if (request == &command->failedRequest) {
+    return;
+  }
+  pthread_mutex_lock(&command->requestLock);
+  request->inUse = false;
+  pthread_cond_broadcast(&command->requestCond);
+  pthread_mutex_unlock(&command->requestLock);
+}
+
+// Must be called with requestLock held
+static void dropPendingHead(CommandInstance *command)
+{
+  command->pendingHead = (command->pendingHead + 1) % SL_CONNECT_NCP_MAX_PENDING_REQUESTS;
+  command->pendingCount--;
+}
+
+// Must be called with requestLock held. The NCP answers in order, so a
+// response answers the oldest entry with its command ID, which is moved to the
+// head of the FIFO. The entries sent before it will not get their response:
+// the requests still waiting for them fail, and the responses of the abandoned
+// ones may never come. A response matching no entry is not handed to anyone,
+// its request gave up long ago. With sequence numbers, sequence points to the
+// one of the response, which must match the entry's as well.
+static bool matchResponse(CommandInstance *command, uint16_t commandId, const uint8_t *sequence)
+{
+  uint8_t index;
+
+  for (index = 0; index < command->pendingCount; index++) {
+    PendingEntry *entry = pendingEntry(command, index);
+    if (entry->commandId == commandId
+        && (sequence == NULL || (entry->sequenced && entry->sequence == *sequence))) {
+      break;
+    }
+  }
+  if (index == command->pendingCount) {
+    return false;
+  }
+  for (; index > 0; index--) {
+    PendingEntry *entry = pendingEntry(command, 0);
+    sl_connect_ncp_request_t *request = entry->request;
+    if (request != NULL && !entry->abandoned) {
+      WARN("NCP response to %s lost", tr_csp_id(entry->commandId));
+      abandonRequest(command, request, false);
+      request->complete = true;
+      request->failed = true;
+    }
+    dropPendingHead(command);
+  }
+  return true;
+}
+
+uint8_t *sli_connect_ncp_handle_response(uint8_t instance, uint8_t *buffer, uint16_t length)
+{
+  CommandInstance *command = &commandInstances[instance];
+  uint16_t commandId = emberFetchHighLowInt16u(buffer);
+
+  pthread_mutex_lock(&command->requestLock);
+  // The response ends with the sequence number of its command
+  const uint8_t *sequence = NULL;
+  if (command->sequenceNumbers && length > sizeof(uint16_t)) {
+    length--;
+    sequence = &buffer[length];
+  }
+  if (!matchResponse(command, commandId, sequence)) {
+    pthread_mutex_unlock(&command->requestLock);
+    WARN("Dropping NCP response %s without pending request", tr_csp_id(commandId));
+    return buffer;
+  }
+  sl_connect_ncp_request_t *request = pendingEntry(command, 0)->request;
+  dropPendingHead(command);
+  pthread_cond_broadcast(&command->requestCond);
+
+  if (request == NULL) {
+    pthread_mutex_unlock(&command->requestLock);
+    TRACE(TR_CSP_ID, "Dropping late NCP response: %s", tr_csp_id(commandId));
+    return buffer;
+  }
+
+  // The response is decoded in place: the request takes the received buffer
+  // and gives its previous one back to the reader.
+  uint8_t *freeBuffer = request->response;
+  request->response = buffer;
+  request->responseLength = length;
+  request->complete = true;
+  abandonRequest(command, request, false);
+  uint64_t latencyUs = sli_connect_ncp_stats_now_us() - request->sentAtUs;
+  uint32_t timeoutMs = request->responseTimeoutMs;
+  pthread_mutex_unlock(&command->requestLock);
+
+  sli_connect_ncp_stats_response_received(instance, commandId, length, latencyUs, timeoutMs);
+  return freeBuffer;
+}
+
+void sli_connect_ncp_fail_pending_requests(uint8_t instance)
+{
+  CommandInstance *command = &commandInstances[instance];
+
+  pthread_mutex_lock(&command->requestLock);
+  while (command->pendingCount > 0) {
+    sl_connect_ncp_request_t *request = pendingEntry(command, 0)->request;
+    if (request != NULL) {
+      request->complete = true;
+      request->failed = true;
+    }
+    dropPendingHead(command);
+  }
+  pthread_cond_broadcast(&command->requestCond);
+  pthread_mutex_unlock(&command->requestLock);
+}
+
+bool sl_connect_ncp_request_is_complete(const sl_connect_ncp_request_t *request)
+{
+  CommandInstance *command = &commandInstances[request->instance];
+
+  pthread_mutex_lock(&command->requestLock);
+  bool complete = request->complete;
+  pthread_mutex_unlock(&command->requestLock);
+  return complete;
+}
+
+void sli_connect_ncp_poller_released(uint8_t instance)
+{
+  CommandInstance *command = &commandInstances[instance];
+
+  pthread_mutex_lock(&command->requestLock);
+  command->pollerGeneration++;
+  pthread_cond_broadcast(&command->requestCond);
+  pthread_mutex_unlock(&command->requestLock);
+}
+
+// When nobody else reads the endpoint, as when the library runs in the
+// application event loop, the waiting thread reads it itself. Otherwise it
+// sleeps until its response is received or the reader goes away.
+bool sl_connect_ncp_request_wait(sl_connect_ncp_request_t *request, int32_t timeout)
+{
+  CommandInstance *command = &commandInstances[request->instance];
+  struct timespec deadline;
+  struct timespec *deadlinePointer = NULL;
+
+  if (timeout >= 0) {
+    sli_connect_ncp_compute_deadline(&deadline, timeout);
+    deadlinePointer = &deadline;
+  }
+  pthread_mutex_lock(&command->requestLock);
+  while (!request->complete) {
+    uint32_t generation = command->pollerGeneration;
+    pthread_mutex_unlock(&command->requestLock);
+    bool polled = cpc_try_poll(request->instance, remainingTime(deadlinePointer));
+    pthread_mutex_lock(&command->requestLock);
+    if (!polled && !request->complete && generation == command->pollerGeneration) {
+      if (!waitRequestCondition(command, deadlinePointer)) {
+        break;
+      }
+    } else if (remainingTime(deadlinePointer) == 0) {
+      break;
+    }
+  }
+  bool complete = request->complete;
+  pthread_mutex_unlock(&command->requestLock);
+  return complete;
+}
+
+void sl_connect_ncp_set_response_timeout(uint32_t timeout_ms)
+{
+  CommandInstance *command = &commandInstances[sli_connect_ncp_current_instance()];
+
+  pthread_mutex_lock(&command->requestLock);
+  command->responseTimeoutMs = (timeout_ms != 0) ? timeout_ms : SL_CONNECT_NCP_RESPONSE_TIMEOUT_MS;
+  pthread_mutex_unlock(&command->requestLock);
+}
+
+void sl_connect_ncp_set_thread_response_timeout(uint32_t timeout_ms)
+{
+  threadResponseTimeoutMs = timeout_ms;
+}
+
+void sl_connect_ncp_set_retry_policy(uint8_t max_retries, uint32_t backoff_ms)
+{
+  CommandInstance *command = &commandInstances[sli_connect_ncp_current_instance()];
+
+  pthread_mutex_lock(&command->requestLock);
+  command->maxRetries = max_retries;
+  command->retryBackoffMs = backoff_ms;
+  pthread_mutex_unlock(&command->requestLock);
+}
+
+// The NCP tells the formats apart by the length of this command, so that it is
+// understood whatever the NCP expects, and answers it in the same format. The
+// format changes for the commands sent after it: no other command is sent
+// before its response, so that every response is read in the format of its
+// command. It is not retried, which would take txLock again.
+EmberStatus sl_connect_ncp_set_sequence_numbers(bool enable)
+{
+  uint8_t instance = sli_connect_ncp_current_instance();
+  CommandInstance *command = &commandInstances[instance];
+  EmberStatus status = EMBER_NCP_NO_RESPONSE;
+
+  uint8_t *finger = startCommand(EMBER_NCP_SET_SEQUENCE_NUMBERS_USE_IPC_COMMAND_ID);
+  cspEncodeUint8(&finger, enable);
+  sl_connect_ncp_request_t *request = takeEncodedRequest(finger);
+  if (request == NULL) {
+    lastCallStatus = EMBER_NCP_NO_RESPONSE;
+    return status;
+  }
+
+  pthread_mutex_lock(&command->txLock);
+  sendRequest(instance, command, request);
+  if (!sl_connect_ncp_request_wait(request, responseTimeout(command))) {
+    WARN("NCP response to %s timed out", tr_csp_id(request->commandId));
+  }
+  pthread_mutex_lock(&command->requestLock);
+  if (!request->complete) {
+    abandonRequest(command, request, false);
+    request->complete = true;
+    request->failed = true;
+  }
+  bool failed = request->failed;
+  if (!failed) {
+    uint8_t *response = request->response + sizeof(uint16_t);
+    status = cspDecodeUint8(&response);
+    if (status == EMBER_SUCCESS) {
+      command->sequenceNumbers = enable;
+    }
+  }
+  pthread_mutex_unlock(&command->requestLock);
+  pthread_mutex_unlock(&command->txLock);
+  cpc_notify_link_state(instance);
+
+  lastCallStatus = failed ? EMBER_NCP_NO_RESPONSE : EMBER_SUCCESS;
+  releaseCommandRequest(request);
+  if (status == EMBER_SUCCESS) {
+    sli_connect_ncp_restore_sequence_numbers(enable);
+  }
+  return status;
+}
+
+EmberStatus sl_connect_ncp_get_last_call_status(void)
+{
+  return lastCallStatus;
 }
 
 bool isCurrentTaskStackTask(void)
@@ -61,9 +662,29 @@ bool isCurrentTaskStackTask(void)
   return false;
 }
 
-void commandMutexInit(void)
+void commandMutexInit(uint8_t instance)
 {
-  if (pthread_mutex_init(&lock, NULL) != 0) {
+  CommandInstance *command = &commandInstances[instance];
+  pthread_condattr_t condAttributes;
+
+  if (pthread_mutex_init(&command->txLock, NULL) != 0
+      || pthread_mutex_init(&command->requestLock, NULL) != 0) {
     FATAL(1, "Mutex init has failed");
   }
+  if (pthread_condattr_init(&condAttributes) != 0
+      || pthread_condattr_setclock(&condAttributes, CLOCK_MONOTONIC) != 0
+      || pthread_cond_init(&command->requestCond, &condAttributes) != 0) {
+    FATAL(1, "Condition variable init has failed");
+  }
+  pthread_condattr_destroy(&condAttributes);
+
+  for (uint8_t i = 0; i < SL_CONNECT_NCP_MAX_PENDING_REQUESTS; i++) {
+    command->requests[i].instance = instance;
+    command->requests[i].response = command->responseBuffers[i];
+  }
+  command->failedRequest.instance = instance;
+  command->failedRequest.inUse = true;
+  command->failedRequest.complete = true;
+  command->failedRequest.failed = true;
+  command->responseTimeoutMs = SL_CONNECT_NCP_RESPONSE_TIMEOUT_MS;
 }
@@ -17,6 +17,81 @@
 #ifndef __NCP_HOST_COMMON_H__
 #define __NCP_HOST_COMMON_H__
 
-void commandMutexInit(void);
+#include <stdint.h>
+#include <time.h>
+#include "connect/ncp.h"
+
+// Maximum number of CPC daemon instances a process can drive.
+#ifndef SL_CONNECT_NCP_MAX_INSTANCES
+#define SL_CONNECT_NCP_MAX_INSTANCES 4
+#endif
+
+// Maximum number of commands sent to the NCP whose response has not been
+// consumed yet.
+#ifndef SL_CONNECT_NCP_MAX_PENDING_REQUESTS
+#define SL_CONNECT_NCP_MAX_PENDING_REQUESTS 8
+#endif
+
+// Number of commands sl_connect_ncp_run_batch() keeps in flight. Half of the
+// request slots are left to the other threads so that a batch can always make
+// progress.
+#ifndef SL_CONNECT_NCP_BATCH_WINDOW
+#define SL_CONNECT_NCP_BATCH_WINDOW (SL_CONNECT_NCP_MAX_PENDING_REQUESTS / 2)
+#endif
+
+// Number of callbacks the callback queue of an instance holds, a power of two.
+// Each slot is sized for the longest callback, while the pipe used before held
+// 64 KB whatever their size: raise it for bursts of short callbacks.
+#ifndef SL_CONNECT_NCP_CALLBACK_QUEUE_SIZE
+#define SL_CONNECT_NCP_CALLBACK_QUEUE_SIZE 64
+#endif
+
+// Time the NCP has to answer a command.
+#ifndef SL_CONNECT_NCP_RESPONSE_TIMEOUT_MS
+#define SL_CONNECT_NCP_RESPONSE_TIMEOUT_MS 1000
+#endif
+
+// Upper bound of the delay before a command retry, whatever the backoff and
+// the number of attempts.
+#ifndef SL_CONNECT_NCP_MAX_RETRY_BACKOFF_MS
+#define SL_CONNECT_NCP_MAX_RETRY_BACKOFF_MS 60000
+#endif
+
+// Time during which a link that went down is reopened, 0 to never reopen it
+// automatically, and delay between two attempts.
+#ifndef SL_CONNECT_NCP_RECONNECT_TIMEOUT_MS
+#define SL_CONNECT_NCP_RECONNECT_TIMEOUT_MS 10000
+#endif
+#ifndef SL_CONNECT_NCP_RECONNECT_PERIOD_MS
+#define SL_CONNECT_NCP_RECONNECT_PERIOD_MS 100
+#endif
+
+// Sets deadline to timeout milliseconds from now on the CLOCK_MONOTONIC clock,
+// used by the condition variables of the library.
+void sli_connect_ncp_compute_deadline(struct timespec *deadline, int32_t timeout);
+
+// Index of the instance selected by the calling thread, 0 if none was selected.
+uint8_t sli_connect_ncp_current_instance(void);
+
+// Instance of the given index, NULL if it isn't initialized.
+sl_connect_ncp_instance_t *sli_connect_ncp_instance(uint8_t index);
+
+// Index of the given instance.
+uint8_t sli_connect_ncp_instance_index(const sl_connect_ncp_instance_t *instance);
+
+void commandMutexInit(uint8_t instance);
+
+// Completes the oldest pending request of the instance with a response received
+// from its NCP. The buffer, of CPC_RX_BUFFER_SIZE bytes, is kept by the request
+// and the returned one must be used for the next read.
+uint8_t *sli_connect_ncp_handle_response(uint8_t instance, uint8_t *buffer, uint16_t length);
+
+// Completes all the pending requests of the instance without a response, as
+// the link to its NCP went down.
+void sli_connect_ncp_fail_pending_requests(uint8_t instance);
+
+// Called each time a thread stops reading the endpoint of the instance, so that
+// the threads waiting for a response can take over.
+void sli_connect_ncp_poller_released(uint8_t instance);
 
 #endif
@@ -0,0 +1,178 @@
+/***************************************************************************//**
+ * @brief Configuration of the NCP applied again after a reconnection.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#include <pthread.h>
+#include "log/log.h"
+#include "connect/ncp.h"
+#include "csp/csp-format.h"
+#include "ncp-host-common.h"
+#include "ncp-restore.h"
+
+typedef struct {
+  bool sequenceNumbersSet;
+  bool sequenceNumbers;
+  bool longMessagesSet;
+  bool useLongMessages;
+  bool securityKeySet;
+  EmberKeyData securityKey;
+  bool radioChannelSet;
+  uint16_t radioChannel;
+  bool radioPowerSet;
+  int16_t radioPower;
+  bool macParamsSet;
+  sli_connect_ncp_mac_params_t macParams;
+} NcpSettings;
+
+typedef struct {
+  pthread_mutex_t lock;
+  NcpSettings settings;
+} NcpRestore;
+
+static NcpRestore restores[SL_CONNECT_NCP_MAX_INSTANCES];
+
+void sli_connect_ncp_restore_init(uint8_t instance)
+{
+  pthread_mutex_init(&restores[instance].lock, NULL);
+}
+
+void sli_connect_ncp_restore_sequence_numbers(bool enable)
+{
+  NcpRestore *restore = &restores[sli_connect_ncp_current_instance()];
+
+  pthread_mutex_lock(&restore->lock);
+  restore->settings.sequenceNumbersSet = true;
+  restore->settings.sequenceNumbers = enable;
+  pthread_mutex_unlock(&restore->lock);
+}
+
+void sli_connect_ncp_restore_long_messages(bool useLongMessages)
+{
+  NcpRestore *restore = &restores[sli_connect_ncp_current_instance()];
+
+  pthread_mutex_lock(&restore->lock);
+  restore->settings.longMessagesSet = true;
+  restore->settings.useLongMessages = useLongMessages;
+  pthread_mutex_unlock(&restore->lock);
+}
+
+void sli_connect_ncp_restore_security_key(const EmberKeyData *key)
+{
+  NcpRestore *restore = &restores[sli_connect_ncp_current_instance()];
+
+  pthread_mutex_lock(&restore->lock);
+  restore->settings.securityKeySet = true;
+  restore->settings.securityKey = *key;
+  pthread_mutex_unlock(&restore->lock);
+}
+
+void sli_connect_ncp_restore_radio_channel(uint16_t channel)
+{
+  NcpRestore *restore = &restores[sli_connect_ncp_current_instance()];
+
+  pthread_mutex_lock(&restore->lock);
+  restore->settings.radioChannelSet = true;
+  restore->settings.radioChannel = channel;
+  pthread_mutex_unlock(&restore->lock);
+}
+
+void sli_connect_ncp_restore_radio_power(int16_t power)
+{
+  NcpRestore *restore = &restores[sli_connect_ncp_current_instance()];
+
+  pthread_mutex_lock(&restore->lock);
+  restore->settings.radioPowerSet = true;
+  restore->settings.radioPower = power;
+  pthread_mutex_unlock(&restore->lock);
+}
+
+void sli_connect_ncp_restore_mac_params(const sli_connect_ncp_mac_params_t *params)
+{
+  NcpRestore *restore = &restores[sli_connect_ncp_current_instance()];
+
+  pthread_mutex_lock(&restore->lock);
+  restore->settings.macParamsSet = true;
+  restore->settings.macParams = *params;
+  pthread_mutex_unlock(&restore->lock);
+}
+
+// A setting the NCP refuses is reported but does not prevent the others from
+// being restored
+static bool check_restored(const char *setting, EmberStatus status)
+{
+  if (sl_connect_ncp_get_last_call_status() != EMBER_SUCCESS) {
+    return false;
+  }
+  if (status != EMBER_SUCCESS) {
+    WARN("NCP %s not restored: 0x%02x", setting, status);
+  }
+  return true;
+}
+
+EmberStatus sli_connect_ncp_restore_apply(void)
+{
+  NcpRestore *restore = &restores[sli_connect_ncp_current_instance()];
+  NcpSettings settings;
+
+  pthread_mutex_lock(&restore->lock);
+  settings = restore->settings;
+  pthread_mutex_unlock(&restore->lock);
+
+  // A reset NCP expects no sequence numbers anymore, while the host still sends
+  // them: the NCP accepts this setting in both formats
+  if (settings.sequenceNumbersSet
+      && !check_restored("sequence numbers use", sl_connect_ncp_set_sequence_numbers(settings.sequenceNumbers))) {
+    return EMBER_NCP_NO_RESPONSE;
+  }
+  // The other settings are encoded in the message format of the NCP
+  if (settings.longMessagesSet) {
+    if (!check_restored("long messages use", emberNcpSetLongMessagesUse(settings.useLongMessages))) {
+      return EMBER_NCP_NO_RESPONSE;
+    }
+  } else {
+    bool usingLongMessages = emberUsingLongMessages();
+    if (sl_connect_ncp_get_last_call_status() != EMBER_SUCCESS) {
+      return EMBER_NCP_NO_RESPONSE;
+    }
+    set_csp_format_long_message_use(usingLongMessages);
+  }
+#ifdef SL_CATALOG_CONNECT_AES_SECURITY_PRESENT
+  if (settings.securityKeySet
+      && !check_restored("security key", emberSetSecurityKey(&settings.securityKey))) {
+    return EMBER_NCP_NO_RESPONSE;
+  }
+#endif
+  if (settings.radioChannelSet
+      && !check_restored("radio channel", emberSetRadioChannel(settings.radioChannel))) {
+    return EMBER_NCP_NO_RESPONSE;
+  }
+  if (settings.radioPowerSet
+      && !check_restored("radio power", emberSetRadioPower(settings.radioPower, false))) {
+    return EMBER_NCP_NO_RESPONSE;
+  }
+  if (settings.macParamsSet
+      && !check_restored("MAC parameters", emberSetMacParams(settings.macParams.ccaThreshold,
+                                                             settings.macParams.maxCcaAttempts,
+                                                             settings.macParams.minBackoffExp,
+                                                             settings.macParams.maxBackoffExp,
+                                                             settings.macParams.ccaBackoff,
+                                                             settings.macParams.ccaDuration,
+                                                             settings.macParams.maxRetries,
+                                                             settings.macParams.csmaTimeout,
+                                                             settings.macParams.ackTimeout))) {
+    return EMBER_NCP_NO_RESPONSE;
+  }
+  return EMBER_SUCCESS;
+}
@@ -0,0 +1,53 @@
+/***************************************************************************//**
+ * @brief Configuration of the NCP applied again after a reconnection.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef __NCP_RESTORE_H__
+#define __NCP_RESTORE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "connect/ember-types.h"
+
+typedef struct {
+  int8_t ccaThreshold;
+  uint8_t maxCcaAttempts;
+  uint8_t minBackoffExp;
+  uint8_t maxBackoffExp;
+  uint16_t ccaBackoff;
+  uint16_t ccaDuration;
+  uint8_t maxRetries;
+  uint32_t csmaTimeout;
+  uint16_t ackTimeout;
+} sli_connect_ncp_mac_params_t;
+
+void sli_connect_ncp_restore_init(uint8_t instance);
+
+// Record a setting the NCP of the current instance accepted. The setters
+// record them once the NCP answered, from the parameters of the sent command,
+// so that the asynchronous variants are covered too.
+void sli_connect_ncp_restore_sequence_numbers(bool enable);
+void sli_connect_ncp_restore_long_messages(bool useLongMessages);
+void sli_connect_ncp_restore_security_key(const EmberKeyData *key);
+void sli_connect_ncp_restore_radio_channel(uint16_t channel);
+void sli_connect_ncp_restore_radio_power(int16_t power);
+void sli_connect_ncp_restore_mac_params(const sli_connect_ncp_mac_params_t *params);
+
+// Send the recorded settings to the NCP of the current instance, whose
+// endpoint was just reopened, and follow its message format. Returns
+// EMBER_NCP_NO_RESPONSE if the NCP did not answer.
+EmberStatus sli_connect_ncp_restore_apply(void);
+
+#endif
@@ -0,0 +1,316 @@
+/***************************************************************************//**
+ * @brief Latency and throughput statistics of the commands sent to the NCP.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "log/log.h"
+#include "connect/ncp.h"
+#include "ncp-host-common.h"
+#include "ncp-stats.h"
+
+#define SUB_BUCKET_COUNT  (1u << SLI_CONNECT_NCP_STATS_SUB_BUCKET_BITS)
+#define SUB_BUCKET_HALF   (SUB_BUCKET_COUNT / 2)
+#define MAX_VALUE         ((1ull << SLI_CONNECT_NCP_STATS_MAX_VALUE_BITS) - 1)
+#define BUCKET_COUNT      (SLI_CONNECT_NCP_STATS_MAX_VALUE_BITS - SLI_CONNECT_NCP_STATS_SUB_BUCKET_BITS + 1)
+#define HISTOGRAM_LENGTH  ((BUCKET_COUNT + 1) * SUB_BUCKET_HALF)
+
+// All the commands sent through startCommand() share the VNCP_CMD_ID high byte,
+// so they are indexed by their low byte.
+#define COMMAND_SLOT_COUNT 256
+
+typedef struct {
+  uint16_t command_id;
+  uint32_t responses;
+  uint32_t timeouts;
+  uint32_t slow_responses;
+  uint64_t bytes_sent;
+  uint64_t bytes_received;
+  uint64_t total_latency_us;
+  uint32_t min_latency_us;
+  uint32_t max_latency_us;
+  uint32_t histogram[HISTOGRAM_LENGTH];
+} CommandStats;
+
+typedef struct {
+  pthread_mutex_t lock;
+  // Allocated on the first use of each command ID
+  CommandStats *commands[COMMAND_SLOT_COUNT];
+  atomic_uint_least64_t frames_sent;
+  atomic_uint_least64_t bytes_sent;
+  atomic_uint_least64_t frames_received;
+  atomic_uint_least64_t bytes_received;
+  atomic_uint timeouts;
+} NcpStats;
+
+static NcpStats stats[SL_CONNECT_NCP_MAX_INSTANCES];
+
+//------------------------------------------------------------------------------
+// Histogram
+
+// Values under SUB_BUCKET_COUNT are counted exactly. Each following power of
+// two is split in SUB_BUCKET_HALF equal ranges.
+static unsigned int histogram_index(uint64_t value)
+{
+  if (value > MAX_VALUE) {
+    value = MAX_VALUE;
+  }
+  unsigned int bucket = 64 - __builtin_clzll(value | (SUB_BUCKET_COUNT - 1))
+                        - SLI_CONNECT_NCP_STATS_SUB_BUCKET_BITS;
+  return bucket * SUB_BUCKET_HALF + (unsigned int)(value >> bucket);
+}
+
+// Highest value counted at index
+static uint32_t histogram_value(unsigned int index)
+{
+  unsigned int bucket = (index < SUB_BUCKET_COUNT) ? 0 : index / SUB_BUCKET_HALF - 1;
+  unsigned int sub_bucket = index - bucket * SUB_BUCKET_HALF;
+
+  return ((sub_bucket + 1) << bucket) - 1;
+}
+
+static uint32_t histogram_percentile(const CommandStats *command, double percentile)
+{
+  uint64_t target;
+  uint64_t count = 0;
+
+  if (command->responses == 0) {
+    return 0;
+  }
+  if (percentile > 100.0) {
+    percentile = 100.0;
+  }
+  target = (uint64_t)(percentile * command->responses / 100.0 + 0.5);
+  if (target == 0) {
+    target = 1;
+  }
+  for (unsigned int i = 0; i < HISTOGRAM_LENGTH; i++) {
+    count += command->histogram[i];
+    if (count >= target) {
+      uint32_t value = histogram_value(i);
+      // The exact extremes are known
+      return (value > command->max_latency_us) ? command->max_latency_us : value;
+    }
+  }
+  return command->max_latency_us;
+}
+
+//------------------------------------------------------------------------------
+// Recording
+
+void sli_connect_ncp_stats_init(uint8_t instance)
+{
+  pthread_mutex_init(&stats[instance].lock, NULL);
+}
+
+uint64_t sli_connect_ncp_stats_now_us(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+// Must be called with the lock of the instance held
+static CommandStats *get_command_stats(NcpStats *instance_stats, uint16_t command_id)
+{
+  CommandStats **slot = &instance_stats->commands[command_id & 0xFF];
+
+  if (*slot == NULL) {
+    *slot = calloc(1, sizeof(CommandStats));
+    if (*slot == NULL) {
+      return NULL;
+    }
+    (*slot)->command_id = command_id;
+    (*slot)->min_latency_us = UINT32_MAX;
+  }
+  return *slot;
+}
+
+void sli_connect_ncp_stats_command_sent(uint8_t instance, uint16_t command_id, uint16_t length)
+{
+  NcpStats *instance_stats = &stats[instance];
+
+  pthread_mutex_lock(&instance_stats->lock);
+  CommandStats *command = get_command_stats(instance_stats, command_id);
+  if (command != NULL) {
+    command->bytes_sent += length;
+  }
+  pthread_mutex_unlock(&instance_stats->lock);
+}
+
+void sli_connect_ncp_stats_response_received(uint8_t instance,
+                                             uint16_t command_id,
+                                             uint16_t length,
+                                             uint64_t latency_us,
+                                             uint32_t timeout_ms)
+{
+  NcpStats *instance_stats = &stats[instance];
+  uint32_t latency = (latency_us > MAX_VALUE) ? MAX_VALUE : (uint32_t)latency_us;
+
+  pthread_mutex_lock(&instance_stats->lock);
+  CommandStats *command = get_command_stats(instance_stats, command_id);
+  if (command != NULL) {
+    command->responses++;
+    command->bytes_received += length;
+    command->total_latency_us += latency;
+    if (latency < command->min_latency_us) {
+      command->min_latency_us = latency;
+    }
+    if (latency > command->max_latency_us) {
+      command->max_latency_us = latency;
+    }
+    // The link is degrading well before commands start timing out
+    if (latency_us > timeout_ms * 1000ull / 2) {
+      command->slow_responses++;
+    }
+    command->histogram[histogram_index(latency)]++;
+  }
+  pthread_mutex_unlock(&instance_stats->lock);
+}
+
+void sli_connect_ncp_stats_command_timed_out(uint8_t instance, uint16_t command_id)
+{
+  NcpStats *instance_stats = &stats[instance];
+
+  atomic_fetch_add_explicit(&instance_stats->timeouts, 1, memory_order_relaxed);
+  pthread_mutex_lock(&instance_stats->lock);
+  CommandStats *command = get_command_stats(instance_stats, command_id);
+  if (command != NULL) {
+    command->timeouts++;
+  }
+  pthread_mutex_unlock(&instance_stats->lock);
+}
+
+void sli_connect_ncp_stats_frame_sent(uint8_t instance, unsigned int length)
+{
+  atomic_fetch_add_explicit(&stats[instance].frames_sent, 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&stats[instance].bytes_sent, length, memory_order_relaxed);
+}
+
+void sli_connect_ncp_stats_frame_received(uint8_t instance, unsigned int length)
+{
+  atomic_fetch_add_explicit(&stats[instance].frames_received, 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&stats[instance].bytes_received, length, memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+// Public API
+
+static void fill_command_stats(const CommandStats *command, sl_connect_ncp_command_stats_t *out)
+{
+  out->command_id = command->command_id;
+  out->responses = command->responses;
+  out->timeouts = command->timeouts;
+  out->slow_responses = command->slow_responses;
+  out->bytes_sent = command->bytes_sent;
+  out->bytes_received = command->bytes_received;
+  out->min_us = command->responses ? command->min_latency_us : 0;
+  out->mean_us = command->responses ? (uint32_t)(command->total_latency_us / command->responses) : 0;
+  out->p50_us = histogram_percentile(command, 50.0);
+  out->p90_us = histogram_percentile(command, 90.0);
+  out->p99_us = histogram_percentile(command, 99.0);
+  out->p999_us = histogram_percentile(command, 99.9);
+  out->max_us = command->max_latency_us;
+}
+
+uint16_t sl_connect_ncp_get_command_stats(sl_connect_ncp_command_stats_t *command_stats, uint16_t max_count)
+{
+  NcpStats *instance_stats = &stats[sli_connect_ncp_current_instance()];
+  uint16_t count = 0;
+
+  pthread_mutex_lock(&instance_stats->lock);
+  for (unsigned int i = 0; i < COMMAND_SLOT_COUNT && count < max_count; i++) {
+    if (instance_stats->commands[i] != NULL) {
+      fill_command_stats(instance_stats->commands[i], &command_stats[count++]);
+    }
+  }
+  pthread_mutex_unlock(&instance_stats->lock);
+  return count;
+}
+
+uint32_t sl_connect_ncp_get_command_latency_percentile(uint16_t command_id, double percentile)
+{
+  NcpStats *instance_stats = &stats[sli_connect_ncp_current_instance()];
+  uint32_t latency = 0;
+
+  pthread_mutex_lock(&instance_stats->lock);
+  CommandStats *command = instance_stats->commands[command_id & 0xFF];
+  if (command != NULL && command->command_id == command_id) {
+    latency = histogram_percentile(command, percentile);
+  }
+  pthread_mutex_unlock(&instance_stats->lock);
+  return latency;
+}
+
+void sl_connect_ncp_get_link_stats(sl_connect_ncp_link_stats_t *link_stats)
+{
+  NcpStats *instance_stats = &stats[sli_connect_ncp_current_instance()];
+
+  link_stats->frames_sent = atomic_load_explicit(&instance_stats->frames_sent, memory_order_relaxed);
+  link_stats->bytes_sent = atomic_load_explicit(&instance_stats->bytes_sent, memory_order_relaxed);
+  link_stats->frames_received = atomic_load_explicit(&instance_stats->frames_received, memory_order_relaxed);
+  link_stats->bytes_received = atomic_load_explicit(&instance_stats->bytes_received, memory_order_relaxed);
+  link_stats->timeouts = atomic_load_explicit(&instance_stats->timeouts, memory_order_relaxed);
+}
+
+void sl_connect_ncp_reset_stats(void)
+{
+  NcpStats *instance_stats = &stats[sli_connect_ncp_current_instance()];
+
+  pthread_mutex_lock(&instance_stats->lock);
+  for (unsigned int i = 0; i < COMMAND_SLOT_COUNT; i++) {
+    free(instance_stats->commands[i]);
+    instance_stats->commands[i] = NULL;
+  }
+  atomic_store(&instance_stats->frames_sent, 0);
+  atomic_store(&instance_stats->bytes_sent, 0);
+  atomic_store(&instance_stats->frames_received, 0);
+  atomic_store(&instance_stats->bytes_received, 0);
+  atomic_store(&instance_stats->timeouts, 0);
+  pthread_mutex_unlock(&instance_stats->lock);
+}
+
+void sl_connect_ncp_dump_stats(FILE *stream)
+{
+  NcpStats *instance_stats = &stats[sli_connect_ncp_current_instance()];
+  sl_connect_ncp_link_stats_t link_stats;
+  sl_connect_ncp_command_stats_t command;
+
+  sl_connect_ncp_get_link_stats(&link_stats);
+  fprintf(stream, "link: %ju frames / %ju bytes sent, %ju frames / %ju bytes received, %u timeouts\n",
+          (uintmax_t)link_stats.frames_sent, (uintmax_t)link_stats.bytes_sent,
+          (uintmax_t)link_stats.frames_received, (uintmax_t)link_stats.bytes_received,
+          link_stats.timeouts);
+  fprintf(stream, "%-6s %8s %8s %6s %8s %8s %8s %8s %8s %8s %8s %10s %10s\n",
+          "cmd", "count", "timeout", "slow", "min_us", "mean_us", "p50_us", "p90_us", "p99_us", "p999_us", "max_us",
+          "tx_bytes", "rx_bytes");
+
+  pthread_mutex_lock(&instance_stats->lock);
+  for (unsigned int i = 0; i < COMMAND_SLOT_COUNT; i++) {
+    if (instance_stats->commands[i] == NULL) {
+      continue;
+    }
+    fill_command_stats(instance_stats->commands[i], &command);
+    fprintf(stream, "0x%04X %8u %8u %6u %8u %8u %8u %8u %8u %8u %8u %10ju %10ju\n",
+            command.command_id, command.responses, command.timeouts, command.slow_responses,
+            command.min_us, command.mean_us, command.p50_us, command.p90_us, command.p99_us, command.p999_us,
+            command.max_us, (uintmax_t)command.bytes_sent, (uintmax_t)command.bytes_received);
+  }
+  pthread_mutex_unlock(&instance_stats->lock);
+}
@@ -0,0 +1,46 @@
+/***************************************************************************//**
+ * @brief Latency and throughput statistics of the commands sent to the NCP.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef __NCP_STATS_H__
+#define __NCP_STATS_H__
+
+#include <stdint.h>
+
+// Latencies are recorded in microseconds in a log-linear histogram. Each power
+// of two is split in 64 equal ranges, whose width is at most 1/64 (about 1.6%)
+// of the values they count.
+// Latencies over 2^25 us (about 33 s) are recorded as 2^25 - 1 us.
+#define SLI_CONNECT_NCP_STATS_SUB_BUCKET_BITS    7
+#define SLI_CONNECT_NCP_STATS_MAX_VALUE_BITS     25
+
+void sli_connect_ncp_stats_init(uint8_t instance);
+
+// Monotonic time in microseconds, used to timestamp the requests
+uint64_t sli_connect_ncp_stats_now_us(void);
+
+void sli_connect_ncp_stats_command_sent(uint8_t instance, uint16_t command_id, uint16_t length);
+void sli_connect_ncp_stats_response_received(uint8_t instance,
+                                             uint16_t command_id,
+                                             uint16_t length,
+                                             uint64_t latency_us,
+                                             uint32_t timeout_ms);
+void sli_connect_ncp_stats_command_timed_out(uint8_t instance, uint16_t command_id);
+
+// Every frame written to or read from the transport, callbacks included
+void sli_connect_ncp_stats_frame_sent(uint8_t instance, unsigned int length);
+void sli_connect_ncp_stats_frame_received(uint8_t instance, unsigned int length);
+
+#endif
@@ -0,0 +1,103 @@
+/***************************************************************************//**
+ * @brief Host side cache of NCP responses that rarely change.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#include <pthread.h>
+#include <string.h>
+#include "log/log.h"
+#include "connect/ncp.h"
+#include "ncp-host-common.h"
+#include "response-cache.h"
+
+typedef struct {
+  bool valid;
+  uint8_t value[SLI_CONNECT_NCP_CACHE_VALUE_SIZE];
+} CacheEntry;
+
+typedef struct {
+  pthread_mutex_t lock;
+  bool enabled;
+  uint32_t generation;
+  CacheEntry entries[SLI_CONNECT_NCP_CACHE_ENTRY_COUNT];
+} ResponseCache;
+
+static ResponseCache caches[SL_CONNECT_NCP_MAX_INSTANCES];
+
+void sli_connect_ncp_cache_init(uint8_t instance)
+{
+  pthread_mutex_init(&caches[instance].lock, NULL);
+}
+
+void sl_connect_ncp_set_response_cache(bool enable)
+{
+  ResponseCache *cache = &caches[sli_connect_ncp_current_instance()];
+
+  pthread_mutex_lock(&cache->lock);
+  cache->enabled = enable;
+  cache->generation++;
+  memset(cache->entries, 0, sizeof(cache->entries));
+  pthread_mutex_unlock(&cache->lock);
+}
+
+bool sli_connect_ncp_cache_read(sli_connect_ncp_cache_entry_t entry,
+                                void *value,
+                                uint8_t size,
+                                uint32_t *generation)
+{
+  ResponseCache *cache = &caches[sli_connect_ncp_current_instance()];
+  bool hit;
+
+  BUG_ON(size > SLI_CONNECT_NCP_CACHE_VALUE_SIZE);
+  pthread_mutex_lock(&cache->lock);
+  hit = cache->enabled && cache->entries[entry].valid;
+  if (hit) {
+    memcpy(value, cache->entries[entry].value, size);
+  }
+  *generation = cache->generation;
+  pthread_mutex_unlock(&cache->lock);
+  return hit;
+}
+
+void sli_connect_ncp_cache_write(sli_connect_ncp_cache_entry_t entry,
+                                 const void *value,
+                                 uint8_t size,
+                                 uint32_t generation)
+{
+  ResponseCache *cache = &caches[sli_connect_ncp_current_instance()];
+
+  BUG_ON(size > SLI_CONNECT_NCP_CACHE_VALUE_SIZE);
+  // The NCP did not answer, value is not a response
+  if (sl_connect_ncp_get_last_call_status() != EMBER_SUCCESS) {
+    return;
+  }
+  pthread_mutex_lock(&cache->lock);
+  if (cache->enabled && cache->generation == generation) {
+    memcpy(cache->entries[entry].value, value, size);
+    cache->entries[entry].valid = true;
+  }
+  pthread_mutex_unlock(&cache->lock);
+}
+
+void sli_connect_ncp_cache_invalidate(uint8_t instance)
+{
+  ResponseCache *cache = &caches[instance];
+
+  pthread_mutex_lock(&cache->lock);
+  cache->generation++;
+  if (cache->enabled) {
+    memset(cache->entries, 0, sizeof(cache->entries));
+  }
+  pthread_mutex_unlock(&cache->lock);
+}
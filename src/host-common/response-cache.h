@@ -0,0 +1,74 @@
+/***************************************************************************//**
+ * @brief Host side cache of NCP responses that rarely change.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef __RESPONSE_CACHE_H__
+#define __RESPONSE_CACHE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Largest cached value: the three version numbers of emberGetVersionInfo()
+#define SLI_CONNECT_NCP_CACHE_VALUE_SIZE 8
+
+// emberGetMaximumPayloadLength() gets one entry per combination of its
+// arguments: two bits per address mode, one bit for interpan and secured.
+#define SLI_CONNECT_NCP_CACHE_PAYLOAD_LENGTH_ENTRIES 64
+
+typedef enum {
+  SLI_CONNECT_NCP_CACHE_EUI64,
+  SLI_CONNECT_NCP_CACHE_NODE_ID,
+  SLI_CONNECT_NCP_CACHE_PAN_ID,
+  SLI_CONNECT_NCP_CACHE_NODE_TYPE,
+  SLI_CONNECT_NCP_CACHE_DEFAULT_CHANNEL,
+  SLI_CONNECT_NCP_CACHE_VERSION_INFO,
+  SLI_CONNECT_NCP_CACHE_MAXIMUM_PAYLOAD_LENGTH,
+  SLI_CONNECT_NCP_CACHE_ENTRY_COUNT = SLI_CONNECT_NCP_CACHE_MAXIMUM_PAYLOAD_LENGTH
+                                      + SLI_CONNECT_NCP_CACHE_PAYLOAD_LENGTH_ENTRIES
+} sli_connect_ncp_cache_entry_t;
+
+static inline sli_connect_ncp_cache_entry_t sli_connect_ncp_cache_payload_length_entry(uint8_t srcAddressMode,
+                                                                                       uint8_t dstAddressMode,
+                                                                                       bool interpan,
+                                                                                       bool secured)
+{
+  return (sli_connect_ncp_cache_entry_t)(SLI_CONNECT_NCP_CACHE_MAXIMUM_PAYLOAD_LENGTH
+                                         + (((srcAddressMode & 0x03) << 4)
+                                            | ((dstAddressMode & 0x03) << 2)
+                                            | (interpan << 1)
+                                            | secured));
+}
+
+void sli_connect_ncp_cache_init(uint8_t instance);
+
+// Copy a valid entry of the current instance to value. Whether or not the
+// entry is valid, *generation is set to the value sli_connect_ncp_cache_write()
+// expects once the NCP answered.
+bool sli_connect_ncp_cache_read(sli_connect_ncp_cache_entry_t entry,
+                                void *value,
+                                uint8_t size,
+                                uint32_t *generation);
+
+// Store an answer of the NCP. It is dropped if the cache was invalidated since
+// the sli_connect_ncp_cache_read() that returned generation, as the answer may
+// predate the change.
+void sli_connect_ncp_cache_write(sli_connect_ncp_cache_entry_t entry,
+                                 const void *value,
+                                 uint8_t size,
+                                 uint32_t generation);
+
+void sli_connect_ncp_cache_invalidate(uint8_t instance);
+
+#endif
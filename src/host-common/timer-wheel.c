@@ -0,0 +1,275 @@
+/***************************************************************************//**
+ * @brief Hierarchical timer wheel serving all the timers of the library.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/timerfd.h>
+#include "log/log.h"
+#include "timer-wheel.h"
+
+// One tick per millisecond. A timer is stored in the lowest level whose slots
+// span its expiration time, and moves down a level each time the wheel enters
+// the slot of the upper level. 5 levels of 256 slots cover 2^40 ms (34 years)
+// of uptime, so no timer ever needs to be stored outside of the wheel.
+#define TIMER_WHEEL_LEVELS    5
+#define TIMER_WHEEL_SLOT_BITS 8
+#define TIMER_WHEEL_SLOTS     (1 << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_WHEEL_SLOT_MASK (TIMER_WHEEL_SLOTS - 1)
+
+#define levelShift(level)    ((level) * TIMER_WHEEL_SLOT_BITS)
+#define levelSlot(tick, level) (((tick) >> levelShift(level)) & TIMER_WHEEL_SLOT_MASK)
+
+#define NO_TICK UINT64_MAX
+
+typedef struct {
+  pthread_mutex_t lock;
+  int timer_fd;
+  // CLOCK_MONOTONIC time of tick 0, in ms
+  uint64_t startMs;
+  // Ticks before currentTick are processed
+  uint64_t currentTick;
+  // Tick for which timer_fd is armed
+  uint64_t armedTick;
+  sli_connect_timer_t *slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+  // Expired timers whose callback is not called yet
+  sli_connect_timer_t *expired;
+} TimerWheel;
+
+static TimerWheel wheel = {
+  .lock = PTHREAD_MUTEX_INITIALIZER,
+  .timer_fd = -1,
+};
+static pthread_once_t wheelOnce = PTHREAD_ONCE_INIT;
+
+static uint64_t monotonicTimeMs(void)
+{
+  struct timespec spec;
+
+  clock_gettime(CLOCK_MONOTONIC, &spec);
+  return (uint64_t)spec.tv_sec * 1000 + spec.tv_nsec / 1000000;
+}
+
+static void linkTimer(sli_connect_timer_t **list, sli_connect_timer_t *timer)
+{
+  timer->next = *list;
+  if (timer->next != NULL) {
+    timer->next->pprev = &timer->next;
+  }
+  timer->pprev = list;
+  *list = timer;
+}
+
+static void unlinkTimer(sli_connect_timer_t *timer)
+{
+  *timer->pprev = timer->next;
+  if (timer->next != NULL) {
+    timer->next->pprev = timer->pprev;
+  }
+  timer->next = NULL;
+  timer->pprev = NULL;
+}
+
+// Must be called with wheel.lock held
+static void insertTimer(sli_connect_timer_t *timer)
+{
+  uint8_t level;
+
+  // Already expired, no need to wait for the next tick
+  if (timer->expire_tick < wheel.currentTick) {
+    linkTimer(&wheel.expired, timer);
+    return;
+  }
+  for (level = 0; level < TIMER_WHEEL_LEVELS - 1; level++) {
+    if ((timer->expire_tick >> levelShift(level + 1)) == (wheel.currentTick >> levelShift(level + 1))) {
+      break;
+    }
+  }
+  linkTimer(&wheel.slots[level][levelSlot(timer->expire_tick, level)], timer);
+}
+
+// Must be called with wheel.lock held. Returns the first tick at which a timer
+// expires or moves down a level. The upper levels only hold timers expiring
+// after all the timers of the lower levels.
+static uint64_t nextEventTick(void)
+{
+  for (uint8_t level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+    uint64_t blockStart = (wheel.currentTick >> levelShift(level + 1)) << levelShift(level + 1);
+
+    for (uint16_t slot = levelSlot(wheel.currentTick, level); slot < TIMER_WHEEL_SLOTS; slot++) {
+      if (wheel.slots[level][slot] != NULL) {
+        uint64_t tick = blockStart | ((uint64_t)slot << levelShift(level));
+
+        return (tick > wheel.currentTick) ? tick : wheel.currentTick;
+      }
+    }
+  }
+  return NO_TICK;
+}
+
+// Must be called with wheel.lock held. Moves the timers expired at or before
+// now to the expired list. Empty ticks are skipped.
+static void advanceWheel(uint64_t now)
+{
+  while (wheel.currentTick <= now) {
+    uint64_t tick = nextEventTick();
+
+    if (tick > now) {
+      wheel.currentTick = now + 1;
+      break;
+    }
+    wheel.currentTick = tick;
+    // Cascade the upper levels first, their timers may land in a lower level
+    // slot entered at this tick
+    for (uint8_t level = TIMER_WHEEL_LEVELS - 1; level > 0; level--) {
+      sli_connect_timer_t **slot;
+
+      if (tick & ((UINT64_C(1) << levelShift(level)) - 1)) {
+        continue;
+      }
+      slot = &wheel.slots[level][levelSlot(tick, level)];
+      while (*slot != NULL) {
+        sli_connect_timer_t *timer = *slot;
+
+        unlinkTimer(timer);
+        insertTimer(timer);
+      }
+    }
+    while (wheel.slots[0][levelSlot(tick, 0)] != NULL) {
+      sli_connect_timer_t *timer = wheel.slots[0][levelSlot(tick, 0)];
+
+      unlinkTimer(timer);
+      linkTimer(&wheel.expired, timer);
+    }
+    wheel.currentTick = tick + 1;
+  }
+}
+
+// Must be called with wheel.lock held
+static void armTimerFd(uint64_t tick)
+{
+  struct itimerspec wait = { 0 };
+  uint64_t timeMs;
+
+  if (tick == wheel.armedTick) {
+    return;
+  }
+  wheel.armedTick = tick;
+  if (tick != NO_TICK) {
+    timeMs = wheel.startMs + tick;
+    // A zero it_value would disarm the timer
+    wait.it_value.tv_sec = timeMs / 1000;
+    wait.it_value.tv_nsec = (timeMs % 1000) * 1000000 + 1;
+  }
+  timerfd_settime(wheel.timer_fd, TFD_TIMER_ABSTIME, &wait, NULL);
+}
+
+static void *timerThread(void *arg)
+{
+  struct pollfd pfd = {
+    .fd = wheel.timer_fd,
+    .events = POLLIN,
+  };
+  uint64_t expirations;
+  int ret;
+
+  (void)arg;
+  for (;;) {
+    ret = poll(&pfd, 1, -1);
+    BUG_ON(ret < 0, "Timer poll failed");
+    read(wheel.timer_fd, &expirations, sizeof(expirations));
+
+    pthread_mutex_lock(&wheel.lock);
+    wheel.armedTick = NO_TICK;
+    advanceWheel(monotonicTimeMs() - wheel.startMs);
+    // The timers stopped meanwhile leave the expired list
+    while (wheel.expired != NULL) {
+      sli_connect_timer_t *timer = wheel.expired;
+      sli_connect_timer_callback_t callback = timer->callback;
+      void *context = timer->context;
+
+      unlinkTimer(timer);
+      pthread_mutex_unlock(&wheel.lock);
+      callback(context);
+      pthread_mutex_lock(&wheel.lock);
+    }
+    armTimerFd(nextEventTick());
+    pthread_mutex_unlock(&wheel.lock);
+  }
+  return NULL;
+}
+
+static void startTimerThread(void)
+{
+  pthread_t thread;
+
+  wheel.startMs = monotonicTimeMs();
+  wheel.armedTick = NO_TICK;
+  wheel.timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  FATAL_ON(wheel.timer_fd < 0, 1, "timerfd_create: %m");
+  if (pthread_create(&thread, NULL, timerThread, NULL) != 0) {
+    FATAL(1, "Can't create timer thread");
+  }
+  pthread_detach(thread);
+}
+
+void sli_connect_timer_init(sli_connect_timer_t *timer,
+                            sli_connect_timer_callback_t callback,
+                            void *context)
+{
+  timer->callback = callback;
+  timer->context = context;
+  timer->next = NULL;
+  timer->pprev = NULL;
+}
+
+void sli_connect_timer_start(sli_connect_timer_t *timer, uint32_t delay_ms)
+{
+  pthread_once(&wheelOnce, startTimerThread);
+  pthread_mutex_lock(&wheel.lock);
+  if (timer->pprev != NULL) {
+    unlinkTimer(timer);
+  }
+  timer->expire_tick = monotonicTimeMs() - wheel.startMs + delay_ms;
+  insertTimer(timer);
+  // If the timer is already expired, timer_fd is armed in the past and wakes
+  // the timer thread up at once
+  if (timer->expire_tick < wheel.armedTick) {
+    armTimerFd(timer->expire_tick);
+  }
+  pthread_mutex_unlock(&wheel.lock);
+}
+
+void sli_connect_timer_stop(sli_connect_timer_t *timer)
+{
+  // timer_fd stays armed, the timer thread will find nothing to do
+  pthread_mutex_lock(&wheel.lock);
+  if (timer->pprev != NULL) {
+    unlinkTimer(timer);
+  }
+  pthread_mutex_unlock(&wheel.lock);
+}
+
+bool sli_connect_timer_is_pending(sli_connect_timer_t *timer)
+{
+  bool pending;
+
+  pthread_mutex_lock(&wheel.lock);
+  pending = timer->pprev != NULL;
+  pthread_mutex_unlock(&wheel.lock);
+  return pending;
+}
@@ -0,0 +1,51 @@
+/***************************************************************************//**
+ * @brief Timers of the library, served by one thread and one timerfd.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef __TIMER_WHEEL_H__
+#define __TIMER_WHEEL_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef void (*sli_connect_timer_callback_t)(void *context);
+
+// Timers are allocated by their users, usually as a member of the object they
+// time. The fields are private to the timer wheel.
+typedef struct sli_connect_timer {
+  sli_connect_timer_callback_t callback;
+  void *context;
+  uint64_t expire_tick;
+  struct sli_connect_timer *next;
+  // NULL if the timer is not pending
+  struct sli_connect_timer **pprev;
+} sli_connect_timer_t;
+
+void sli_connect_timer_init(sli_connect_timer_t *timer,
+                            sli_connect_timer_callback_t callback,
+                            void *context);
+
+// Arm the timer to expire in delay_ms, or re-arm it if it is pending. The
+// callback is called from the timer thread, without any lock held, so it may
+// run after a concurrent sli_connect_timer_stop() or sli_connect_timer_start()
+// of the same timer: callers check their own state under their own lock.
+void sli_connect_timer_start(sli_connect_timer_t *timer, uint32_t delay_ms);
+
+void sli_connect_timer_stop(sli_connect_timer_t *timer);
+
+// True between sli_connect_timer_start() and the expiration of the timer
+bool sli_connect_timer_is_pending(sli_connect_timer_t *timer);
+
+#endif
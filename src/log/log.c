@@ -15,12 +15,27 @@
 #include <string.h>
 #include <unistd.h>
 #include <ctype.h>
+#include <stdarg.h>
 #include <connect/ember.h>
+#include <connect/ncp.h>
 #include "log.h"
+#include "log_async.h"
 
 FILE *g_trace_stream = NULL;
 unsigned int g_enabled_traces = 0;
 bool g_enable_color_traces = true;
+bool g_async_traces = false;
+
+_Static_assert(SL_CONNECT_NCP_TRACE_CSP_ID == TR_CSP_ID
+               && SL_CONNECT_NCP_TRACE_CSP_FULL == TR_CSP_FULL
+               && SL_CONNECT_NCP_TRACE_CALLBACK_QUEUE == TR_CB_QUEUE,
+               "public trace flags must match the TR_* ones");
+
+void sl_connect_ncp_set_traces(unsigned int traces, bool async)
+{
+  g_async_traces = async;
+  g_enabled_traces = traces;
+}
 
 static __thread char trace_buffer[256];
 static __thread int trace_idx = 0;
@@ -137,13 +152,22 @@ char *str_csp_full(const uint8_t *in, int in_len, char *out, int out_len)
  */
 static __thread int trace_nested_counter = 0;
 
-void __tr_enter()
+void __tr_init()
 {
   if (!g_trace_stream) {
     g_trace_stream = stdout;
     setlinebuf(stdout);
     g_enable_color_traces = isatty(fileno(g_trace_stream));
   }
+}
+
+void __tr_enter()
+{
+  __tr_init();
+  // Keep the synchronous output ordered after the queued traces
+  if (!trace_nested_counter) {
+    log_async_flush();
+  }
   trace_nested_counter++;
 }
 
@@ -155,6 +179,36 @@ void __tr_exit()
   }
 }
 
+void __tr_printf_async(int color, const char *fmt, ...)
+{
+  va_list ap;
+
+  va_start(ap, fmt);
+  log_async_vprintf(color, fmt, ap);
+  va_end(ap);
+  // The arguments may have used trace_buffer
+  if (!trace_nested_counter) {
+    trace_idx = 0;
+  }
+}
+
+void __tr_frame(const char *prefix, const uint8_t in[], int in_len)
+{
+  char *out;
+
+  if (g_async_traces) {
+    log_async_frame(prefix, in, in_len);
+    return;
+  }
+  out = malloc(in_len * 3 + 1);
+  if (!out) {
+    return;
+  }
+  str_csp_full(in, in_len, out, in_len * 3 + 1);
+  __PRINT_WITH_TIME(90, "%s: %s", prefix, out);
+  free(out);
+}
+
 const char *tr_csp_id(uint16_t in)
 {
   char *out = trace_buffer + trace_idx;
@@ -26,6 +26,10 @@
 extern FILE *g_trace_stream;
 extern unsigned int g_enabled_traces;
 extern bool g_enable_color_traces;
+// When set, TRACE() records are queued to a background logger thread instead
+// of being written to g_trace_stream by the caller. Other levels stay
+// synchronous and write the queued traces first.
+extern bool g_async_traces;
 
 enum {
   TR_CSP_ID   = (1 << 0),
@@ -46,6 +50,7 @@ enum str_bytes_options {
 #define STR_MAX_LEN_CSP_ID     19
 
 #define TRACE(COND, ...)          __TRACE(COND, "" __VA_ARGS__)
+#define TRACE_FRAME(COND, PREFIX, IN, IN_LEN) __TRACE_FRAME(COND, PREFIX, IN, IN_LEN)
 #define INFO(...)                 __INFO("" __VA_ARGS__)
 #define DEBUG(...)                __DEBUG("" __VA_ARGS__)
 #define WARN(...)                 __WARN("" __VA_ARGS__)
@@ -59,19 +64,30 @@ char *str_csp_id(uint16_t in, char out[STR_MAX_LEN_CSP_ID]);
 char *str_csp_full(const uint8_t *in, int in_len, char *out, int out_len);
 const char *tr_csp_id(uint16_t in);
 const char *tr_csp_full(const uint8_t in[], int in_len);
+void __tr_init();
 void __tr_enter();
 void __tr_exit();
+void __tr_printf_async(int color, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+void __tr_frame(const char *prefix, const uint8_t in[], int in_len);
 
 #define __TRACE(COND, MSG, ...)                               \
   do {                                                        \
     if (g_enabled_traces & (COND)) {                          \
       if (MSG[0] != '\0') {                                   \
-        __PRINT_WITH_TIME(90, MSG, ##__VA_ARGS__); }          \
+        __PRINT_TRACE(90, MSG, ##__VA_ARGS__); }              \
       else {                                                  \
-        __PRINT_WITH_TIME(90, "%s:%d", __FILE__, __LINE__); } \
+        __PRINT_TRACE(90, "%s:%d", __FILE__, __LINE__); }     \
     }                                                         \
   } while (0)
 
+// The frame is hex formatted by the logger thread when traces are
+// asynchronous, so it is never truncated
+#define __TRACE_FRAME(COND, PREFIX, IN, IN_LEN) \
+  do {                                          \
+    if (g_enabled_traces & (COND)) {            \
+      __tr_frame(PREFIX, IN, IN_LEN); }         \
+  } while (0)
+
 #define __DEBUG(MSG, ...)                          \
   do {                                             \
     if (MSG[0] != '\0') {                          \
@@ -176,6 +192,14 @@ void __tr_exit();
             ##__VA_ARGS__);                                     \
   } while (0)
 
+#define __PRINT_TRACE(COLOR, MSG, ...)                  \
+  do {                                                  \
+    if (g_async_traces) {                               \
+      __tr_printf_async(COLOR, MSG, ##__VA_ARGS__); }   \
+    else {                                              \
+      __PRINT_WITH_TIME(COLOR, MSG, ##__VA_ARGS__); }   \
+  } while (0)
+
 #define __PRINT_WITH_LINE(COLOR, MSG, ...) \
   __PRINT(COLOR, "%s():%d: " MSG, __func__, __LINE__, ##__VA_ARGS__)
 
@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) 2024 Silicon Laboratories Inc. (www.silabs.com)
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of the Silicon Labs Master Software License
+ * Agreement (MSLA) available at [1].  This software is distributed to you in
+ * Object Code format and/or Source Code format and is governed by the sections
+ * of the MSLA applicable to Object Code, Source Code and Modified Open Source
+ * Code. By using this software, you agree to the terms of the MSLA.
+ *
+ * [1]: https://www.silabs.com/about-us/legal/master-software-license-agreement
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include "log.h"
+#include "log_async.h"
+
+// Each thread producing traces owns a single producer / single consumer ring
+// of variable length records. head and tail are free running byte counters:
+// the producer only moves head and the consumer only moves tail, so producers
+// never take a lock nor issue a system call, except to wake an idle logger up.
+//
+// The consumer side (the logger thread, or any thread flushing before a
+// synchronous print) is serialized by rings_lock, which also protects the list
+// of rings. Records of the different rings are merged by timestamp.
+
+#define LOG_ASYNC_RING_MASK      (LOG_ASYNC_RING_SIZE - 1)
+#define LOG_ASYNC_IDLE_POLL_MS   100
+
+_Static_assert((LOG_ASYNC_RING_SIZE & LOG_ASYNC_RING_MASK) == 0,
+               "LOG_ASYNC_RING_SIZE must be a power of two");
+
+enum {
+  RECORD_PAD   = 0, // Skips the end of the ring, only size and type are valid
+  RECORD_TEXT  = 1, // Payload is a NUL terminated string
+  RECORD_FRAME = 2, // Payload is a raw frame
+};
+
+struct log_record {
+  uint32_t size;      // Whole record, header included, multiple of 8
+  uint16_t type;
+  uint16_t color;
+  uint32_t len;       // Payload length
+  struct timespec ts;
+  const char *prefix;
+  uint8_t payload[];
+};
+
+struct log_ring {
+  _Alignas(64) atomic_size_t head;
+  _Alignas(64) atomic_size_t tail;
+  atomic_ulong dropped;
+  unsigned long reported_dropped;
+  atomic_bool closed;
+  struct log_ring *next;
+  _Alignas(64) uint8_t data[LOG_ASYNC_RING_SIZE];
+};
+
+static pthread_once_t logger_once = PTHREAD_ONCE_INIT;
+static pthread_key_t ring_key;
+static pthread_mutex_t rings_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct log_ring *rings;
+static atomic_bool started;
+static atomic_bool logger_idle;
+static int wake_fd = -1;
+static __thread struct log_ring *thread_ring;
+
+static size_t record_size(size_t payload_len)
+{
+  return (sizeof(struct log_record) + payload_len + 7) & ~(size_t)7;
+}
+
+static bool timespec_before(const struct timespec *a, const struct timespec *b)
+{
+  return a->tv_sec < b->tv_sec || (a->tv_sec == b->tv_sec && a->tv_nsec < b->tv_nsec);
+}
+
+//------------------------------------------------------------------------------
+// Consumer side
+
+static void print_drops(struct log_ring *ring)
+{
+  unsigned long dropped = atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+
+  if (dropped != ring->reported_dropped) {
+    if (g_enable_color_traces) {
+      fprintf(g_trace_stream, "\x1B[93mwarning: %lu trace records dropped\x1B[0m\n",
+              dropped - ring->reported_dropped);
+    } else {
+      fprintf(g_trace_stream, "warning: %lu trace records dropped\n",
+              dropped - ring->reported_dropped);
+    }
+    ring->reported_dropped = dropped;
+  }
+}
+
+static void print_record(const struct log_record *record)
+{
+  static const char hex[] = "0123456789abcdef";
+  FILE *stream = g_trace_stream;
+  bool color = record->color && g_enable_color_traces;
+
+  flockfile(stream);
+  if (color) {
+    fprintf(stream, "\x1B[%um", record->color);
+  }
+  fprintf(stream, "%ju.%06ju: ", (uintmax_t)record->ts.tv_sec, (uintmax_t)record->ts.tv_nsec / 1000);
+  if (record->type == RECORD_TEXT) {
+    fputs((const char *)record->payload, stream);
+  } else {
+    fprintf(stream, "%s: ", record->prefix);
+    for (uint32_t i = 0; i < record->len; i++) {
+      if (i) {
+        putc_unlocked(':', stream);
+      }
+      putc_unlocked(hex[record->payload[i] >> 4], stream);
+      putc_unlocked(hex[record->payload[i] & 0xF], stream);
+    }
+  }
+  fputs(color ? "\x1B[0m\n" : "\n", stream);
+  funlockfile(stream);
+}
+
+// Returns the oldest record of the ring, skipping padding, or NULL if the ring
+// is empty
+static struct log_record *ring_peek(struct log_ring *ring)
+{
+  size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+  while (tail != atomic_load_explicit(&ring->head, memory_order_acquire)) {
+    struct log_record *record = (struct log_record *)(ring->data + (tail & LOG_ASYNC_RING_MASK));
+    if (record->type != RECORD_PAD) {
+      return record;
+    }
+    tail += record->size;
+    atomic_store_explicit(&ring->tail, tail, memory_order_release);
+  }
+  return NULL;
+}
+
+static bool rings_pending(void)
+{
+  bool pending = false;
+
+  pthread_mutex_lock(&rings_lock);
+  for (struct log_ring *ring = rings; ring && !pending; ring = ring->next) {
+    pending = atomic_load(&ring->head) != atomic_load_explicit(&ring->tail, memory_order_relaxed);
+  }
+  pthread_mutex_unlock(&rings_lock);
+  return pending;
+}
+
+void log_async_flush(void)
+{
+  if (!atomic_load_explicit(&started, memory_order_acquire)) {
+    return;
+  }
+
+  pthread_mutex_lock(&rings_lock);
+  __tr_init();
+  for (struct log_ring *ring = rings; ring; ring = ring->next) {
+    print_drops(ring);
+  }
+  while (true) {
+    struct log_ring *oldest_ring = NULL;
+    struct log_record *oldest = NULL;
+
+    for (struct log_ring *ring = rings; ring; ring = ring->next) {
+      struct log_record *record = ring_peek(ring);
+      if (record && (!oldest || timespec_before(&record->ts, &oldest->ts))) {
+        oldest_ring = ring;
+        oldest = record;
+      }
+    }
+    if (!oldest) {
+      break;
+    }
+    print_record(oldest);
+    atomic_store_explicit(&oldest_ring->tail,
+                          atomic_load_explicit(&oldest_ring->tail, memory_order_relaxed) + oldest->size,
+                          memory_order_release);
+  }
+  fflush(g_trace_stream);
+
+  // Rings of exited threads are released once drained
+  for (struct log_ring **link = &rings; *link;) {
+    struct log_ring *ring = *link;
+    if (atomic_load(&ring->closed) && ring_peek(ring) == NULL) {
+      print_drops(ring);
+      *link = ring->next;
+      free(ring);
+    } else {
+      link = &ring->next;
+    }
+  }
+  pthread_mutex_unlock(&rings_lock);
+}
+
+static void *logger_thread(void *arg)
+{
+  struct pollfd poll_fd = { .fd = wake_fd, .events = POLLIN };
+  uint64_t count;
+
+  (void)arg;
+  while (true) {
+    log_async_flush();
+    // Either a producer sees the logger idle and wakes it up, or the logger
+    // sees the record published before going to sleep
+    atomic_store(&logger_idle, true);
+    if (rings_pending()) {
+      atomic_store(&logger_idle, false);
+      continue;
+    }
+    if (poll(&poll_fd, 1, LOG_ASYNC_IDLE_POLL_MS) > 0) {
+      if (read(wake_fd, &count, sizeof(count)) < 0) {
+        // Spurious wake up, the rings are drained anyway
+      }
+    }
+    atomic_store(&logger_idle, false);
+  }
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+// Producer side
+
+static void close_ring(void *arg)
+{
+  struct log_ring *ring = arg;
+
+  thread_ring = NULL;
+  atomic_store(&ring->closed, true);
+}
+
+static void start_logger(void)
+{
+  pthread_t thread;
+
+  FATAL_ON(pthread_key_create(&ring_key, close_ring) != 0, 1, "Failed to create the trace ring key");
+  wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  FATAL_ON(wake_fd < 0, 1, "Failed to create the trace logger eventfd");
+  FATAL_ON(pthread_create(&thread, NULL, logger_thread, NULL) != 0, 1, "Failed to start the trace logger thread");
+  pthread_detach(thread);
+  // Records queued just before exit() are still written
+  atexit(log_async_flush);
+}
+
+static struct log_ring *get_thread_ring(void)
+{
+  struct log_ring *ring = thread_ring;
+
+  if (ring) {
+    return ring;
+  }
+  pthread_once(&logger_once, start_logger);
+  ring = aligned_alloc(64, sizeof(struct log_ring));
+  if (!ring) {
+    return NULL;
+  }
+  atomic_init(&ring->head, 0);
+  atomic_init(&ring->tail, 0);
+  atomic_init(&ring->dropped, 0);
+  ring->reported_dropped = 0;
+  atomic_init(&ring->closed, false);
+  pthread_mutex_lock(&rings_lock);
+  ring->next = rings;
+  rings = ring;
+  pthread_mutex_unlock(&rings_lock);
+  pthread_setspecific(ring_key, ring);
+  atomic_store_explicit(&started, true, memory_order_release);
+  thread_ring = ring;
+  return ring;
+}
+
+// Reserves room for a record of at most max_size bytes, padding the end of the
+// ring if the record does not fit there contiguously
+static struct log_record *ring_reserve(struct log_ring *ring, size_t max_size)
+{
+  size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+  size_t contiguous = LOG_ASYNC_RING_SIZE - (head & LOG_ASYNC_RING_MASK);
+  size_t needed = contiguous < max_size ? contiguous + max_size : max_size;
+
+  if (LOG_ASYNC_RING_SIZE - (head - tail) < needed) {
+    atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+    return NULL;
+  }
+  if (contiguous < max_size) {
+    struct log_record *pad = (struct log_record *)(ring->data + (head & LOG_ASYNC_RING_MASK));
+    pad->size = contiguous;
+    pad->type = RECORD_PAD;
+    head += contiguous;
+    atomic_store_explicit(&ring->head, head, memory_order_release);
+  }
+  return (struct log_record *)(ring->data + (head & LOG_ASYNC_RING_MASK));
+}
+
+static void ring_commit(struct log_ring *ring, struct log_record *record, size_t size)
+{
+  record->size = size;
+  clock_gettime(CLOCK_REALTIME, &record->ts);
+  atomic_store_explicit(&ring->head,
+                        atomic_load_explicit(&ring->head, memory_order_relaxed) + size,
+                        memory_order_release);
+
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_load_explicit(&logger_idle, memory_order_relaxed)
+      && atomic_exchange(&logger_idle, false)) {
+    uint64_t count = 1;
+    if (write(wake_fd, &count, sizeof(count)) < 0) {
+      // The logger polls the rings periodically anyway
+    }
+  }
+}
+
+bool log_async_vprintf(int color, const char *fmt, va_list ap)
+{
+  struct log_ring *ring = get_thread_ring();
+  struct log_record *record;
+  int len;
+
+  if (!ring) {
+    return false;
+  }
+  record = ring_reserve(ring, record_size(LOG_ASYNC_MAX_TEXT_LEN));
+  if (!record) {
+    return false;
+  }
+  len = vsnprintf((char *)record->payload, LOG_ASYNC_MAX_TEXT_LEN, fmt, ap);
+  if (len < 0) {
+    len = 0;
+    record->payload[0] = '\0';
+  } else if (len >= LOG_ASYNC_MAX_TEXT_LEN) {
+    len = LOG_ASYNC_MAX_TEXT_LEN - 1;
+  }
+  record->type = RECORD_TEXT;
+  record->color = color;
+  record->len = len;
+  record->prefix = NULL;
+  ring_commit(ring, record, record_size(len + 1));
+  return true;
+}
+
+bool log_async_frame(const char *prefix, const uint8_t *in, unsigned int in_len)
+{
+  struct log_ring *ring = get_thread_ring();
+  struct log_record *record;
+
+  if (!ring) {
+    return false;
+  }
+  if (record_size(in_len) > LOG_ASYNC_RING_SIZE) {
+    atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+    return false;
+  }
+  record = ring_reserve(ring, record_size(in_len));
+  if (!record) {
+    return false;
+  }
+  record->type = RECORD_FRAME;
+  record->color = 90;
+  record->len = in_len;
+  record->prefix = prefix;
+  memcpy(record->payload, in, in_len);
+  ring_commit(ring, record, record_size(in_len));
+  return true;
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2024 Silicon Laboratories Inc. (www.silabs.com)
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of the Silicon Labs Master Software License
+ * Agreement (MSLA) available at [1].  This software is distributed to you in
+ * Object Code format and/or Source Code format and is governed by the sections
+ * of the MSLA applicable to Object Code, Source Code and Modified Open Source
+ * Code. By using this software, you agree to the terms of the MSLA.
+ *
+ * [1]: https://www.silabs.com/about-us/legal/master-software-license-agreement
+ */
+
+#ifndef __LOG_ASYNC_H__
+#define __LOG_ASYNC_H__
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Size in bytes of the trace ring of each thread, must be a power of two. A
+// record that does not fit in the ring is dropped and accounted for.
+#define LOG_ASYNC_RING_SIZE      (64 * 1024)
+
+// Maximum length of a formatted text record, longer traces are truncated.
+#define LOG_ASYNC_MAX_TEXT_LEN   256
+
+// Queues a text trace, formatted by the caller thread. Returns false if the
+// record was dropped.
+bool log_async_vprintf(int color, const char *fmt, va_list ap);
+
+// Queues a raw frame, hex formatted by the logger thread as "<prefix>: aa:bb".
+// prefix must have static storage duration. Returns false if the record was
+// dropped.
+bool log_async_frame(const char *prefix, const uint8_t *in, unsigned int in_len);
+
+// Writes all queued records to g_trace_stream from the caller thread. A no-op
+// until the first record was queued.
+void log_async_flush(void);
+
+#endif
@@ -0,0 +1,472 @@
+/***************************************************************************//**
+ * @brief In-process NCP simulator
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include "log/log.h"
+#include "connect/ncp-simulator.h"
+#include "csp/csp-format.h"
+#include "csp/csp-api-enum-gen.h"
+#include "host-common/cpc-host.h"
+#include "host-common/ncp-host-common.h"
+
+typedef struct {
+  sl_connect_ncp_instance_t *instance;
+  sl_connect_ncp_simulator_config_t config;
+  // Host and NCP ends of the socket pair
+  int hostFd;
+  int ncpFd;
+  pthread_t thread;
+  uint64_t nextIndicationUs;
+
+  EmberNetworkStatus networkState;
+  EmberNodeType nodeType;
+  EmberNodeId nodeId;
+  EmberPanId panId;
+  uint16_t channel;
+  bool longMessages;
+  bool sequenceNumbers;
+} NcpSimulator;
+
+static NcpSimulator simulators[SL_CONNECT_NCP_MAX_INSTANCES];
+static uint8_t simulatorCount;
+static pthread_mutex_t simulatorLock = PTHREAD_MUTEX_INITIALIZER;
+
+// Response parameters of each command, indexed by the low byte of its ID, in
+// the CSP format characters: u and s for 8 bit, v for 16 bit and w for 32 bit
+// integers, b for a buffer prefixed by its length. Commands not handled by
+// handleCommand() are answered with zeroes and empty buffers in this format.
+static const char *responseFormats[256] = {
+  [EMBER_NETWORK_STATE_IPC_COMMAND_ID & 0xFF]                            = "u",
+  [EMBER_STACK_IS_UP_IPC_COMMAND_ID & 0xFF]                              = "u",
+  [EMBER_SET_SECURITY_KEY_IPC_COMMAND_ID & 0xFF]                         = "u",
+  [EMBER_GET_SECURITY_KEY_IPC_COMMAND_ID & 0xFF]                         = "ub",
+  [EMBER_SET_PSA_SECURITY_KEY_IPC_COMMAND_ID & 0xFF]                     = "u",
+  [EMBER_REMOVE_PSA_SECURITY_KEY_IPC_COMMAND_ID & 0xFF]                  = "u",
+  [EMBER_SET_NCP_SECURITY_KEY_PERSISTENT_IPC_COMMAND_ID & 0xFF]          = "u",
+  [EMBER_SET_NCP_SECURITY_KEY_IPC_COMMAND_ID & 0xFF]                     = "u",
+  [EMBER_GET_KEY_ID_IPC_COMMAND_ID & 0xFF]                               = "w",
+  [EMBER_GET_COUNTER_IPC_COMMAND_ID & 0xFF]                              = "uw",
+  [EMBER_SET_RADIO_CHANNEL_EXTENDED_IPC_COMMAND_ID & 0xFF]               = "u",
+  [EMBER_SET_RADIO_CHANNEL_IPC_COMMAND_ID & 0xFF]                        = "u",
+  [EMBER_GET_RADIO_CHANNEL_IPC_COMMAND_ID & 0xFF]                        = "v",
+  [EMBER_SET_RADIO_POWER_IPC_COMMAND_ID & 0xFF]                          = "u",
+  [EMBER_GET_RADIO_POWER_IPC_COMMAND_ID & 0xFF]                          = "v",
+  [EMBER_SET_RADIO_POWER_MODE_IPC_COMMAND_ID & 0xFF]                     = "u",
+  [EMBER_SET_UNENCRYPTED_PACKETS_ACCEPTANCE_IPC_COMMAND_ID & 0xFF]       = "u",
+  [EMBER_SET_MAC_PARAMS_IPC_COMMAND_ID & 0xFF]                           = "u",
+  [EMBER_CURRENT_STACK_TASKS_IPC_COMMAND_ID & 0xFF]                      = "v",
+  [EMBER_OK_TO_NAP_IPC_COMMAND_ID & 0xFF]                                = "u",
+  [EMBER_OK_TO_HIBERNATE_IPC_COMMAND_ID & 0xFF]                          = "u",
+  [EMBER_GET_EUI64_IPC_COMMAND_ID & 0xFF]                                = "b",
+  [EMBER_MAC_GET_PARENT_ADDRESS_IPC_COMMAND_ID & 0xFF]                   = "uvbu",
+  [EMBER_IS_LOCAL_EUI64_IPC_COMMAND_ID & 0xFF]                           = "u",
+  [EMBER_GET_NODE_ID_IPC_COMMAND_ID & 0xFF]                              = "v",
+  [EMBER_GET_PAN_ID_IPC_COMMAND_ID & 0xFF]                               = "v",
+  [EMBER_GET_PARENT_ID_IPC_COMMAND_ID & 0xFF]                            = "v",
+  [EMBER_GET_NODE_TYPE_IPC_COMMAND_ID & 0xFF]                            = "u",
+  [EMBER_CALIBRATE_CURRENT_CHANNEL_EXTENDED_IPC_COMMAND_ID & 0xFF]       = "uw",
+  [EMBER_APPLY_IR_CALIBRATION_IPC_COMMAND_ID & 0xFF]                     = "u",
+  [EMBER_TEMP_CALIBRATION_IPC_COMMAND_ID & 0xFF]                         = "u",
+  [EMBER_GET_CAL_TYPE_IPC_COMMAND_ID & 0xFF]                             = "w",
+  [EMBER_GET_MAXIMUM_PAYLOAD_LENGTH_IPC_COMMAND_ID & 0xFF]               = "v",
+  [EMBER_SET_INDIRECT_QUEUE_TIMEOUT_IPC_COMMAND_ID & 0xFF]               = "u",
+  [EMBER_GET_VERSION_INFO_IPC_COMMAND_ID & 0xFF]                         = "uvvw",
+  [EMBER_OFDM_SET_MCS_IPC_COMMAND_ID & 0xFF]                             = "u",
+  [EMBER_OFDM_GET_MCS_IPC_COMMAND_ID & 0xFF]                             = "uu",
+  [EMBER_NCP_SET_LONG_MESSAGES_USE_IPC_COMMAND_ID & 0xFF]                = "u",
+  [EMBER_USING_LONG_MESSAGES_IPC_COMMAND_ID & 0xFF]                      = "u",
+  [EMBER_NCP_SET_SEQUENCE_NUMBERS_USE_IPC_COMMAND_ID & 0xFF]             = "u",
+  [EMBER_MESSAGE_SEND_IPC_COMMAND_ID & 0xFF]                             = "u",
+  [EMBER_POLL_FOR_DATA_IPC_COMMAND_ID & 0xFF]                            = "u",
+  [EMBER_MAC_MESSAGE_SEND_IPC_COMMAND_ID & 0xFF]                         = "u",
+  [EMBER_MAC_SET_PAN_COORDINATOR_IPC_COMMAND_ID & 0xFF]                  = "u",
+  [EMBER_SET_POLL_DESTINATION_ADDRESS_IPC_COMMAND_ID & 0xFF]             = "u",
+  [EMBER_REMOVE_CHILD_IPC_COMMAND_ID & 0xFF]                             = "u",
+  [EMBER_GET_CHILD_FLAGS_IPC_COMMAND_ID & 0xFF]                          = "uu",
+  [EMBER_GET_CHILD_INFO_IPC_COMMAND_ID & 0xFF]                           = "uvbuu",
+  [EMBER_PURGE_INDIRECT_MESSAGES_IPC_COMMAND_ID & 0xFF]                  = "u",
+  [EMBER_MAC_ADD_SHORT_TO_LONG_ADDRESS_MAPPING_IPC_COMMAND_ID & 0xFF]    = "u",
+  [EMBER_MAC_CLEAR_SHORT_TO_LONG_ADDRESS_MAPPINGS_IPC_COMMAND_ID & 0xFF] = "u",
+  [EMBER_NETWORK_LEAVE_IPC_COMMAND_ID & 0xFF]                            = "u",
+  [EMBER_NETWORK_INIT_IPC_COMMAND_ID & 0xFF]                             = "u",
+  [EMBER_START_ACTIVE_SCAN_IPC_COMMAND_ID & 0xFF]                        = "u",
+  [EMBER_START_ENERGY_SCAN_IPC_COMMAND_ID & 0xFF]                        = "u",
+  [EMBER_SET_APPLICATION_BEACON_PAYLOAD_IPC_COMMAND_ID & 0xFF]           = "u",
+  [EMBER_SET_SELECTIVE_JOIN_PAYLOAD_IPC_COMMAND_ID & 0xFF]               = "u",
+  [EMBER_CLEAR_SELECTIVE_JOIN_PAYLOAD_IPC_COMMAND_ID & 0xFF]             = "u",
+  [EMBER_FORM_NETWORK_IPC_COMMAND_ID & 0xFF]                             = "u",
+  [EMBER_JOIN_NETWORK_EXTENDED_IPC_COMMAND_ID & 0xFF]                    = "u",
+  [EMBER_JOIN_NETWORK_IPC_COMMAND_ID & 0xFF]                             = "u",
+  [EMBER_MAC_FORM_NETWORK_IPC_COMMAND_ID & 0xFF]                         = "u",
+  [EMBER_PERMIT_JOINING_IPC_COMMAND_ID & 0xFF]                           = "u",
+  [EMBER_JOIN_COMMISSIONED_IPC_COMMAND_ID & 0xFF]                        = "u",
+  [EMBER_RESET_NETWORK_STATE_IPC_COMMAND_ID & 0xFF]                      = "",
+  [EMBER_FREQUENCY_HOPPING_SET_CHANNEL_MASK_IPC_COMMAND_ID & 0xFF]       = "u",
+  [EMBER_FREQUENCY_HOPPING_START_SERVER_IPC_COMMAND_ID & 0xFF]           = "u",
+  [EMBER_FREQUENCY_HOPPING_START_CLIENT_IPC_COMMAND_ID & 0xFF]           = "u",
+  [EMBER_FREQUENCY_HOPPING_STOP_IPC_COMMAND_ID & 0xFF]                   = "u",
+  [EMBER_SET_AUXILIARY_ADDRESS_FILTERING_ENTRY_IPC_COMMAND_ID & 0xFF]    = "u",
+  [EMBER_GET_AUXILIARY_ADDRESS_FILTERING_ENTRY_IPC_COMMAND_ID & 0xFF]    = "v",
+  [EMBER_START_TX_STREAM_IPC_COMMAND_ID & 0xFF]                          = "u",
+  [EMBER_STOP_TX_STREAM_IPC_COMMAND_ID & 0xFF]                           = "u",
+  [EMBER_SET_ACTIVE_SCAN_DURATION_IPC_COMMAND_ID & 0xFF]                 = "u",
+  [EMBER_GET_ACTIVE_SCAN_DURATION_IPC_COMMAND_ID & 0xFF]                 = "v",
+  [EMBER_GET_DEFAULT_CHANNEL_IPC_COMMAND_ID & 0xFF]                      = "v",
+};
+
+static uint64_t monotonicUs(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+static void sendFrame(NcpSimulator *simulator, const uint8_t *frame, const uint8_t *frameEnd)
+{
+  if (send(simulator->ncpFd, frame, frameEnd - frame, MSG_NOSIGNAL) < 0) {
+    WARN("NCP simulator: send failed: %s", strerror(errno));
+  }
+}
+
+static void sendStackStatus(NcpSimulator *simulator, EmberStatus status)
+{
+  uint8_t frame[3];
+  uint8_t *finger = frame;
+
+  cspEncodeUint16(&finger, (uint16_t)EMBER_STACK_STATUS_HANDLER_IPC_COMMAND_ID);
+  cspEncodeUint8(&finger, status);
+  sendFrame(simulator, frame, finger);
+}
+
+static void setNetwork(NcpSimulator *simulator, EmberNodeType nodeType, EmberNodeId nodeId, uint8_t **params)
+{
+  simulator->nodeType = nodeType;
+  simulator->nodeId = nodeId;
+  simulator->panId = cspDecodeUint16(params);
+  cspDecodeUint16(params); // radioTxPower
+  simulator->channel = cspDecodeUint16(params);
+  simulator->networkState = EMBER_JOINED_NETWORK;
+}
+
+static void sendMessageSent(NcpSimulator *simulator, uint8_t *params)
+{
+  uint8_t frame[MAX_STACK_CALLBACK_COMMAND_SIZE];
+  uint8_t *finger = frame;
+  EmberNodeId destination = cspDecodeUint16(&params);
+  uint8_t endpoint = cspDecodeUint8(&params);
+  uint8_t tag = cspDecodeUint8(&params);
+  uint16_t length = cspDecodeLength(&params);
+  uint8_t *payload;
+  uint8_t options;
+
+  length = cspDecodeLength(&params);
+  payload = params;
+  params += length;
+  options = cspDecodeUint8(&params);
+  cspEncodeUint16(&finger, (uint16_t)EMBER_MESSAGE_SENT_HANDLER_IPC_COMMAND_ID);
+  cspEncodeUint8(&finger, (EmberStatus)EMBER_SUCCESS);
+  cspEncodeUint8(&finger, options);
+  cspEncodeUint16(&finger, destination);
+  cspEncodeUint8(&finger, endpoint);
+  cspEncodeUint8(&finger, tag);
+  cspEncodeLength(&finger, length);
+  cspEncodeBuffer(&finger, payload, length);
+  cspEncodeInt8(&finger, (int8_t)-40); // ackRssi
+  cspEncodeUint32(&finger, (uint32_t)(monotonicUs() / 1000));
+  sendFrame(simulator, frame, finger);
+}
+
+static void sendIncomingMessage(NcpSimulator *simulator)
+{
+  uint8_t frame[MAX_STACK_CALLBACK_COMMAND_SIZE];
+  uint8_t *finger = frame;
+
+  cspEncodeUint16(&finger, (uint16_t)EMBER_INCOMING_MESSAGE_HANDLER_IPC_COMMAND_ID);
+  cspEncodeUint8(&finger, (uint8_t)0); // options
+  cspEncodeUint16(&finger, simulator->config.indication_source);
+  cspEncodeUint8(&finger, simulator->config.indication_endpoint);
+  cspEncodeInt8(&finger, (int8_t)-40); // rssi
+  cspEncodeLength(&finger, simulator->config.indication_payload_length);
+  cspEncodeBuffer(&finger, NULL, simulator->config.indication_payload_length);
+  cspEncodeUint32(&finger, (uint32_t)(monotonicUs() / 1000));
+  cspEncodeUint8(&finger, (uint8_t)255); // lqi
+  sendFrame(simulator, frame, finger);
+}
+
+// Answers a command received from the host, followed by the indications it
+// triggers on a real NCP.
+static void handleCommand(NcpSimulator *simulator, uint8_t *command, uint16_t length)
+{
+  uint8_t response[CPC_RX_BUFFER_SIZE];
+  uint8_t *finger = response;
+  uint8_t *params = command;
+  uint16_t identifier = cspDecodeUint16(&params);
+  EmberStatus indication = EMBER_SUCCESS;
+  bool messageSent = false;
+  bool sequenced = simulator->sequenceNumbers;
+
+  // The command setting the use of sequence numbers is accepted with or
+  // without one, told apart by its length
+  if (identifier == EMBER_NCP_SET_SEQUENCE_NUMBERS_USE_IPC_COMMAND_ID) {
+    sequenced = (length > sizeof(uint16_t) + sizeof(uint8_t));
+  }
+
+  if (simulator->config.response_delay_us > 0) {
+    usleep(simulator->config.response_delay_us);
+  }
+  cspEncodeUint16(&finger, identifier);
+  switch (identifier) {
+    case EMBER_NETWORK_STATE_IPC_COMMAND_ID:
+      cspEncodeUint8(&finger, simulator->networkState);
+      break;
+    case EMBER_STACK_IS_UP_IPC_COMMAND_ID:
+      cspEncodeUint8(&finger, (bool)(simulator->networkState == EMBER_JOINED_NETWORK));
+      break;
+    case EMBER_GET_NODE_ID_IPC_COMMAND_ID:
+      cspEncodeUint16(&finger, simulator->nodeId);
+      break;
+    case EMBER_GET_PAN_ID_IPC_COMMAND_ID:
+      cspEncodeUint16(&finger, simulator->panId);
+      break;
+    case EMBER_GET_NODE_TYPE_IPC_COMMAND_ID:
+      cspEncodeUint8(&finger, simulator->nodeType);
+      break;
+    case EMBER_GET_RADIO_CHANNEL_IPC_COMMAND_ID:
+      cspEncodeUint16(&finger, simulator->channel);
+      break;
+    case EMBER_SET_RADIO_CHANNEL_IPC_COMMAND_ID:
+    case EMBER_SET_RADIO_CHANNEL_EXTENDED_IPC_COMMAND_ID:
+      simulator->channel = cspDecodeUint16(&params);
+      cspEncodeUint8(&finger, (EmberStatus)EMBER_SUCCESS);
+      break;
+    case EMBER_GET_EUI64_IPC_COMMAND_ID:
+    {
+      uint8_t eui64[EUI64_SIZE] = { 0x00, 0x0B, 0x57, 0xFF, 0xFE, 0x00, 0x00, (uint8_t)(simulator - simulators) };
+      cspEncodeBuffer(&finger, eui64, EUI64_SIZE);
+      break;
+    }
+    case EMBER_GET_MAXIMUM_PAYLOAD_LENGTH_IPC_COMMAND_ID:
+      params += 3; // srcAddressMode, dstAddressMode, interpan
+      cspEncodeUint16(&finger, (uint16_t)(cspDecodeUint8(&params)
+                                          ? EMBER_MAX_SECURED_APPLICATION_PAYLOAD_LENGTH
+                                          : EMBER_MAX_UNSECURED_APPLICATION_PAYLOAD_LENGTH));
+      break;
+    case EMBER_NCP_SET_LONG_MESSAGES_USE_IPC_COMMAND_ID:
+      simulator->longMessages = cspDecodeUint8(&params);
+      cspEncodeUint8(&finger, (EmberStatus)EMBER_SUCCESS);
+      break;
+    case EMBER_USING_LONG_MESSAGES_IPC_COMMAND_ID:
+      cspEncodeUint8(&finger, simulator->longMessages);
+      break;
+    case EMBER_NCP_SET_SEQUENCE_NUMBERS_USE_IPC_COMMAND_ID:
+      simulator->sequenceNumbers = cspDecodeUint8(&params);
+      cspEncodeUint8(&finger, (EmberStatus)EMBER_SUCCESS);
+      break;
+    case EMBER_FORM_NETWORK_IPC_COMMAND_ID:
+    case EMBER_MAC_FORM_NETWORK_IPC_COMMAND_ID:
+      setNetwork(simulator, EMBER_STAR_COORDINATOR, 0x0000, &params);
+      cspEncodeUint8(&finger, (EmberStatus)EMBER_SUCCESS);
+      indication = EMBER_NETWORK_UP;
+      break;
+    case EMBER_JOIN_NETWORK_EXTENDED_IPC_COMMAND_ID:
+    case EMBER_JOIN_COMMISSIONED_IPC_COMMAND_ID:
+    {
+      EmberNodeType nodeType = cspDecodeUint8(&params);
+      EmberNodeId nodeId = cspDecodeUint16(&params);
+      setNetwork(simulator, nodeType, nodeId, &params);
+      cspEncodeUint8(&finger, (EmberStatus)EMBER_SUCCESS);
+      indication = EMBER_NETWORK_UP;
+      break;
+    }
+    case EMBER_JOIN_NETWORK_IPC_COMMAND_ID:
+      setNetwork(simulator, cspDecodeUint8(&params), 0x0001, &params);
+      cspEncodeUint8(&finger, (EmberStatus)EMBER_SUCCESS);
+      indication = EMBER_NETWORK_UP;
+      break;
+    case EMBER_NETWORK_INIT_IPC_COMMAND_ID:
+      if (simulator->networkState == EMBER_JOINED_NETWORK) {
+        cspEncodeUint8(&finger, (EmberStatus)EMBER_SUCCESS);
+        indication = EMBER_NETWORK_UP;
+      } else {
+        cspEncodeUint8(&finger, (EmberStatus)EMBER_NOT_JOINED);
+      }
+      break;
+    case EMBER_NETWORK_LEAVE_IPC_COMMAND_ID:
+    case EMBER_RESET_NETWORK_STATE_IPC_COMMAND_ID:
+      if (identifier == EMBER_NETWORK_LEAVE_IPC_COMMAND_ID) {
+        cspEncodeUint8(&finger, (EmberStatus)EMBER_SUCCESS);
+      }
+      if (simulator->networkState == EMBER_JOINED_NETWORK) {
+        indication = EMBER_NETWORK_DOWN;
+      }
+      simulator->networkState = EMBER_NO_NETWORK;
+      simulator->nodeType = EMBER_UNKNOWN_DEVICE;
+      simulator->nodeId = EMBER_NULL_NODE_ID;
+      break;
+    case EMBER_MESSAGE_SEND_IPC_COMMAND_ID:
+      cspEncodeUint8(&finger, (EmberStatus)EMBER_SUCCESS);
+      messageSent = true;
+      break;
+    default:
+    {
+      const char *format = ((identifier & 0xFF00) == VNCP_CMD_ID) ? responseFormats[identifier & 0xFF] : NULL;
+      if (format == NULL) {
+        WARN("NCP simulator: unknown command %s", tr_csp_id(identifier));
+        format = "";
+      }
+      for (; *format != '\0'; format++) {
+        switch (*format) {
+          case 'u':
+          case 's':
+            cspEncodeUint8(&finger, (uint8_t)0);
+            break;
+          case 'v':
+            cspEncodeUint16(&finger, (uint16_t)0);
+            break;
+          case 'w':
+            cspEncodeUint32(&finger, (uint32_t)0);
+            break;
+          case 'b':
+            cspEncodeBuffer(&finger, NULL, 0);
+            break;
+          default:
+            BUG("Unknown response format '%c'", *format);
+        }
+      }
+      break;
+    }
+  }
+  // The response carries the sequence number of the command
+  if (sequenced && length > sizeof(uint16_t)) {
+    cspEncodeUint8(&finger, command[length - 1]);
+  }
+  sendFrame(simulator, response, finger);
+
+  if (indication != EMBER_SUCCESS) {
+    sendStackStatus(simulator, indication);
+  }
+  if (messageSent) {
+    sendMessageSent(simulator, params);
+  }
+}
+
+static void *simulatorThread(void *arg)
+{
+  NcpSimulator *simulator = (NcpSimulator *)arg;
+  uint8_t command[MAX_STACK_API_COMMAND_SIZE];
+  struct pollfd fds = { .fd = simulator->ncpFd, .events = POLLIN };
+
+  // The encoding of lengths follows the long message use of the host
+  sl_connect_ncp_select_instance(simulator->instance);
+  simulator->nextIndicationUs = monotonicUs() + simulator->config.indication_period_us;
+  for (;;) {
+    int timeout = -1;
+    if (simulator->config.indication_period_us > 0) {
+      uint64_t now = monotonicUs();
+      timeout = (simulator->nextIndicationUs > now) ? (int)((simulator->nextIndicationUs - now + 999) / 1000) : 0;
+    }
+    int ret = poll(&fds, 1, timeout);
+    if (ret < 0 && errno != EINTR) {
+      FATAL(1, "NCP simulator: poll failed: %s", strerror(errno));
+    }
+    if (ret > 0) {
+      ssize_t length = recv(simulator->ncpFd, command, sizeof(command), 0);
+      if (length <= 0) {
+        break;
+      }
+      handleCommand(simulator, command, length);
+    }
+    if (simulator->config.indication_period_us > 0 && monotonicUs() >= simulator->nextIndicationUs) {
+      sendIncomingMessage(simulator);
+      simulator->nextIndicationUs += simulator->config.indication_period_us;
+    }
+  }
+  return NULL;
+}
+
+static int simulatorOpen(void *context)
+{
+  return ((NcpSimulator *)context)->hostFd;
+}
+
+static int simulatorWrite(void *context, const void *frame, unsigned int length)
+{
+  return send(((NcpSimulator *)context)->hostFd, frame, length, MSG_NOSIGNAL);
+}
+
+static int simulatorRead(void *context, void *frame, unsigned int capacity)
+{
+  return recv(((NcpSimulator *)context)->hostFd, frame, capacity, 0);
+}
+
+static const char *simulatorGetVersion(void *context)
+{
+  (void)context;
+  return "simulator";
+}
+
+sl_connect_ncp_instance_t *sl_connect_ncp_init_simulator(const sl_connect_ncp_simulator_config_t *config)
+{
+  int fds[2];
+
+  pthread_mutex_lock(&simulatorLock);
+  if (simulatorCount >= SL_CONNECT_NCP_MAX_INSTANCES) {
+    FATAL(1, "Too many simulated NCPs (%d max)", SL_CONNECT_NCP_MAX_INSTANCES);
+  }
+  NcpSimulator *simulator = &simulators[simulatorCount++];
+  pthread_mutex_unlock(&simulatorLock);
+
+  if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, fds) < 0) {
+    FATAL(1, "NCP simulator: socketpair failed: %s", strerror(errno));
+  }
+  simulator->config = *config;
+  simulator->hostFd = fds[0];
+  simulator->ncpFd = fds[1];
+  simulator->networkState = EMBER_NO_NETWORK;
+  simulator->nodeId = EMBER_NULL_NODE_ID;
+
+  sl_connect_ncp_transport_t transport = {
+    .open = simulatorOpen,
+    .write = simulatorWrite,
+    .read = simulatorRead,
+    .get_version = simulatorGetVersion,
+    .context = simulator,
+  };
+  simulator->instance = sl_connect_ncp_init_instance_with_transport(&transport);
+
+  if (pthread_create(&simulator->thread, NULL, simulatorThread, simulator) != 0) {
+    FATAL(1, "NCP simulator: thread creation failed");
+  }
+  return simulator->instance;
+}
+
+void sl_connect_ncp_simulator_inject(sl_connect_ncp_instance_t *instance, const uint8_t *frame, uint16_t length)
+{
+  for (uint8_t i = 0; i < simulatorCount; i++) {
+    if (simulators[i].instance == instance) {
+      sendFrame(&simulators[i], frame, frame + length);
+      return;
+    }
+  }
+  BUG("Instance is not simulated");
+}
@@ -66,6 +66,9 @@
 
 #define MAXIMUM_IMAGE_SIZE (0xFFFE * MAX_SEGMENT_PAYLOAD_LENGTH)
 
+// Maximum number of segments tracked at once (window of outstanding segments).
+#define MAX_SEGMENTS_IN_A_BLOCK           32
+
 // (Max) length of a missing segments bitmask in bytes.
 #define MISSING_SEGMENTS_BITMASK_LENGTH   (MAX_SEGMENTS_IN_A_BLOCK / 8)
 
@@ -44,9 +44,24 @@
 
 // <o EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_TX_INTERVAL_MS> Transmission interval <25-1000>
 // <i> Default: 100
-// <i> The ota unicast bootloader server tranmission interval in milliseconds.
+// <i> The ota unicast bootloader server initial tranmission interval in milliseconds, adapted to each target afterwards. Image distributions with a window of several segments start with no interval, and fall back to at least this one with stop-and-wait targets.
 #define EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_TX_INTERVAL_MS       (100)
 
+// <o EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_SESSIONS> Maximum concurrent sessions <1-255>
+// <i> Default: 32
+// <i> The maximum number of targets the ota unicast bootloader server can serve at the same time (image distribution or bootload request).
+#define EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_SESSIONS         (32)
+
+// <o EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_WINDOW_SIZE> Segment window size <1-32>
+// <i> Default: 4
+// <i> The maximum number of image segments sent to a target and not yet acknowledged. Unacknowledged segments are retransmitted selectively. A value of 1 selects the stop-and-wait behavior, which the server also falls back to if the target reports an out of sequence segment.
+#define EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_WINDOW_SIZE            (4)
+
+// <o EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_JOURNAL_CHECKPOINT_SEGMENTS> Resume journal checkpoint interval <1-65535>
+// <i> Default: 16
+// <i> When the resume journal is enabled, the progress of an image distribution is written to the journal every time the target acknowledged this number of segments.
+#define EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_JOURNAL_CHECKPOINT_SEGMENTS (16)
+
 // </h>
 
 // <<< end of configuration section >>>
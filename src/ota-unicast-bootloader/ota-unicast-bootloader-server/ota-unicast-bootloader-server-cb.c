@@ -31,6 +31,8 @@
 #include <connect/ota-unicast-bootloader-server.h>
 #include <connect/callback_dispatcher.h>
 
+#include "ota-unicast-bootloader-server-internal.h"
+
 //------------------------------------------------------------------------------
 // Weak callbacks definitions
 
@@ -41,12 +43,11 @@ __attribute__ ((weak)) bool emberAfPluginOtaUnicastBootloaderServerGetImageSegme
   uint8_t *imageSegment
   )
 {
-  (void)startIndex;
-  (void)endIndex;
-  (void)imageTag;
-  (void)imageSegment;
-
-  return false;
+  // Read the image set with emberAfPluginOtaUnicastBootloaderServerSetImageSource()
+  return emAfPluginOtaUnicastBootloaderServerReadTaggedImageSegment(startIndex,
+                                                                    endIndex,
+                                                                    imageTag,
+                                                                    imageSegment);
 }
 
 __attribute__ ((weak)) void emberAfPluginOtaUnicastBootloaderServerImageDistributionCompleteCallback(
@@ -60,3 +61,19 @@ __attribute__ ((weak)) void emberAfPluginOtaUnicastBootloaderServerRequestTarget
 {
   (void)status;
 }
+
+__attribute__ ((weak)) void emberAfPluginOtaUnicastBootloaderServerTargetImageDistributionCompleteCallback(
+  EmberNodeId targetId,
+  EmberAfOtaUnicastBootloaderStatus status)
+{
+  (void)targetId;
+  emberAfPluginOtaUnicastBootloaderServerImageDistributionCompleteCallback(status);
+}
+
+__attribute__ ((weak)) void emberAfPluginOtaUnicastBootloaderServerTargetRequestTargetBootloadCompleteCallback(
+  EmberNodeId targetId,
+  EmberAfOtaUnicastBootloaderStatus status)
+{
+  (void)targetId;
+  emberAfPluginOtaUnicastBootloaderServerRequestTargetBootloadCompleteCallback(status);
+}
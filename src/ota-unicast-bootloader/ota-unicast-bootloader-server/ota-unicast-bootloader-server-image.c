@@ -0,0 +1,291 @@
+/***************************************************************************//**
+ * @brief Memory mapped image sources for ota unicast bootloader servers.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <connect/ember.h>
+#include <connect/ota-unicast-bootloader-server.h>
+
+#include "ota-unicast-bootloader-server-internal.h"
+#include "log/log.h"
+
+// Number of bytes the kernel is asked to read ahead of the segment being sent
+#define IMAGE_READAHEAD_LENGTH (64 * 1024)
+
+// 32 bits FNV-1a
+#define IMAGE_HASH_OFFSET_BASIS 0x811C9DC5UL
+#define IMAGE_HASH_PRIME        0x01000193UL
+
+struct EmberAfOtaUnicastBootloaderImage {
+  const uint8_t *data;
+  uint32_t size;
+  // The same file (and version of the file) is only mapped once
+  dev_t device;
+  ino_t inode;
+  struct timespec modificationTime;
+  unsigned int references;
+  // Last range for which readahead has been requested
+  uint32_t readaheadStart;
+  uint32_t readaheadEnd;
+  // Hash of the image, computed by the first distribution recorded in the
+  // journal. The mapped file does not change, so neither does its hash.
+  bool hashed;
+  uint32_t hash;
+  EmberAfOtaUnicastBootloaderImage *next;
+};
+
+static EmberAfOtaUnicastBootloaderImage *openImages;
+static pthread_mutex_t imagesLock = PTHREAD_MUTEX_INITIALIZER;
+
+// Image used by the default image segment callback, per image tag
+static EmberAfOtaUnicastBootloaderImage *taggedImages[256];
+
+//------------------------------------------------------------------------------
+// Public APIs
+
+EmberAfOtaUnicastBootloaderImage *emberAfPluginOtaUnicastBootloaderServerOpenImage(const char *path)
+{
+  EmberAfOtaUnicastBootloaderImage *image;
+  struct stat st;
+  void *data;
+  int fd;
+
+  fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    WARN("Can't open image %s", path);
+    return NULL;
+  }
+  if (fstat(fd, &st) < 0 || st.st_size == 0 || st.st_size > UINT32_MAX) {
+    WARN("Invalid image %s", path);
+    close(fd);
+    return NULL;
+  }
+
+  pthread_mutex_lock(&imagesLock);
+  for (image = openImages; image != NULL; image = image->next) {
+    if (image->device == st.st_dev
+        && image->inode == st.st_ino
+        && image->size == st.st_size
+        && image->modificationTime.tv_sec == st.st_mtim.tv_sec
+        && image->modificationTime.tv_nsec == st.st_mtim.tv_nsec) {
+      image->references++;
+      pthread_mutex_unlock(&imagesLock);
+      close(fd);
+      return image;
+    }
+  }
+
+  // A shared read-only mapping: all the transfers read the page cache copy.
+  // A private mapping would not protect against a file modified in place
+  // either, its pages are not copied until written. The file must be
+  // replaced by a rename, see emberAfPluginOtaUnicastBootloaderServerOpenImage().
+  data = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    pthread_mutex_unlock(&imagesLock);
+    WARN("Can't map image %s", path);
+    return NULL;
+  }
+  // Segments are read in order, let the kernel read ahead aggressively
+  madvise(data, st.st_size, MADV_SEQUENTIAL);
+
+  image = calloc(1, sizeof(EmberAfOtaUnicastBootloaderImage));
+  FATAL_ON(image == NULL, 1, "Can't allocate image");
+  image->data = data;
+  image->size = st.st_size;
+  image->device = st.st_dev;
+  image->inode = st.st_ino;
+  image->modificationTime = st.st_mtim;
+  image->references = 1;
+  image->next = openImages;
+  openImages = image;
+  pthread_mutex_unlock(&imagesLock);
+
+  return image;
+}
+
+void emberAfPluginOtaUnicastBootloaderServerCloseImage(EmberAfOtaUnicastBootloaderImage *image)
+{
+  EmberAfOtaUnicastBootloaderImage **finger;
+
+  if (image == NULL) {
+    return;
+  }
+
+  pthread_mutex_lock(&imagesLock);
+  if (--image->references > 0) {
+    pthread_mutex_unlock(&imagesLock);
+    return;
+  }
+  for (finger = &openImages; *finger != image; finger = &(*finger)->next) {
+  }
+  *finger = image->next;
+  for (unsigned int i = 0; i < 256; i++) {
+    if (taggedImages[i] == image) {
+      taggedImages[i] = NULL;
+    }
+  }
+  pthread_mutex_unlock(&imagesLock);
+
+  munmap((void *)image->data, image->size);
+  free(image);
+}
+
+uint32_t emberAfPluginOtaUnicastBootloaderServerGetImageSize(const EmberAfOtaUnicastBootloaderImage *image)
+{
+  return image->size;
+}
+
+bool emberAfPluginOtaUnicastBootloaderServerReadImageSegment(EmberAfOtaUnicastBootloaderImage *image,
+                                                             uint32_t startIndex,
+                                                             uint32_t endIndex,
+                                                             uint8_t *imageSegment)
+{
+  if (image == NULL
+      || imageSegment == NULL
+      || startIndex > endIndex
+      || endIndex >= image->size) {
+    return false;
+  }
+
+  // Ask for the next pages before they are needed. This is only a hint, so a
+  // racy update by concurrent transfers of the same image does no harm.
+  if ((endIndex + IMAGE_READAHEAD_LENGTH / 2 >= image->readaheadEnd
+       && image->readaheadEnd < image->size)
+      || startIndex < image->readaheadStart) {
+    uint32_t pageSize = (uint32_t)sysconf(_SC_PAGESIZE);
+    uint32_t offset = startIndex & ~(pageSize - 1);
+    uint32_t length = IMAGE_READAHEAD_LENGTH;
+
+    if (offset + length > image->size) {
+      length = image->size - offset;
+    }
+    madvise((void *)(image->data + offset), length, MADV_WILLNEED);
+    image->readaheadStart = offset;
+    image->readaheadEnd = offset + length;
+  }
+
+  memcpy(imageSegment, image->data + startIndex, endIndex - startIndex + 1);
+  return true;
+}
+
+void emberAfPluginOtaUnicastBootloaderServerSetImageSource(uint8_t imageTag,
+                                                           EmberAfOtaUnicastBootloaderImage *image)
+{
+  pthread_mutex_lock(&imagesLock);
+  taggedImages[imageTag] = image;
+  pthread_mutex_unlock(&imagesLock);
+}
+
+//------------------------------------------------------------------------------
+// Internal APIs
+
+static uint32_t hashImageData(uint32_t hash, const uint8_t *data, uint32_t length)
+{
+  for (uint32_t i = 0; i < length; i++) {
+    hash = (hash ^ data[i]) * IMAGE_HASH_PRIME;
+  }
+  return hash;
+}
+
+// Used by the default image segment callback
+bool emAfPluginOtaUnicastBootloaderServerReadTaggedImageSegment(uint32_t startIndex,
+                                                                uint32_t endIndex,
+                                                                uint8_t imageTag,
+                                                                uint8_t *imageSegment)
+{
+  EmberAfOtaUnicastBootloaderImage *image;
+  bool ret;
+
+  // The lock keeps the image mapped while it is read
+  pthread_mutex_lock(&imagesLock);
+  image = taggedImages[imageTag];
+  ret = emberAfPluginOtaUnicastBootloaderServerReadImageSegment(image, startIndex, endIndex, imageSegment);
+  pthread_mutex_unlock(&imagesLock);
+  return ret;
+}
+
+// Identifies the image distributed for a tag, to resume a distribution only if
+// the image did not change. Images without an image source are read through
+// the image segment callback.
+bool emAfPluginOtaUnicastBootloaderServerHashImage(uint8_t imageTag,
+                                                   uint32_t imageSize,
+                                                   uint32_t *imageHash)
+{
+  uint8_t segment[MAX_SEGMENT_PAYLOAD_LENGTH];
+  EmberAfOtaUnicastBootloaderImage *image;
+  uint32_t hash = IMAGE_HASH_OFFSET_BASIS;
+
+  pthread_mutex_lock(&imagesLock);
+  image = taggedImages[imageTag];
+  if (image != NULL) {
+    if (image->size != imageSize) {
+      pthread_mutex_unlock(&imagesLock);
+      return false;
+    }
+    if (image->hashed) {
+      *imageHash = image->hash;
+      pthread_mutex_unlock(&imagesLock);
+      return true;
+    }
+    // The reference keeps the image mapped while it is hashed without the
+    // lock, so that the segments of other distributions can still be read.
+    // Concurrent first hashes of an image compute the same value.
+    image->references++;
+    pthread_mutex_unlock(&imagesLock);
+    hash = hashImageData(hash, image->data, image->size);
+    pthread_mutex_lock(&imagesLock);
+    image->hash = hash;
+    image->hashed = true;
+    pthread_mutex_unlock(&imagesLock);
+    emberAfPluginOtaUnicastBootloaderServerCloseImage(image);
+    *imageHash = hash;
+    return true;
+  }
+  pthread_mutex_unlock(&imagesLock);
+
+  for (uint32_t startIndex = 0; startIndex < imageSize; startIndex += MAX_SEGMENT_PAYLOAD_LENGTH) {
+    uint32_t endIndex = startIndex + MAX_SEGMENT_PAYLOAD_LENGTH - 1;
+
+    if (endIndex >= imageSize) {
+      endIndex = imageSize - 1;
+    }
+    if (!emberAfPluginOtaUnicastBootloaderServerGetImageSegmentCallback(startIndex, endIndex, imageTag, segment)) {
+      return false;
+    }
+    hash = hashImageData(hash, segment, endIndex - startIndex + 1);
+  }
+  *imageHash = hash;
+  return true;
+}
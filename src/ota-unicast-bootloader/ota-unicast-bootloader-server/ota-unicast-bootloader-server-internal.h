@@ -30,6 +30,7 @@
 #ifndef _OTA_UNICAST_BOOTLOADER_SERVER_INTERNAL_H_
 #define _OTA_UNICAST_BOOTLOADER_SERVER_INTERNAL_H_
 
+#include <connect/ncp.h>
 #include <connect/ota-unicast-bootloader-protocol.h>
 #include "ota-unicast-bootloader/ota-unicast-bootloader-common-internal.h"
 
@@ -49,23 +50,54 @@
 #define STATE_OTA_SERVER_HANDSHAKE_PENDING                                  0x0A
 #define STATE_OTA_SERVER_HANDSHAKE_WAITING_RESPONSE                         0x0B
 
-#define serverIsIdle()  (internalState == STATE_OTA_SERVER_IDLE)
+#define serverIsIdle(session)  ((session)->internalState == STATE_OTA_SERVER_IDLE)
 
 #define serverIsCompletingProcess() \
   (processCompleteState != STATE_OTA_SERVER_IDLE)
 
-#define serverInImageDistributionProcess()                    \
-  (internalState >= STATE_OTA_SERVER_SEGMENT_UNICAST_INTERVAL \
-   && internalState <= STATE_OTA_SERVER_SEGMENT_UNICAST_WAITING_RESPONSE)
+#define serverInImageDistributionProcess(session)                                       \
+  (((session)->internalState >= STATE_OTA_SERVER_SEGMENT_UNICAST_INTERVAL               \
+    && (session)->internalState <= STATE_OTA_SERVER_SEGMENT_UNICAST_WAITING_RESPONSE)   \
+   || ((session)->internalState >= STATE_OTA_SERVER_HANDSHAKE_INTERVAL                  \
+       && (session)->internalState <= STATE_OTA_SERVER_HANDSHAKE_WAITING_RESPONSE))
 
 #define serverCompletingDistributionProcess() \
   (processCompleteState == STATE_OTA_SERVER_IMAGE_DISTRIBUTION_COMPLETED)
 
-#define serverInBootloadRequestProcess()                               \
-  (internalState >= STATE_OTA_SERVER_BOOTLOAD_REQUEST_UNICAST_INTERVAL \
-   && internalState <= STATE_OTA_SERVER_BOOTLOAD_REQUEST_WAITING_RESPONSE)
+#define serverInBootloadRequestProcess(session)                                   \
+  ((session)->internalState >= STATE_OTA_SERVER_BOOTLOAD_REQUEST_UNICAST_INTERVAL \
+   && (session)->internalState <= STATE_OTA_SERVER_BOOTLOAD_REQUEST_WAITING_RESPONSE)
 
 #define serverCompletingBootloadRequestProcess() \
   (processCompleteState == STATE_OTA_SERVER_BOOTLOAD_REQUEST_COMPLETED)
 
+//------------------------------------------------------------------------------
+// Image sources
+
+bool emAfPluginOtaUnicastBootloaderServerReadTaggedImageSegment(uint32_t startIndex,
+                                                                uint32_t endIndex,
+                                                                uint8_t imageTag,
+                                                                uint8_t *imageSegment);
+bool emAfPluginOtaUnicastBootloaderServerHashImage(uint8_t imageTag,
+                                                   uint32_t imageSize,
+                                                   uint32_t *imageHash);
+
+//------------------------------------------------------------------------------
+// Resume journal
+
+bool emAfPluginOtaUnicastBootloaderServerJournalEnabled(void);
+void emAfPluginOtaUnicastBootloaderServerJournalCheckpoint(EmberNodeId target,
+                                                           sl_connect_ncp_instance_t *instance,
+                                                           uint8_t imageTag,
+                                                           uint32_t imageSize,
+                                                           uint32_t imageHash,
+                                                           uint32_t segment);
+void emAfPluginOtaUnicastBootloaderServerJournalRemove(EmberNodeId target,
+                                                       sl_connect_ncp_instance_t *instance);
+EmberAfOtaUnicastBootloaderStatus emAfPluginOtaUnicastBootloaderServerResumeImageDistribution(EmberNodeId target,
+                                                                                             uint32_t imageSize,
+                                                                                             uint8_t imageTag,
+                                                                                             uint32_t imageHash,
+                                                                                             uint32_t segment);
+
 #endif // _OTA_UNICAST_BOOTLOADER_SERVER_INTERNAL_H_
@@ -0,0 +1,306 @@
+/***************************************************************************//**
+ * @brief Resume journal of the ota unicast bootloader server.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <connect/ember.h>
+#include <connect/ncp.h>
+#include <connect/ota-unicast-bootloader-server.h>
+
+#include "config/ota-unicast-bootloader-server-config.h"
+#include "ota-unicast-bootloader-server-internal.h"
+#include "host-common/ncp-host-common.h"
+#include "log/log.h"
+
+#define JOURNAL_HEADER "# ota unicast bootloader server journal v2\n"
+
+// The journal is a text file with one line per image distribution in progress:
+//   <target> <image tag> <image size> <image hash> <last acknowledged segment> <NCP instance>
+// The lines of a v1 journal have no instance, they belong to the first one.
+typedef struct {
+  EmberNodeId targetId;
+  uint8_t instance;
+  uint8_t imageTag;
+  uint32_t imageSize;
+  uint32_t imageHash;
+  uint32_t segment;
+} JournalEntry;
+
+static JournalEntry entries[EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_SESSIONS];
+static uint8_t entriesCount;
+static char *journalPath;
+static pthread_mutex_t journalLock = PTHREAD_MUTEX_INITIALIZER;
+
+// Makes the rename of the journal durable
+static int syncJournalDirectory(void)
+{
+  char pathCopy[strlen(journalPath) + 1];
+  int fd, ret;
+
+  strcpy(pathCopy, journalPath);
+  fd = open(dirname(pathCopy), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0) {
+    return -1;
+  }
+  ret = fsync(fd);
+  close(fd);
+  return ret;
+}
+
+// Must be called with journalLock held. The file is written and synced under
+// a temporary name then renamed, so that neither an interruption nor a power
+// loss leaves a partially written journal.
+static bool writeJournal(void)
+{
+  char tmpPath[strlen(journalPath) + sizeof(".tmp")];
+  FILE *file;
+  int ret;
+
+  snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", journalPath);
+  file = fopen(tmpPath, "w");
+  if (file == NULL) {
+    WARN("Can't write journal %s: %m", tmpPath);
+    return false;
+  }
+  fputs(JOURNAL_HEADER, file);
+  for (uint8_t i = 0; i < entriesCount; i++) {
+    fprintf(file, "%04x %02x %u %08x %u %u\n",
+            entries[i].targetId,
+            entries[i].imageTag,
+            entries[i].imageSize,
+            entries[i].imageHash,
+            entries[i].segment,
+            entries[i].instance);
+  }
+  ret = fflush(file);
+  if (ret == 0) {
+    ret = fsync(fileno(file));
+  }
+  if (fclose(file) != 0) {
+    ret = -1;
+  }
+  if (ret == 0) {
+    ret = rename(tmpPath, journalPath);
+  }
+  if (ret == 0) {
+    ret = syncJournalDirectory();
+  }
+  if (ret != 0) {
+    WARN("Can't write journal %s: %m", journalPath);
+    return false;
+  }
+  return true;
+}
+
+// Must be called with journalLock held
+static bool readJournal(void)
+{
+  unsigned int targetId, imageTag, imageSize, imageHash, segment, instance;
+  char line[128];
+  int fields;
+  FILE *file;
+
+  entriesCount = 0;
+  file = fopen(journalPath, "r");
+  if (file == NULL) {
+    // No distribution to resume
+    return errno == ENOENT;
+  }
+  while (fgets(line, sizeof(line), file) != NULL) {
+    if (line[0] == '#') {
+      continue;
+    }
+    fields = sscanf(line, "%x %x %u %x %u %u",
+                    &targetId, &imageTag, &imageSize, &imageHash, &segment, &instance);
+    if (fields == 5) {
+      instance = 0;
+    }
+    if ((fields != 5 && fields != 6)
+        || targetId >= EMBER_NULL_NODE_ID
+        || imageTag > 0xFF
+        || instance >= SL_CONNECT_NCP_MAX_INSTANCES) {
+      WARN("Ignoring invalid journal entry: %s", line);
+      continue;
+    }
+    if (entriesCount == EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_SESSIONS) {
+      WARN("Too many entries in journal %s", journalPath);
+      break;
+    }
+    entries[entriesCount].targetId = targetId;
+    entries[entriesCount].instance = instance;
+    entries[entriesCount].imageTag = imageTag;
+    entries[entriesCount].imageSize = imageSize;
+    entries[entriesCount].imageHash = imageHash;
+    entries[entriesCount].segment = segment;
+    entriesCount++;
+  }
+  fclose(file);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Public APIs
+
+EmberAfOtaUnicastBootloaderStatus emberAfPluginOtaUnicastBootloaderServerEnableJournal(const char *path)
+{
+  JournalEntry pending[EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_SESSIONS];
+  sl_connect_ncp_instance_t *callerInstance = sl_connect_ncp_get_current_instance();
+  uint8_t pendingCount;
+
+  if (path == NULL) {
+    return EMBER_OTA_UNICAST_BOOTLOADER_STATUS_INVALID_CALL;
+  }
+
+  pthread_mutex_lock(&journalLock);
+  free(journalPath);
+  journalPath = strdup(path);
+  FATAL_ON(journalPath == NULL, 1, "Can't allocate journal path");
+  if (!readJournal() || !writeJournal()) {
+    free(journalPath);
+    journalPath = NULL;
+    pthread_mutex_unlock(&journalLock);
+    return EMBER_OTA_UNICAST_BOOTLOADER_STATUS_INVALID_CALL;
+  }
+  memcpy(pending, entries, entriesCount * sizeof(JournalEntry));
+  pendingCount = entriesCount;
+  pthread_mutex_unlock(&journalLock);
+
+  // The distributions are started without journalLock, they update the journal.
+  // Each one is resumed on the NCP instance that started it.
+  for (uint8_t i = 0; i < pendingCount; i++) {
+    sl_connect_ncp_instance_t *instance = sli_connect_ncp_instance(pending[i].instance);
+    EmberAfOtaUnicastBootloaderStatus status;
+    uint32_t imageHash;
+
+    if (instance == NULL) {
+      WARN("NCP instance %u not initialized, can't resume distribution to 0x%04x",
+           pending[i].instance, pending[i].targetId);
+      continue;
+    }
+    sl_connect_ncp_select_instance(instance);
+    if (!emAfPluginOtaUnicastBootloaderServerHashImage(pending[i].imageTag, pending[i].imageSize, &imageHash)
+        || imageHash != pending[i].imageHash) {
+      WARN("Image 0x%02x changed, can't resume distribution to 0x%04x",
+           pending[i].imageTag, pending[i].targetId);
+      emAfPluginOtaUnicastBootloaderServerJournalRemove(pending[i].targetId, instance);
+      continue;
+    }
+    status = emAfPluginOtaUnicastBootloaderServerResumeImageDistribution(pending[i].targetId,
+                                                                       pending[i].imageSize,
+                                                                       pending[i].imageTag,
+                                                                       pending[i].imageHash,
+                                                                       pending[i].segment);
+    if (status == EMBER_OTA_UNICAST_BOOTLOADER_STATUS_SUCCESS) {
+      INFO("Resuming image distribution to 0x%04x after segment %u",
+           pending[i].targetId, pending[i].segment);
+    } else {
+      WARN("Can't resume image distribution to 0x%04x: 0x%x", pending[i].targetId, status);
+    }
+  }
+  sl_connect_ncp_select_instance(callerInstance);
+
+  return EMBER_OTA_UNICAST_BOOTLOADER_STATUS_SUCCESS;
+}
+
+//------------------------------------------------------------------------------
+// Internal APIs
+
+bool emAfPluginOtaUnicastBootloaderServerJournalEnabled(void)
+{
+  bool enabled;
+
+  pthread_mutex_lock(&journalLock);
+  enabled = journalPath != NULL;
+  pthread_mutex_unlock(&journalLock);
+  return enabled;
+}
+
+void emAfPluginOtaUnicastBootloaderServerJournalCheckpoint(EmberNodeId target,
+                                                           sl_connect_ncp_instance_t *instance,
+                                                           uint8_t imageTag,
+                                                           uint32_t imageSize,
+                                                           uint32_t imageHash,
+                                                           uint32_t segment)
+{
+  uint8_t index = sli_connect_ncp_instance_index(instance);
+  uint8_t i;
+
+  pthread_mutex_lock(&journalLock);
+  if (journalPath == NULL) {
+    pthread_mutex_unlock(&journalLock);
+    return;
+  }
+  for (i = 0; i < entriesCount; i++) {
+    if (entries[i].targetId == target && entries[i].instance == index) {
+      break;
+    }
+  }
+  if (i == entriesCount) {
+    if (entriesCount == EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_SESSIONS) {
+      pthread_mutex_unlock(&journalLock);
+      WARN("Journal full, distribution to 0x%04x not recorded", target);
+      return;
+    }
+    entriesCount++;
+  }
+  entries[i].targetId = target;
+  entries[i].instance = index;
+  entries[i].imageTag = imageTag;
+  entries[i].imageSize = imageSize;
+  entries[i].imageHash = imageHash;
+  entries[i].segment = segment;
+  writeJournal();
+  pthread_mutex_unlock(&journalLock);
+}
+
+void emAfPluginOtaUnicastBootloaderServerJournalRemove(EmberNodeId target,
+                                                       sl_connect_ncp_instance_t *instance)
+{
+  uint8_t index = sli_connect_ncp_instance_index(instance);
+
+  pthread_mutex_lock(&journalLock);
+  if (journalPath == NULL) {
+    pthread_mutex_unlock(&journalLock);
+    return;
+  }
+  for (uint8_t i = 0; i < entriesCount; i++) {
+    if (entries[i].targetId == target && entries[i].instance == index) {
+      entries[i] = entries[--entriesCount];
+      writeJournal();
+      break;
+    }
+  }
+  pthread_mutex_unlock(&journalLock);
+}
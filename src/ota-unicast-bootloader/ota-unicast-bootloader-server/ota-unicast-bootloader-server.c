@@ -28,17 +28,20 @@
  ******************************************************************************/
 
 #include <unistd.h>
+#include <string.h>
 #include <time.h>
 #include <math.h>
 #include <assert.h>
 #include <pthread.h>
-#include <poll.h>
-#include <sys/timerfd.h>
 #include <connect/ember.h>
+#include <connect/ncp.h>
+#include <connect/ncp-subscriptions.h>
+#include <connect/callback_dispatcher.h>
 #include <connect/ota-unicast-bootloader-server.h>
 
 #include "config/ota-unicast-bootloader-server-config.h"
 #include "ota-unicast-bootloader-server-internal.h"
+#include "host-common/timer-wheel.h"
 #include "log/log.h"
 
 // Internal Macros
@@ -49,51 +52,124 @@
 #define timeGTorEqualInt32u(t1, t2) \
   (elapsedTimeInt32u(t2, t1) <= (HALF_MAX_INT32U_VALUE))
 
-#define SLI_OTA_UNICAST_BOOTLOADER_SERVER_POLL_TIMEOUT_MS 500
+#if (EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_WINDOW_SIZE > MAX_SEGMENTS_IN_A_BLOCK)
+#error "The segment window can't exceed MAX_SEGMENTS_IN_A_BLOCK segments"
+#endif
 
 //------------------------------------------------------------------------------
 // Internal variables and static functions prototypes.
 
-static uint8_t internalState = STATE_OTA_SERVER_IDLE;
-static EmberNodeId targetId = EMBER_NULL_NODE_ID;
-
-// This is the last segment index that the client received.
-static uint32_t sentSegment;
-// This keeps track of stack errors such as send() API failures or other non-ACK
-// related failures.
-static uint8_t stackErrorsCount;
-// This keeps track of target errors such as not receiving an ACK or not
-// receiving an expected response.
-static uint8_t currentTargetErrorsCount;
-// The next segment index (if the server is currently sending segments)
-static uint32_t nextSegment;
-// Stores the current image size in bytes or the bootload time (ms).
-static uint32_t currentImageSizeOrBootloadTimeMs;
-// Stores the current image tag (image distribution process) or the or the
-// current server status (target status request process).
-static uint8_t currentImageTagOrServerStatus;
+// State of the process (image distribution or bootload request) running with
+// one target. Sessions run independently, so the segments sent to several
+// targets are interleaved.
+typedef struct {
+  uint8_t internalState;
+  EmberNodeId targetId;
+  // NCP through which the target is reached
+  sl_connect_ncp_instance_t *instance;
+
+  // This is the last segment index that the client received.
+  uint32_t sentSegment;
+  // This keeps track of stack errors such as send() API failures or other non-ACK
+  // related failures.
+  uint8_t stackErrorsCount;
+  // This keeps track of target errors such as not receiving an ACK or not
+  // receiving an expected response.
+  uint8_t currentTargetErrorsCount;
+  // The first segment index never sent (if the server is currently sending
+  // segments)
+  uint32_t nextSegment;
+  // The oldest segment not acknowledged by the target, and the first index
+  // from which unacknowledged segments are retransmitted.
+  uint32_t windowBase;
+  uint32_t retransmitSegment;
+  // Maximum number of unacknowledged segments, 1 for stop-and-wait targets
+  uint8_t windowSize;
+  // Bit n is set if the segment windowBase + n has been acknowledged.
+  uint8_t ackedSegments[MISSING_SEGMENTS_BITMASK_LENGTH];
+
+  // Adaptive pacing: the interval between transmissions shrinks additively
+  // while the target acknowledges and grows multiplicatively on failures. The
+  // response timeout follows the smoothed round trip time and its variation.
+  uint16_t txIntervalMs;
+  uint16_t responseTimeoutMs;
+  uint32_t smoothedRttMs;
+  uint32_t rttVariationMs;
+  // A single message is timed at once, never a retransmitted one. The segment
+  // is INVALID_SEGMENT_INDEX for handshakes and bootload requests.
+  bool rttTiming;
+  uint32_t rttSegment;
+  uint64_t rttStartMs;
+  // Stores the current image size in bytes or the bootload time (ms).
+  uint32_t currentImageSizeOrBootloadTimeMs;
+  // Stores the current image tag (image distribution process) or the or the
+  // current server status (target status request process).
+  uint8_t currentImageTagOrServerStatus;
+
+  // Progress of the image distribution recorded in the resume journal, if the
+  // journal is enabled.
+  bool journaled;
+  uint32_t imageHash;
+  uint32_t checkpointSegment;
+
+  // Next event of the session, if ota_event_is_active
+  sli_connect_timer_t eventTimer;
+  bool ota_event_is_active;
+} OtaServerSession;
+
+static OtaServerSession sessions[EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_SESSIONS];
+
+// Sessions are driven both by the thread handling the stack callbacks and by
+// the timer thread of the library. The lock is recursive so that the completion callbacks
+// can start a new process.
+static pthread_mutex_t serverLock;
 
 // OTA process variables
-static int timer_fd;
-static bool ota_event_is_active = false;
+static pthread_once_t serverOnce = PTHREAD_ONCE_INIT;
+
+// Session management static functions
+static OtaServerSession *findSession(EmberNodeId target);
+static OtaServerSession *allocateSession(EmberNodeId target);
+static void sessionEventHandler(OtaServerSession *session);
+static EmberAfOtaUnicastBootloaderStatus startImageDistribution(EmberNodeId target,
+                                                                uint32_t imageSize,
+                                                                uint8_t imageTag,
+                                                                bool journaled,
+                                                                uint32_t imageHash,
+                                                                uint32_t segment);
 
 // Image distribution process static functions
-static void sli_connect_ota_unicast_server_schedule_next_event(uint16_t time_ms);
-static void *sli_connect_ota_unicast_server_process_events(void *arg);
-static void scheduleImageDistributionProcessNextTask(bool newSegmentOrNewTarget);
-static void imageDistributionProcessFinished(EmberAfOtaUnicastBootloaderStatus status);
-static uint32_t getTotalSegmentsCount(void);
-static void handleSegmentResponse(EmberIncomingMessage *message);
-static void handleHandshakeResponse(EmberIncomingMessage *message,
+static void sli_connect_ota_unicast_server_schedule_next_event(OtaServerSession *session, uint16_t time_ms);
+static void sli_connect_ota_unicast_server_start(void);
+static void sessionTimerCallback(void *context);
+static void incomingMessageHandler(EmberIncomingMessage *message, void *context);
+static void messageSentHandler(EmberStatus status, EmberOutgoingMessage *message, void *context);
+static void scheduleImageDistributionProcessNextTask(OtaServerSession *session, bool newSegmentOrNewTarget);
+static void imageDistributionProcessFinished(OtaServerSession *session, EmberAfOtaUnicastBootloaderStatus status);
+static uint32_t getTotalSegmentsCount(OtaServerSession *session);
+static uint32_t getNextSegmentToSend(OtaServerSession *session);
+static void acknowledgeSegment(OtaServerSession *session, uint32_t segment);
+static void checkpointImageDistribution(OtaServerSession *session);
+
+// Adaptive pacing static functions
+static uint64_t monotonicTimeMs(void);
+static void startRttTiming(OtaServerSession *session, uint32_t segment);
+static void stopRttTiming(OtaServerSession *session, uint32_t segment, bool responded);
+static void adaptPacingOnSuccess(OtaServerSession *session);
+static void adaptPacingOnFailure(OtaServerSession *session, bool responseTimeout);
+static void handleSegmentResponse(OtaServerSession *session, EmberIncomingMessage *message);
+static void handleHandshakeResponse(OtaServerSession *session,
+                                    EmberIncomingMessage *message,
                                     uint32_t startSegment);
-static void unicastHandshake(void);
-static void unicastNextSegment(void);
+static void unicastHandshake(OtaServerSession *session);
+static void unicastNextSegment(OtaServerSession *session);
 
 // Bootload request process static functions.
-static void requestTargetForBootload(void);
-static void scheduleBootloadRequestProcessNextTask(bool targetResponeded,
+static void requestTargetForBootload(OtaServerSession *session);
+static void scheduleBootloadRequestProcessNextTask(OtaServerSession *session,
+                                                   bool targetResponeded,
                                                    uint8_t targetStatusResponse);
-static void bootloadRequestProcessFinished(EmberAfOtaUnicastBootloaderStatus status);
+static void bootloadRequestProcessFinished(OtaServerSession *session, EmberAfOtaUnicastBootloaderStatus status);
 
 //------------------------------------------------------------------------------
 // Public APIs
@@ -103,9 +179,8 @@ EmberAfOtaUnicastBootloaderStatus emberAfPluginOtaUnicastBootloaderServerInitiat
   uint32_t imageSize,
   uint8_t imageTag)
 {
-  if ( !serverIsIdle() ) {
-    return EMBER_OTA_UNICAST_BOOTLOADER_STATUS_BUSY;
-  }
+  uint32_t imageHash = 0;
+  bool journaled = false;
 
   if ((EMBER_NULL_NODE_ID == target)
       || (imageSize == 0)
@@ -113,20 +188,14 @@ EmberAfOtaUnicastBootloaderStatus emberAfPluginOtaUnicastBootloaderServerInitiat
     return EMBER_OTA_UNICAST_BOOTLOADER_STATUS_INVALID_CALL;
   }
 
-  currentImageSizeOrBootloadTimeMs = imageSize;
-  currentImageTagOrServerStatus = imageTag;
-  targetId = target;
-
-  nextSegment = 0;
-  stackErrorsCount = 0;
-  currentTargetErrorsCount = 0;
-
-  internalState = STATE_OTA_SERVER_HANDSHAKE_INTERVAL;
-
-  pthread_t image_thread;
-  pthread_create(&image_thread, NULL, sli_connect_ota_unicast_server_process_events, NULL);
+  if (emAfPluginOtaUnicastBootloaderServerJournalEnabled()) {
+    journaled = emAfPluginOtaUnicastBootloaderServerHashImage(imageTag, imageSize, &imageHash);
+    if (!journaled) {
+      WARN("Image 0x%02x can't be read, distribution to 0x%04x not recorded", imageTag, target);
+    }
+  }
 
-  return EMBER_OTA_UNICAST_BOOTLOADER_STATUS_SUCCESS;
+  return startImageDistribution(target, imageSize, imageTag, journaled, imageHash, 0);
 }
 
 EmberAfOtaUnicastBootloaderStatus emberAfPluginUnicastBootloaderServerInitiateRequestTargetBootload(
@@ -135,45 +204,99 @@ EmberAfOtaUnicastBootloaderStatus emberAfPluginUnicastBootloaderServerInitiateRe
   EmberNodeId target
   )
 {
-  if (!serverIsIdle()) {
-    return EMBER_OTA_UNICAST_BOOTLOADER_STATUS_BUSY;
-  }
+  OtaServerSession *session;
 
   if (target == EMBER_NULL_NODE_ID) {
     return EMBER_OTA_UNICAST_BOOTLOADER_STATUS_INVALID_CALL;
   }
 
-  targetId = target;
-  nextSegment = 0;
-  stackErrorsCount = 0;
-  currentTargetErrorsCount = 0;
-  currentImageTagOrServerStatus = imageTag;
+  sli_connect_ota_unicast_server_start();
+  pthread_mutex_lock(&serverLock);
+  session = allocateSession(target);
+  if (session == NULL) {
+    pthread_mutex_unlock(&serverLock);
+    return EMBER_OTA_UNICAST_BOOTLOADER_STATUS_BUSY;
+  }
+
+  session->nextSegment = 0;
+  session->stackErrorsCount = 0;
+  session->currentTargetErrorsCount = 0;
+  session->currentImageTagOrServerStatus = imageTag;
   struct timespec spec;
   clock_gettime(CLOCK_MONOTONIC, &spec);
-  currentImageSizeOrBootloadTimeMs = round(spec.tv_nsec / 1.0e6) + (spec.tv_sec * 1000)
-                                     + bootloadDelayMs;
-  internalState = STATE_OTA_SERVER_BOOTLOAD_REQUEST_UNICAST_INTERVAL;
-  pthread_t bootload_thread;
-  pthread_create(&bootload_thread, NULL, sli_connect_ota_unicast_server_process_events, NULL);
+  session->currentImageSizeOrBootloadTimeMs = round(spec.tv_nsec / 1.0e6) + (spec.tv_sec * 1000)
+                                              + bootloadDelayMs;
+  session->internalState = STATE_OTA_SERVER_BOOTLOAD_REQUEST_UNICAST_INTERVAL;
+  sli_connect_ota_unicast_server_schedule_next_event(session, 0);
+  pthread_mutex_unlock(&serverLock);
 
   return EMBER_OTA_UNICAST_BOOTLOADER_STATUS_SUCCESS;
 }
 
+EmberAfOtaUnicastBootloaderStatus emberAfPluginOtaUnicastBootloaderServerAbortTargetProcess(EmberNodeId target)
+{
+  EmberAfOtaUnicastBootloaderStatus status = EMBER_OTA_UNICAST_BOOTLOADER_STATUS_INVALID_CALL;
+  OtaServerSession *session;
+
+  sli_connect_ota_unicast_server_start();
+  pthread_mutex_lock(&serverLock);
+  session = findSession(target);
+  if (session != NULL && serverInImageDistributionProcess(session)) {
+    imageDistributionProcessFinished(session, EMBER_OTA_UNICAST_BOOTLOADER_STATUS_ABORTED);
+    status = EMBER_OTA_UNICAST_BOOTLOADER_STATUS_SUCCESS;
+  } else if (session != NULL && serverInBootloadRequestProcess(session)) {
+    bootloadRequestProcessFinished(session, EMBER_OTA_UNICAST_BOOTLOADER_STATUS_ABORTED);
+    status = EMBER_OTA_UNICAST_BOOTLOADER_STATUS_SUCCESS;
+  }
+  pthread_mutex_unlock(&serverLock);
+
+  return status;
+}
+
 EmberAfOtaUnicastBootloaderStatus emberAfPluginOtaUnicastBootloaderServerAbortCurrentProcess(void)
 {
-  if (serverInImageDistributionProcess()) {
-    imageDistributionProcessFinished(EMBER_OTA_UNICAST_BOOTLOADER_STATUS_ABORTED);
+  EmberAfOtaUnicastBootloaderStatus status = EMBER_OTA_UNICAST_BOOTLOADER_STATUS_INVALID_CALL;
+  sl_connect_ncp_instance_t *instance = sl_connect_ncp_get_current_instance();
+
+  sli_connect_ota_unicast_server_start();
+  pthread_mutex_lock(&serverLock);
+  for (uint8_t i = 0; i < EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_SESSIONS; i++) {
+    OtaServerSession *session = &sessions[i];
 
-    return EMBER_OTA_UNICAST_BOOTLOADER_STATUS_SUCCESS;
+    if (session->instance != instance) {
+      continue;
+    }
+    if (serverInImageDistributionProcess(session)) {
+      imageDistributionProcessFinished(session, EMBER_OTA_UNICAST_BOOTLOADER_STATUS_ABORTED);
+      status = EMBER_OTA_UNICAST_BOOTLOADER_STATUS_SUCCESS;
+    } else if (serverInBootloadRequestProcess(session)) {
+      bootloadRequestProcessFinished(session, EMBER_OTA_UNICAST_BOOTLOADER_STATUS_ABORTED);
+      status = EMBER_OTA_UNICAST_BOOTLOADER_STATUS_SUCCESS;
+    }
   }
+  pthread_mutex_unlock(&serverLock);
 
-  if (serverInBootloadRequestProcess()) {
-    bootloadRequestProcessFinished(EMBER_OTA_UNICAST_BOOTLOADER_STATUS_ABORTED);
+  return status;
+}
 
-    return EMBER_OTA_UNICAST_BOOTLOADER_STATUS_SUCCESS;
+//------------------------------------------------------------------------------
+// Internal APIs
+
+// Restarts a distribution recorded in the resume journal. The handshake lets
+// the target report the segment it expects.
+EmberAfOtaUnicastBootloaderStatus emAfPluginOtaUnicastBootloaderServerResumeImageDistribution(EmberNodeId target,
+                                                                                             uint32_t imageSize,
+                                                                                             uint8_t imageTag,
+                                                                                             uint32_t imageHash,
+                                                                                             uint32_t segment)
+{
+  if ((EMBER_NULL_NODE_ID == target)
+      || (imageSize == 0)
+      || (imageSize > MAXIMUM_IMAGE_SIZE)) {
+    return EMBER_OTA_UNICAST_BOOTLOADER_STATUS_INVALID_CALL;
   }
 
-  return EMBER_OTA_UNICAST_BOOTLOADER_STATUS_INVALID_CALL;
+  return startImageDistribution(target, imageSize, imageTag, true, imageHash, segment);
 }
 
 //------------------------------------------------------------------------------
@@ -181,6 +304,8 @@ EmberAfOtaUnicastBootloaderStatus emberAfPluginOtaUnicastBootloaderServerAbortCu
 
 void emAfPluginOtaUnicastBootloaderServerIncomingMessageCallback(EmberIncomingMessage *message)
 {
+  OtaServerSession *session;
+
   if (message->endpoint != EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_ENDPOINT) {
     return;
   }
@@ -192,167 +317,282 @@ void emAfPluginOtaUnicastBootloaderServerIncomingMessageCallback(EmberIncomingMe
   }
 #endif // EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_SECURITY_ENABLED > 0
 
-  // Discard all responses from nodes other than the target node.
-  if (message->source != targetId) {
+  sli_connect_ota_unicast_server_start();
+  pthread_mutex_lock(&serverLock);
+  // Discard all responses from nodes that are not a target.
+  session = findSession(message->source);
+  if (session == NULL) {
+    pthread_mutex_unlock(&serverLock);
     return;
   }
 
   switch (emOtaUnicastBootloaderProtocolCommandId(message->payload)) {
     case EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_COMMAND_ID_HANDSHAKE_RESPONSE:
       // Check the response (Expecting one? Same Tag we're distributing?)
-      if ((internalState == STATE_OTA_SERVER_HANDSHAKE_WAITING_RESPONSE)
-          && (currentImageTagOrServerStatus
+      if ((session->internalState == STATE_OTA_SERVER_HANDSHAKE_WAITING_RESPONSE)
+          && (session->currentImageTagOrServerStatus
               == message->payload[EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_HANDSHAKE_RESP_TAG_OFFSET]) ) {
-        handleHandshakeResponse(message, 0);
+        handleHandshakeResponse(session, message, 0);
       }
       break;
     case EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_COMMAND_ID_EXT_HANDSHAKE_RESPONSE:
       // Check the response (Expecting one? Same Tag we're distributing?)
-      if ((internalState == STATE_OTA_SERVER_HANDSHAKE_WAITING_RESPONSE)
-          && (currentImageTagOrServerStatus
+      if ((session->internalState == STATE_OTA_SERVER_HANDSHAKE_WAITING_RESPONSE)
+          && (session->currentImageTagOrServerStatus
               == message->payload[EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_EXT_HSHAKE_RESP_TAG_OFFSET]) ) {
         uint32_t startSegment =
           emberFetchLowHighInt32u(message->payload + EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_EXT_HSHAKE_RESP_SEGMENT_INDEX_OFFSET);
-        handleHandshakeResponse(message, startSegment);
+        handleHandshakeResponse(session, message, startSegment);
       }
       break;
     case EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_COMMAND_ID_IMAGE_SEGMENT_RESPONSE:
       // Check the response (Expecting one? Same Tag we're distributing?)
-      if ((internalState == STATE_OTA_SERVER_SEGMENT_UNICAST_PENDING
-           || internalState == STATE_OTA_SERVER_SEGMENT_UNICAST_WAITING_RESPONSE)
-          && (currentImageTagOrServerStatus == message->payload[EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_IMAGE_SEGMENT_RESP_TAG_OFFSET]) ) {
-        // Set the internal state to WAITING_RESPONSE in case we received the
-        // response before the sent() callback for the segment message.
-        internalState = STATE_OTA_SERVER_SEGMENT_UNICAST_WAITING_RESPONSE;
-        handleSegmentResponse(message);
+      // Responses may come for any segment of the window, including before the
+      // sent() callback of the segment message.
+      if ((session->internalState >= STATE_OTA_SERVER_SEGMENT_UNICAST_INTERVAL
+           && session->internalState <= STATE_OTA_SERVER_SEGMENT_UNICAST_WAITING_RESPONSE)
+          && (session->currentImageTagOrServerStatus == message->payload[EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_IMAGE_SEGMENT_RESP_TAG_OFFSET]) ) {
+        handleSegmentResponse(session, message);
       }
       break;
     case EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_COMMAND_ID_BOOTLOAD_RESPONSE:
-      if ((internalState == STATE_OTA_SERVER_BOOTLOAD_REQUEST_WAITING_RESPONSE)
+      if ((session->internalState == STATE_OTA_SERVER_BOOTLOAD_REQUEST_WAITING_RESPONSE)
           && (message->length == EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_BOOTLOAD_RESP_HEADER_LENGTH)) {
         uint8_t targetResponseStatus =
           emOtaUnicastBootloaderProtocolResponseStatus(message->payload);
-        scheduleBootloadRequestProcessNextTask(true, targetResponseStatus);
+        stopRttTiming(session, INVALID_SEGMENT_INDEX, true);
+        scheduleBootloadRequestProcessNextTask(session, true, targetResponseStatus);
       }
       break;
   }
+  pthread_mutex_unlock(&serverLock);
 }
 
 void emAfPluginOtaUnicastBootloaderServerMessageSentCallback(EmberStatus status,
                                                              EmberOutgoingMessage *message)
 {
+  OtaServerSession *session;
+
   if (message->endpoint != EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_ENDPOINT) {
     return;
   }
 
+  sli_connect_ota_unicast_server_start();
+  pthread_mutex_lock(&serverLock);
+  session = findSession(message->destination);
+  if (session == NULL) {
+    pthread_mutex_unlock(&serverLock);
+    return;
+  }
+
   switch (emOtaUnicastBootloaderProtocolCommandId(message->payload)) {
     case EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_COMMAND_ID_HANDSHAKE:
-      if (internalState != STATE_OTA_SERVER_HANDSHAKE_PENDING) {
-        return;
+      if (session->internalState != STATE_OTA_SERVER_HANDSHAKE_PENDING) {
+        break;
       }
 
       if (status == EMBER_SUCCESS) {
         // Message was sent out successfully, bump segment counter and reset the
         // tx error counter.
-        stackErrorsCount = 0;
-        internalState = STATE_OTA_SERVER_HANDSHAKE_WAITING_RESPONSE;
-        sli_connect_ota_unicast_server_schedule_next_event(EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_RESPONSE_TIMEOUT_MS);
+        session->stackErrorsCount = 0;
+        session->internalState = STATE_OTA_SERVER_HANDSHAKE_WAITING_RESPONSE;
+        sli_connect_ota_unicast_server_schedule_next_event(session, session->responseTimeoutMs);
       } else {
         // If the message was sent out but no ACK was received we increase the
         // target error count and reset the stack errors count.
         if (status == EMBER_MAC_NO_ACK_RECEIVED) {
-          currentTargetErrorsCount++;
-          stackErrorsCount = 0;
+          session->currentTargetErrorsCount++;
+          session->stackErrorsCount = 0;
         } else {
           // If the message was not sent out because of a stack issue (CCA or
           // others), we bump the stack errors count.
-          stackErrorsCount++;
+          session->stackErrorsCount++;
         }
-        internalState = STATE_OTA_SERVER_HANDSHAKE_INTERVAL;
-        scheduleImageDistributionProcessNextTask(false);
+        adaptPacingOnFailure(session, false);
+        session->internalState = STATE_OTA_SERVER_HANDSHAKE_INTERVAL;
+        scheduleImageDistributionProcessNextTask(session, false);
       }
       break;
 
     case EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_COMMAND_ID_IMAGE_SEGMENT:
-      if (internalState != STATE_OTA_SERVER_SEGMENT_UNICAST_PENDING) {
-        return;
+      if (session->internalState != STATE_OTA_SERVER_SEGMENT_UNICAST_PENDING) {
+        break;
       }
 
       if (status == EMBER_SUCCESS) {
-        // Message was sent out successfully, bump segment counter and reset the
-        // tx  error counter.
-        stackErrorsCount = 0;
-        internalState = STATE_OTA_SERVER_SEGMENT_UNICAST_WAITING_RESPONSE;
-        sli_connect_ota_unicast_server_schedule_next_event(EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_RESPONSE_TIMEOUT_MS);
+        // Message was sent out successfully, reset the tx error counter. Keep
+        // sending while the window is open, otherwise wait for the responses.
+        session->stackErrorsCount = 0;
+        if (getNextSegmentToSend(session) != INVALID_SEGMENT_INDEX) {
+          session->internalState = STATE_OTA_SERVER_SEGMENT_UNICAST_INTERVAL;
+          sli_connect_ota_unicast_server_schedule_next_event(session, session->txIntervalMs);
+        } else {
+          session->internalState = STATE_OTA_SERVER_SEGMENT_UNICAST_WAITING_RESPONSE;
+          sli_connect_ota_unicast_server_schedule_next_event(session, session->responseTimeoutMs);
+        }
       } else {
         // If the message was sent out but no ACK was received we increase the
         // target error count  and reset the stack errors count.
         if (status == EMBER_MAC_NO_ACK_RECEIVED) {
-          currentTargetErrorsCount++;
-          stackErrorsCount = 0;
+          session->currentTargetErrorsCount++;
+          session->stackErrorsCount = 0;
         } else {
           // If the message was not sent out because of a stack issue (CCA or
           // others), we bump the stack errors count.
-          stackErrorsCount++;
+          session->stackErrorsCount++;
+        }
+        adaptPacingOnFailure(session, false);
+        // Retransmit the segment
+        if (session->sentSegment < session->retransmitSegment) {
+          session->retransmitSegment = session->sentSegment;
         }
-        internalState = STATE_OTA_SERVER_SEGMENT_UNICAST_INTERVAL;
-        scheduleImageDistributionProcessNextTask(false);
+        session->internalState = STATE_OTA_SERVER_SEGMENT_UNICAST_INTERVAL;
+        scheduleImageDistributionProcessNextTask(session, false);
       }
       break;
     case EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_COMMAND_ID_BOOTLOAD_REQUEST:
-      if (internalState != STATE_OTA_SERVER_BOOTLOAD_REQUEST_UNICAST_PENDING) {
-        return;
+      if (session->internalState != STATE_OTA_SERVER_BOOTLOAD_REQUEST_UNICAST_PENDING) {
+        break;
       }
 
       if (status == EMBER_SUCCESS) {
         // Message was sent out successfully, wait for the corresponding bootload
         // response  and reset the stack errors count.
-        internalState = STATE_OTA_SERVER_BOOTLOAD_REQUEST_WAITING_RESPONSE;
-        sli_connect_ota_unicast_server_schedule_next_event(EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_RESPONSE_TIMEOUT_MS);
-        stackErrorsCount = 0;
+        session->internalState = STATE_OTA_SERVER_BOOTLOAD_REQUEST_WAITING_RESPONSE;
+        sli_connect_ota_unicast_server_schedule_next_event(session, session->responseTimeoutMs);
+        session->stackErrorsCount = 0;
       } else {
         // If the message was sent out but no ACK was received we increase the
         // target error count  and reset the stack errors count.
         if (status == EMBER_MAC_NO_ACK_RECEIVED) {
-          currentTargetErrorsCount++;
-          stackErrorsCount = 0;
+          session->currentTargetErrorsCount++;
+          session->stackErrorsCount = 0;
         } else {
           // If the message was not sent out because of a stack issue (CCA or
           // others), we bump the stack errors count.
-          stackErrorsCount++;
+          session->stackErrorsCount++;
         }
+        adaptPacingOnFailure(session, false);
 
-        scheduleBootloadRequestProcessNextTask(false, 0xFF);
+        scheduleBootloadRequestProcessNextTask(session, false, 0xFF);
       }
       break;
   }
+  pthread_mutex_unlock(&serverLock);
 }
 
-void emAfPluginOtaUnicastBootloaderServerEventHandler(void)
+//------------------------------------------------------------------------------
+// Session management static functions
+
+// Must be called with serverLock held
+static OtaServerSession *findSession(EmberNodeId target)
+{
+  sl_connect_ncp_instance_t *instance = sl_connect_ncp_get_current_instance();
+
+  for (uint8_t i = 0; i < EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_SESSIONS; i++) {
+    if (!serverIsIdle(&sessions[i])
+        && sessions[i].targetId == target
+        && sessions[i].instance == instance) {
+      return &sessions[i];
+    }
+  }
+  return NULL;
+}
+
+// Must be called with serverLock held. Returns NULL if the target is already
+// involved in a process or if all the sessions are in use.
+static OtaServerSession *allocateSession(EmberNodeId target)
+{
+  if (findSession(target) != NULL) {
+    return NULL;
+  }
+  for (uint8_t i = 0; i < EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_SESSIONS; i++) {
+    if (serverIsIdle(&sessions[i])) {
+      sessions[i].targetId = target;
+      sessions[i].instance = sl_connect_ncp_get_current_instance();
+      sessions[i].ota_event_is_active = false;
+      sessions[i].txIntervalMs = EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_TX_INTERVAL_MS;
+      sessions[i].responseTimeoutMs = EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_RESPONSE_TIMEOUT_MS;
+      sessions[i].smoothedRttMs = 0;
+      sessions[i].rttVariationMs = 0;
+      sessions[i].rttTiming = false;
+      sessions[i].journaled = false;
+      return &sessions[i];
+    }
+  }
+  return NULL;
+}
+
+static EmberAfOtaUnicastBootloaderStatus startImageDistribution(EmberNodeId target,
+                                                                uint32_t imageSize,
+                                                                uint8_t imageTag,
+                                                                bool journaled,
+                                                                uint32_t imageHash,
+                                                                uint32_t segment)
 {
-  ota_event_is_active = false;
-  switch (internalState) {
+  OtaServerSession *session;
+
+  sli_connect_ota_unicast_server_start();
+  pthread_mutex_lock(&serverLock);
+  session = allocateSession(target);
+  if (session == NULL) {
+    pthread_mutex_unlock(&serverLock);
+    return EMBER_OTA_UNICAST_BOOTLOADER_STATUS_BUSY;
+  }
+
+  session->currentImageSizeOrBootloadTimeMs = imageSize;
+  session->currentImageTagOrServerStatus = imageTag;
+
+  session->nextSegment = 0;
+  session->windowBase = segment;
+  session->windowSize = EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_WINDOW_SIZE;
+  // Windowed transfers start back to back and only slow down on failures,
+  // stop-and-wait ones start at the configured interval
+  if (session->windowSize > 1) {
+    session->txIntervalMs = 0;
+  }
+  session->stackErrorsCount = 0;
+  session->currentTargetErrorsCount = 0;
+
+  session->journaled = journaled;
+  session->imageHash = imageHash;
+  if (journaled) {
+    checkpointImageDistribution(session);
+  }
+
+  session->internalState = STATE_OTA_SERVER_HANDSHAKE_INTERVAL;
+  sli_connect_ota_unicast_server_schedule_next_event(session, 0);
+  pthread_mutex_unlock(&serverLock);
+
+  return EMBER_OTA_UNICAST_BOOTLOADER_STATUS_SUCCESS;
+}
+
+static void sessionEventHandler(OtaServerSession *session)
+{
+  switch (session->internalState) {
     case STATE_OTA_SERVER_HANDSHAKE_INTERVAL:
-      unicastHandshake();
+      unicastHandshake(session);
       break;
     case STATE_OTA_SERVER_SEGMENT_UNICAST_INTERVAL:
-      unicastNextSegment();
+      unicastNextSegment(session);
       break;
     case STATE_OTA_SERVER_HANDSHAKE_WAITING_RESPONSE:
     case STATE_OTA_SERVER_SEGMENT_UNICAST_WAITING_RESPONSE:
       // No response from the target: bump the target's error count and schedule
       // the next task.
-      currentTargetErrorsCount++;
-      scheduleImageDistributionProcessNextTask(false);
+      session->currentTargetErrorsCount++;
+      adaptPacingOnFailure(session, true);
+      scheduleImageDistributionProcessNextTask(session, false);
       break;
     case STATE_OTA_SERVER_BOOTLOAD_REQUEST_UNICAST_INTERVAL:
-      requestTargetForBootload();
+      requestTargetForBootload(session);
       break;
     case STATE_OTA_SERVER_BOOTLOAD_REQUEST_WAITING_RESPONSE:
       // No response from the target: bump the target's error count and schedule
       // the next task.
-      currentTargetErrorsCount++;
-      scheduleBootloadRequestProcessNextTask(false, 0xFF);
+      session->currentTargetErrorsCount++;
+      adaptPacingOnFailure(session, true);
+      scheduleBootloadRequestProcessNextTask(session, false, 0xFF);
       break;
   }
 }
@@ -360,61 +600,108 @@ void emAfPluginOtaUnicastBootloaderServerEventHandler(void)
 //------------------------------------------------------------------------------
 // Image distribution process static functions
 
-static void handleSegmentResponse(EmberIncomingMessage *message)
+static void handleSegmentResponse(OtaServerSession *session, EmberIncomingMessage *message)
 {
   uint32_t respSegment;
   // Check if client aborted or refused the image distribution
   if (emOtaUnicastBootloaderProtocolResponseStatus(message->payload)
       ==  EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_FRAME_CONTROL_RESP_STATUS_OUT_OF_SEQ) {
     // Client reports out-of-sequence segment
-    imageDistributionProcessFinished(EMBER_OTA_UNICAST_BOOTLOADER_STATUS_FAILED);
+    respSegment =
+      emberFetchLowHighInt32u(message->payload + EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_IMAGE_SEGMENT_RESP_INDEX_OFFSET);
+    if (respSegment >= session->nextSegment) {
+      // Late response to a segment sent before falling back to stop-and-wait
+      return;
+    } else if (session->windowSize > 1) {
+      // The client only supports stop-and-wait: resume from the oldest
+      // unacknowledged segment, one segment at a time.
+      session->windowSize = 1;
+      session->nextSegment = session->windowBase;
+      session->retransmitSegment = session->windowBase;
+      memset(session->ackedSegments, 0, sizeof(session->ackedSegments));
+      session->rttTiming = false;
+      adaptPacingOnFailure(session, false);
+      if (session->txIntervalMs < EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_TX_INTERVAL_MS) {
+        session->txIntervalMs = EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_TX_INTERVAL_MS;
+      }
+      if (session->internalState == STATE_OTA_SERVER_SEGMENT_UNICAST_WAITING_RESPONSE) {
+        session->internalState = STATE_OTA_SERVER_SEGMENT_UNICAST_INTERVAL;
+        sli_connect_ota_unicast_server_schedule_next_event(session, session->txIntervalMs);
+      }
+    } else {
+      imageDistributionProcessFinished(session, EMBER_OTA_UNICAST_BOOTLOADER_STATUS_FAILED);
+    }
   } else if (emOtaUnicastBootloaderProtocolResponseStatus(message->payload)
              ==  EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_FRAME_CONTROL_RESP_STATUS_REFUSED) {
     // Image refused by the client
-    imageDistributionProcessFinished(EMBER_OTA_UNICAST_BOOTLOADER_STATUS_REFUSED);
+    imageDistributionProcessFinished(session, EMBER_OTA_UNICAST_BOOTLOADER_STATUS_REFUSED);
   } else if (emOtaUnicastBootloaderProtocolResponseStatus(message->payload)
              ==  EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_FRAME_CONTROL_RESP_STATUS_ONGOING) {
     // Response ok and client approved segment
     respSegment =
       emberFetchLowHighInt32u(message->payload + EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_IMAGE_SEGMENT_RESP_INDEX_OFFSET);
-    if (respSegment == sentSegment) {
-      currentTargetErrorsCount = 0;
-      ota_event_is_active = false;
-      // Segment index match, schedule next segment
-      scheduleImageDistributionProcessNextTask(true);
+    if (respSegment < session->windowBase) {
+      // Duplicate response to a retransmitted segment
+      return;
+    } else if (respSegment < session->nextSegment) {
+      stopRttTiming(session, respSegment, true);
+      adaptPacingOnSuccess(session);
+      acknowledgeSegment(session, respSegment);
+      session->currentTargetErrorsCount = 0;
+      if (session->journaled
+          && session->windowBase - session->checkpointSegment
+          >= EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_JOURNAL_CHECKPOINT_SEGMENTS) {
+        checkpointImageDistribution(session);
+      }
+      // Otherwise the sent() callback or the pending event will send the next
+      // segment
+      if (session->internalState == STATE_OTA_SERVER_SEGMENT_UNICAST_WAITING_RESPONSE) {
+        session->ota_event_is_active = false;
+        sli_connect_timer_stop(&session->eventTimer);
+        // Segment index match, schedule next segment
+        scheduleImageDistributionProcessNextTask(session, true);
+      }
     } else {
       // Segment index mismatch
-      imageDistributionProcessFinished(EMBER_OTA_UNICAST_BOOTLOADER_STATUS_FAILED);
+      imageDistributionProcessFinished(session, EMBER_OTA_UNICAST_BOOTLOADER_STATUS_FAILED);
     }
   } else if (emOtaUnicastBootloaderProtocolResponseStatus(message->payload)
              ==  EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_FRAME_CONTROL_RESP_STATUS_COMPLETED) {
     // Image distibution complete
-    imageDistributionProcessFinished(EMBER_OTA_UNICAST_BOOTLOADER_STATUS_SUCCESS);
+    imageDistributionProcessFinished(session, EMBER_OTA_UNICAST_BOOTLOADER_STATUS_SUCCESS);
   }
 }
 
-static void handleHandshakeResponse(EmberIncomingMessage *message,
+static void handleHandshakeResponse(OtaServerSession *session,
+                                    EmberIncomingMessage *message,
                                     uint32_t startSegment)
 {
+  stopRttTiming(session, INVALID_SEGMENT_INDEX, true);
   switch (emOtaUnicastBootloaderProtocolResponseStatus(message->payload)) {
     // Image refused by the client
     case EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_FRAME_CONTROL_RESP_STATUS_REFUSED:
-      imageDistributionProcessFinished(EMBER_OTA_UNICAST_BOOTLOADER_STATUS_REFUSED);
+      imageDistributionProcessFinished(session, EMBER_OTA_UNICAST_BOOTLOADER_STATUS_REFUSED);
       break;
     // Image accepted, Sschedule first image segment
     case EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_FRAME_CONTROL_RESP_STATUS_ONGOING:
-      nextSegment = startSegment;
-      currentTargetErrorsCount = 0;
-      internalState = STATE_OTA_SERVER_SEGMENT_UNICAST_INTERVAL;
-      scheduleImageDistributionProcessNextTask(true);
+      session->nextSegment = startSegment;
+      session->windowBase = startSegment;
+      session->retransmitSegment = startSegment;
+      memset(session->ackedSegments, 0, sizeof(session->ackedSegments));
+      session->currentTargetErrorsCount = 0;
+      if (session->journaled) {
+        checkpointImageDistribution(session);
+      }
+      session->internalState = STATE_OTA_SERVER_SEGMENT_UNICAST_INTERVAL;
+      scheduleImageDistributionProcessNextTask(session, true);
       break;
     default:
       // Treat any other response status as a generic failure
-      imageDistributionProcessFinished(EMBER_OTA_UNICAST_BOOTLOADER_STATUS_FAILED);
+      imageDistributionProcessFinished(session, EMBER_OTA_UNICAST_BOOTLOADER_STATUS_FAILED);
   }
 }
 
-static void unicastHandshake(void)
+static void unicastHandshake(OtaServerSession *session)
 {
   uint8_t message[EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_HANDSHAKE_HEADER_LENGTH];
   EmberStatus status;
@@ -426,12 +713,12 @@ static void unicastHandshake(void)
         << EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_FRAME_CONTROL_REQ_FLAGS_OFFSET));
   // Image tag
   message[EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_HANDSHAKE_TAG_OFFSET] =
-    currentImageTagOrServerStatus;
+    session->currentImageTagOrServerStatus;
   // Image size
   emberStoreLowHighInt32u(message + EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_HANDSHAKE_LENGTH_OFFSET,
-                          currentImageSizeOrBootloadTimeMs);
+                          session->currentImageSizeOrBootloadTimeMs);
 
-  status = emberMessageSend(targetId,
+  status = emberMessageSend(session->targetId,
                             EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_ENDPOINT,
                             0, // messageTag
                             (EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_HANDSHAKE_HEADER_LENGTH),
@@ -440,31 +727,42 @@ static void unicastHandshake(void)
 
   if (status == EMBER_SUCCESS) {
     // Wait for the messageSent() corresponding call.
-    internalState = STATE_OTA_SERVER_HANDSHAKE_PENDING;
+    session->internalState = STATE_OTA_SERVER_HANDSHAKE_PENDING;
+    startRttTiming(session, INVALID_SEGMENT_INDEX);
   } else {
     // If we failed submitting a message to the stack, we increase the tx
     // count and try again.
-    stackErrorsCount++;
-    scheduleImageDistributionProcessNextTask(false);
+    session->stackErrorsCount++;
+    adaptPacingOnFailure(session, false);
+    scheduleImageDistributionProcessNextTask(session, false);
   }
 }
 
-static void unicastNextSegment(void)
+static void unicastNextSegment(OtaServerSession *session)
 {
   uint8_t message[MAX_APPLICATION_PAYLOAD_LENGTH];
-  uint32_t startIndex = nextSegment * MAX_SEGMENT_PAYLOAD_LENGTH;
+  uint32_t segment = getNextSegmentToSend(session);
+
+  if (segment == INVALID_SEGMENT_INDEX) {
+    // The window is full, wait for the responses
+    session->internalState = STATE_OTA_SERVER_SEGMENT_UNICAST_WAITING_RESPONSE;
+    sli_connect_ota_unicast_server_schedule_next_event(session, session->responseTimeoutMs);
+    return;
+  }
+
+  uint32_t startIndex = segment * MAX_SEGMENT_PAYLOAD_LENGTH;
   uint32_t endIndex = startIndex + MAX_SEGMENT_PAYLOAD_LENGTH - 1;
 
   // Account for the last segment which may very well be a partial segment.
-  if (endIndex >= currentImageSizeOrBootloadTimeMs) {
-    endIndex = currentImageSizeOrBootloadTimeMs - 1;
+  if (endIndex >= session->currentImageSizeOrBootloadTimeMs) {
+    endIndex = session->currentImageSizeOrBootloadTimeMs - 1;
   }
 
   if (!emberAfPluginOtaUnicastBootloaderServerGetImageSegmentCallback(startIndex,
                                                                       endIndex,
-                                                                      currentImageTagOrServerStatus,
+                                                                      session->currentImageTagOrServerStatus,
                                                                       message + EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_IMAGE_SEGMENT_HEADER_LENGTH)) {
-    imageDistributionProcessFinished(EMBER_OTA_UNICAST_BOOTLOADER_STATUS_DATA_UNDERFLOW);
+    imageDistributionProcessFinished(session, EMBER_OTA_UNICAST_BOOTLOADER_STATUS_DATA_UNDERFLOW);
   } else {
     EmberStatus status;
 
@@ -475,12 +773,12 @@ static void unicastNextSegment(void)
           << EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_FRAME_CONTROL_REQ_FLAGS_OFFSET));
     // Image tag
     message[EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_IMAGE_SEGMENT_TAG_OFFSET] =
-      currentImageTagOrServerStatus;
+      session->currentImageTagOrServerStatus;
     // Segment index
     emberStoreLowHighInt32u(message + EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_IMAGE_SEGMENT_INDEX_OFFSET,
-                            nextSegment);
+                            segment);
 
-    status = emberMessageSend(targetId,
+    status = emberMessageSend(session->targetId,
                               EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_ENDPOINT,
                               0, // messageTag
                               (EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_IMAGE_SEGMENT_HEADER_LENGTH
@@ -490,65 +788,74 @@ static void unicastNextSegment(void)
 
     if (status == EMBER_SUCCESS) {
       // Wait for the messageSent() corresponding call.
-      internalState = STATE_OTA_SERVER_SEGMENT_UNICAST_PENDING;
+      session->internalState = STATE_OTA_SERVER_SEGMENT_UNICAST_PENDING;
       // Let's store the last segment that was sent
-      sentSegment = nextSegment;
+      session->sentSegment = segment;
+      session->retransmitSegment = segment + 1;
+      if (segment == session->nextSegment) {
+        session->nextSegment++;
+        if (!session->rttTiming) {
+          startRttTiming(session, segment);
+        }
+      } else {
+        // Karn's rule: no sample from a retransmitted segment
+        stopRttTiming(session, segment, false);
+      }
     } else {
       // If we failed submitting a message to the stack, we increase the tx
       // count and try again if we still have tries left.
-      stackErrorsCount++;
-      scheduleImageDistributionProcessNextTask(false);
+      session->stackErrorsCount++;
+      adaptPacingOnFailure(session, false);
+      scheduleImageDistributionProcessNextTask(session, false);
     }
   }
 }
 
-static void scheduleImageDistributionProcessNextTask(bool newSegment)
+static void scheduleImageDistributionProcessNextTask(OtaServerSession *session, bool newSegment)
 {
-  switch (internalState) {
+  switch (session->internalState) {
     case STATE_OTA_SERVER_HANDSHAKE_INTERVAL:
     case STATE_OTA_SERVER_SEGMENT_UNICAST_INTERVAL:
-      if (stackErrorsCount >= EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_STACK_ERRORS) {
-        imageDistributionProcessFinished(EMBER_OTA_UNICAST_BOOTLOADER_STATUS_STACK_ERROR);
+      if (session->stackErrorsCount >= EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_STACK_ERRORS) {
+        imageDistributionProcessFinished(session, EMBER_OTA_UNICAST_BOOTLOADER_STATUS_STACK_ERROR);
         return;
       }
-      if (currentTargetErrorsCount >= EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_UNICAST_ERRORS) {
-        imageDistributionProcessFinished(EMBER_OTA_UNICAST_BOOTLOADER_STATUS_UNREACHABLE);
+      if (session->currentTargetErrorsCount >= EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_UNICAST_ERRORS) {
+        imageDistributionProcessFinished(session, EMBER_OTA_UNICAST_BOOTLOADER_STATUS_UNREACHABLE);
         return;
       }
 
-      sli_connect_ota_unicast_server_schedule_next_event(EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_TX_INTERVAL_MS);
+      sli_connect_ota_unicast_server_schedule_next_event(session, session->txIntervalMs);
       break;
     case STATE_OTA_SERVER_SEGMENT_UNICAST_WAITING_RESPONSE:
       if (newSegment) {
-        // Send next segment if any left
-        if (nextSegment < getTotalSegmentsCount() ) {
-          // Next segment
-          nextSegment++;
-        } else {
-          // We sent all the segments
-          nextSegment = 0;
-          stackErrorsCount = 0;
-          currentTargetErrorsCount = 0;
+        if (session->windowBase >= getTotalSegmentsCount(session)) {
+          // All the segments were acknowledged
+          session->stackErrorsCount = 0;
+          session->currentTargetErrorsCount = 0;
           return;
         }
+      } else {
+        // No response: retransmit the unacknowledged segments of the window
+        session->retransmitSegment = session->windowBase;
       }
-      internalState = STATE_OTA_SERVER_SEGMENT_UNICAST_INTERVAL;
+      session->internalState = STATE_OTA_SERVER_SEGMENT_UNICAST_INTERVAL;
       // Schedule next transmission if maximum attempts not yet reached
       // if the target does not respond to the handshake repeatedly, abort the process
-      if (currentTargetErrorsCount >= EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_UNICAST_ERRORS) {
-        imageDistributionProcessFinished(EMBER_OTA_UNICAST_BOOTLOADER_STATUS_UNREACHABLE);
+      if (session->currentTargetErrorsCount >= EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_UNICAST_ERRORS) {
+        imageDistributionProcessFinished(session, EMBER_OTA_UNICAST_BOOTLOADER_STATUS_UNREACHABLE);
       } else {
-        sli_connect_ota_unicast_server_schedule_next_event(EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_TX_INTERVAL_MS);
+        sli_connect_ota_unicast_server_schedule_next_event(session, session->txIntervalMs);
       }
       break;
     case STATE_OTA_SERVER_HANDSHAKE_WAITING_RESPONSE:
       // if the target does not respond to the handshake repeatedly, abort the process
-      if (currentTargetErrorsCount >= EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_UNICAST_ERRORS) {
-        imageDistributionProcessFinished(EMBER_OTA_UNICAST_BOOTLOADER_STATUS_UNREACHABLE);
+      if (session->currentTargetErrorsCount >= EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_UNICAST_ERRORS) {
+        imageDistributionProcessFinished(session, EMBER_OTA_UNICAST_BOOTLOADER_STATUS_UNREACHABLE);
       } else {
         // Try again
-        internalState = STATE_OTA_SERVER_HANDSHAKE_INTERVAL;
-        sli_connect_ota_unicast_server_schedule_next_event(EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_TX_INTERVAL_MS);
+        session->internalState = STATE_OTA_SERVER_HANDSHAKE_INTERVAL;
+        sli_connect_ota_unicast_server_schedule_next_event(session, session->txIntervalMs);
       }
       break;
     default:
@@ -556,30 +863,174 @@ static void scheduleImageDistributionProcessNextTask(bool newSegment)
   }
 }
 
-static void imageDistributionProcessFinished(EmberAfOtaUnicastBootloaderStatus status)
+static void imageDistributionProcessFinished(OtaServerSession *session, EmberAfOtaUnicastBootloaderStatus status)
 {
-  ota_event_is_active = false;
-  internalState = STATE_OTA_SERVER_IDLE;
+  session->ota_event_is_active = false;
+  sli_connect_timer_stop(&session->eventTimer);
+  session->internalState = STATE_OTA_SERVER_IDLE;
+  if (session->journaled) {
+    // Only the distributions interrupted by a restart are resumed
+    emAfPluginOtaUnicastBootloaderServerJournalRemove(session->targetId, session->instance);
+    session->journaled = false;
+  }
 
-  emberAfPluginOtaUnicastBootloaderServerImageDistributionCompleteCallback(status);
+  emberAfPluginOtaUnicastBootloaderServerTargetImageDistributionCompleteCallback(session->targetId, status);
 }
 
-static uint32_t getTotalSegmentsCount(void)
+static uint32_t getTotalSegmentsCount(OtaServerSession *session)
 {
   uint32_t totalSegments =
-    (uint32_t)(currentImageSizeOrBootloadTimeMs / MAX_SEGMENT_PAYLOAD_LENGTH);
+    (uint32_t)(session->currentImageSizeOrBootloadTimeMs / MAX_SEGMENT_PAYLOAD_LENGTH);
 
-  if ((currentImageSizeOrBootloadTimeMs % MAX_SEGMENT_PAYLOAD_LENGTH) > 0) {
+  if ((session->currentImageSizeOrBootloadTimeMs % MAX_SEGMENT_PAYLOAD_LENGTH) > 0) {
     totalSegments++;
   }
 
   return totalSegments;
 }
 
+// Returns the first unacknowledged segment to retransmit, else the next new
+// segment if the window allows it, else INVALID_SEGMENT_INDEX.
+static uint32_t getNextSegmentToSend(OtaServerSession *session)
+{
+  uint32_t segment = session->retransmitSegment;
+
+  if (segment < session->windowBase) {
+    segment = session->windowBase;
+  }
+  for (; segment < session->nextSegment; segment++) {
+    uint32_t bit = segment - session->windowBase;
+    if (!(session->ackedSegments[bit / 8] & (1 << (bit % 8)))) {
+      return segment;
+    }
+  }
+  if (session->nextSegment < getTotalSegmentsCount(session)
+      && session->nextSegment - session->windowBase < session->windowSize) {
+    return session->nextSegment;
+  }
+  return INVALID_SEGMENT_INDEX;
+}
+
+// Marks a segment of the window as acknowledged and slides the window past the
+// acknowledged segments.
+static void acknowledgeSegment(OtaServerSession *session, uint32_t segment)
+{
+  uint32_t bit = segment - session->windowBase;
+
+  session->ackedSegments[bit / 8] |= (1 << (bit % 8));
+  while (session->ackedSegments[0] & 0x01) {
+    for (uint8_t i = 0; i < MISSING_SEGMENTS_BITMASK_LENGTH; i++) {
+      session->ackedSegments[i] >>= 1;
+      if (i + 1 < MISSING_SEGMENTS_BITMASK_LENGTH) {
+        session->ackedSegments[i] |= (session->ackedSegments[i + 1] & 0x01) << 7;
+      }
+    }
+    session->windowBase++;
+  }
+}
+
+// Records the oldest segment not acknowledged by the target
+static void checkpointImageDistribution(OtaServerSession *session)
+{
+  session->checkpointSegment = session->windowBase;
+  emAfPluginOtaUnicastBootloaderServerJournalCheckpoint(session->targetId,
+                                                        session->instance,
+                                                        session->currentImageTagOrServerStatus,
+                                                        session->currentImageSizeOrBootloadTimeMs,
+                                                        session->imageHash,
+                                                        session->windowBase);
+}
+
+//------------------------------------------------------------------------------
+// Adaptive pacing static functions
+
+static void startRttTiming(OtaServerSession *session, uint32_t segment)
+{
+  session->rttTiming = true;
+  session->rttSegment = segment;
+  session->rttStartMs = monotonicTimeMs();
+}
+
+// Takes a round trip time sample if the target responded to the timed message
+// and updates the response timeout as RFC 6298 does.
+static void stopRttTiming(OtaServerSession *session, uint32_t segment, bool responded)
+{
+  uint32_t rttMs;
+  uint32_t timeoutMs;
+
+  if (!session->rttTiming || session->rttSegment != segment) {
+    return;
+  }
+  session->rttTiming = false;
+  if (!responded) {
+    return;
+  }
+
+  rttMs = (uint32_t)(monotonicTimeMs() - session->rttStartMs);
+  if (session->smoothedRttMs == 0) {
+    session->smoothedRttMs = rttMs;
+    session->rttVariationMs = rttMs / 2;
+  } else {
+    uint32_t deltaMs = (rttMs > session->smoothedRttMs)
+                       ? rttMs - session->smoothedRttMs
+                       : session->smoothedRttMs - rttMs;
+    session->rttVariationMs = (3 * session->rttVariationMs + deltaMs) / 4;
+    session->smoothedRttMs = (7 * session->smoothedRttMs + rttMs) / 8;
+  }
+
+  timeoutMs = session->smoothedRttMs + 4 * session->rttVariationMs;
+  if (timeoutMs < EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MIN_RESPONSE_TIMEOUT_MS) {
+    timeoutMs = EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MIN_RESPONSE_TIMEOUT_MS;
+  } else if (timeoutMs > EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_RESPONSE_TIMEOUT_MS) {
+    timeoutMs = EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_RESPONSE_TIMEOUT_MS;
+  }
+  session->responseTimeoutMs = timeoutMs;
+}
+
+// Additive increase of the transmission rate (1000 / interval segments per
+// second): the target keeps up. Short intervals shrink by at least
+// EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_TX_INTERVAL_STEP_MS.
+static void adaptPacingOnSuccess(OtaServerSession *session)
+{
+  uint32_t intervalMs = session->txIntervalMs;
+  uint32_t newIntervalMs =
+    (1000 * intervalMs) / (1000 + EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_TX_RATE_STEP * intervalMs);
+
+  if (intervalMs <= EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_TX_INTERVAL_STEP_MS) {
+    newIntervalMs = 0;
+  } else if (newIntervalMs > intervalMs - EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_TX_INTERVAL_STEP_MS) {
+    newIntervalMs = intervalMs - EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_TX_INTERVAL_STEP_MS;
+  }
+  session->txIntervalMs = (uint16_t)newIntervalMs;
+}
+
+// Multiplicative decrease of the transmission rate, and increase of the
+// response timeout if the target did not respond in time.
+static void adaptPacingOnFailure(OtaServerSession *session, bool responseTimeout)
+{
+  uint32_t intervalMs = 2 * (uint32_t)session->txIntervalMs
+                        + EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_TX_INTERVAL_STEP_MS;
+
+  if (intervalMs > EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_TX_INTERVAL_MS) {
+    intervalMs = EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_TX_INTERVAL_MS;
+  }
+  session->txIntervalMs = intervalMs;
+
+  if (responseTimeout) {
+    uint32_t timeoutMs = 2 * (uint32_t)session->responseTimeoutMs;
+
+    if (timeoutMs > EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_RESPONSE_TIMEOUT_MS) {
+      timeoutMs = EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_RESPONSE_TIMEOUT_MS;
+    }
+    session->responseTimeoutMs = timeoutMs;
+    session->rttTiming = false;
+  }
+}
+
 // -----------------------------------------------------------------------------
 // Bootload request process static functions
 
-static void requestTargetForBootload(void)
+static void requestTargetForBootload(OtaServerSession *session)
 {
   uint8_t message[EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_BOOTLOAD_REQ_HEADER_LENGTH];
   struct timespec spec;
@@ -588,10 +1039,10 @@ static void requestTargetForBootload(void)
   EmberStatus status;
   uint32_t delayMs;
 
-  if (timeGTorEqualInt32u(nowMs, currentImageSizeOrBootloadTimeMs)) {
+  if (timeGTorEqualInt32u(nowMs, session->currentImageSizeOrBootloadTimeMs)) {
     delayMs = 0;
   } else {
-    delayMs = elapsedTimeInt32u(nowMs, currentImageSizeOrBootloadTimeMs);
+    delayMs = elapsedTimeInt32u(nowMs, session->currentImageSizeOrBootloadTimeMs);
   }
 
   // Frame control
@@ -601,12 +1052,12 @@ static void requestTargetForBootload(void)
         << EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_FRAME_CONTROL_REQ_FLAGS_OFFSET));
   // Image tag
   message[EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_BOOTLOAD_REQ_TAG_OFFSET] =
-    currentImageTagOrServerStatus;
+    session->currentImageTagOrServerStatus;
   // Delay
   emberStoreLowHighInt32u(message + EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_BOOTLOAD_REQ_DELAY_OFFSET,
                           delayMs);
 
-  status = emberMessageSend(targetId,
+  status = emberMessageSend(session->targetId,
                             EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_ENDPOINT,
                             0, // messageTag
                             EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_BOOTLOAD_REQ_HEADER_LENGTH,
@@ -615,22 +1066,25 @@ static void requestTargetForBootload(void)
 
   if (status == EMBER_SUCCESS) {
     // Wait for the messageSent() corresponding call.
-    internalState = STATE_OTA_SERVER_BOOTLOAD_REQUEST_UNICAST_PENDING;
+    session->internalState = STATE_OTA_SERVER_BOOTLOAD_REQUEST_UNICAST_PENDING;
+    startRttTiming(session, INVALID_SEGMENT_INDEX);
   } else {
     // If we failed submitting a message to the stack, we increase the tx
     // count and try again.
-    stackErrorsCount++;
-    scheduleBootloadRequestProcessNextTask(false, 0xFF);
+    session->stackErrorsCount++;
+    adaptPacingOnFailure(session, false);
+    scheduleBootloadRequestProcessNextTask(session, false, 0xFF);
   }
 }
 
-static void scheduleBootloadRequestProcessNextTask(bool targetResponeded,
+static void scheduleBootloadRequestProcessNextTask(OtaServerSession *session,
+                                                   bool targetResponeded,
                                                    uint8_t targetResponseStatus)
 {
-  assert(serverInBootloadRequestProcess());
+  assert(serverInBootloadRequestProcess(session));
 
-  if (stackErrorsCount >= EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_STACK_ERRORS) {
-    bootloadRequestProcessFinished(EMBER_OTA_UNICAST_BOOTLOADER_STATUS_STACK_ERROR);
+  if (session->stackErrorsCount >= EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_STACK_ERRORS) {
+    bootloadRequestProcessFinished(session, EMBER_OTA_UNICAST_BOOTLOADER_STATUS_STACK_ERROR);
     return;
   }
 
@@ -638,76 +1092,111 @@ static void scheduleBootloadRequestProcessNextTask(bool targetResponeded,
     // We completed the bootload request process, let's see what the outcome was.
     switch (targetResponseStatus) {
       case EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_FRAME_CONTROL_RESP_STATUS_COMPLETED:
-        bootloadRequestProcessFinished(EMBER_OTA_UNICAST_BOOTLOADER_STATUS_SUCCESS);
+        bootloadRequestProcessFinished(session, EMBER_OTA_UNICAST_BOOTLOADER_STATUS_SUCCESS);
         break;
       case EMBER_OTA_UNICAST_BOOTLOADER_PROTOCOL_FRAME_CONTROL_RESP_STATUS_REFUSED:
-        bootloadRequestProcessFinished(EMBER_OTA_UNICAST_BOOTLOADER_STATUS_REFUSED);
+        bootloadRequestProcessFinished(session, EMBER_OTA_UNICAST_BOOTLOADER_STATUS_REFUSED);
         break;
       default:
         // Unexpected response value
-        bootloadRequestProcessFinished(EMBER_OTA_UNICAST_BOOTLOADER_STATUS_FAILED);
+        bootloadRequestProcessFinished(session, EMBER_OTA_UNICAST_BOOTLOADER_STATUS_FAILED);
     }
   } else {
-    if (stackErrorsCount >= EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_STACK_ERRORS) {
-      bootloadRequestProcessFinished(EMBER_OTA_UNICAST_BOOTLOADER_STATUS_STACK_ERROR);
+    if (session->stackErrorsCount >= EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_STACK_ERRORS) {
+      bootloadRequestProcessFinished(session, EMBER_OTA_UNICAST_BOOTLOADER_STATUS_STACK_ERROR);
       return;
     }
-    if (currentTargetErrorsCount
+    if (session->currentTargetErrorsCount
         >= EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_UNICAST_ERRORS) {
-      bootloadRequestProcessFinished(EMBER_OTA_UNICAST_BOOTLOADER_STATUS_UNREACHABLE);
+      bootloadRequestProcessFinished(session, EMBER_OTA_UNICAST_BOOTLOADER_STATUS_UNREACHABLE);
       return;
     }
 
     // Try/re-try
-    internalState = STATE_OTA_SERVER_BOOTLOAD_REQUEST_UNICAST_INTERVAL;
-    sli_connect_ota_unicast_server_schedule_next_event(EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_TX_INTERVAL_MS);
+    session->internalState = STATE_OTA_SERVER_BOOTLOAD_REQUEST_UNICAST_INTERVAL;
+    sli_connect_ota_unicast_server_schedule_next_event(session, session->txIntervalMs);
   }
 }
 
-static void bootloadRequestProcessFinished(EmberAfOtaUnicastBootloaderStatus status)
+static void bootloadRequestProcessFinished(OtaServerSession *session, EmberAfOtaUnicastBootloaderStatus status)
 {
-  ota_event_is_active = false;
-  internalState = STATE_OTA_SERVER_IDLE;
-  emberAfPluginOtaUnicastBootloaderServerRequestTargetBootloadCompleteCallback(status);
+  session->ota_event_is_active = false;
+  sli_connect_timer_stop(&session->eventTimer);
+  session->internalState = STATE_OTA_SERVER_IDLE;
+  emberAfPluginOtaUnicastBootloaderServerTargetRequestTargetBootloadCompleteCallback(session->targetId, status);
 }
 
 //------------------------------------------------------------------------------
-// Timerfd and scheduling functions
-static void sli_connect_ota_unicast_server_schedule_next_event(uint16_t time_ms)
-{
-  struct itimerspec wait;
-  wait.it_interval.tv_nsec = 0;
-  wait.it_interval.tv_sec = 0;
-  wait.it_value.tv_sec = 0;
-  if (time_ms != 0) {
-    wait.it_value.tv_nsec = time_ms * 1000000;
-    timerfd_settime(timer_fd, NULL, &wait, NULL);
-  } else {
-    wait.it_value.tv_nsec = 1;
-    timerfd_settime(timer_fd, NULL, &wait, NULL);
-  }
-  ota_event_is_active = true;
-}
-
-static void *sli_connect_ota_unicast_server_process_events(void *arg)
-{
-  int ret;
-  uint64_t exp;
-  timer_fd = timerfd_create(CLOCK_MONOTONIC, 0);
-  struct pollfd t_fds = {
-    .fd = timer_fd,
-    .events = POLLIN,
-  };
-  sli_connect_ota_unicast_server_schedule_next_event(0);
-  while (!serverIsIdle()) {
-    ret = poll(&t_fds, 1, -1);
-    read(timer_fd, &exp, sizeof(uint64_t));
-    if (ret > 0 ) {
-      while (ota_event_is_active) {
-        emAfPluginOtaUnicastBootloaderServerEventHandler();
-      }
-    }
-    BUG_ON(ret < 0, "OTA Unicast server poll failed");
+// Timer and scheduling functions
+
+static uint64_t monotonicTimeMs(void)
+{
+  struct timespec spec;
+
+  clock_gettime(CLOCK_MONOTONIC, &spec);
+  return (uint64_t)spec.tv_sec * 1000 + spec.tv_nsec / 1000000;
+}
+
+// Must be called with serverLock held
+static void sli_connect_ota_unicast_server_schedule_next_event(OtaServerSession *session, uint16_t time_ms)
+{
+  session->ota_event_is_active = true;
+  sli_connect_timer_start(&session->eventTimer, time_ms);
+}
+
+static void initServer(void)
+{
+  pthread_mutexattr_t attr;
+
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init(&serverLock, &attr);
+  pthread_mutexattr_destroy(&attr);
+
+  for (uint8_t i = 0; i < EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_MAX_SESSIONS; i++) {
+    sli_connect_timer_init(&sessions[i].eventTimer, sessionTimerCallback, &sessions[i]);
   }
-  return NULL;
+
+  // No message is expected before the first process is started
+  sl_connect_subscribe_incoming_message(EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_ENDPOINT,
+                                        incomingMessageHandler,
+                                        NULL);
+  sl_connect_subscribe_message_sent(EMBER_AF_PLUGIN_OTA_UNICAST_BOOTLOADER_SERVER_ENDPOINT,
+                                    messageSentHandler,
+                                    NULL);
+}
+
+// The sessions are timed by the timer wheel of the library. Must be called
+// before taking serverLock.
+static void sli_connect_ota_unicast_server_start(void)
+{
+  pthread_once(&serverOnce, initServer);
+}
+
+static void sessionTimerCallback(void *context)
+{
+  OtaServerSession *session = context;
+
+  pthread_mutex_lock(&serverLock);
+  // The event may have been cancelled or rescheduled while this callback was
+  // waiting for the lock
+  if (session->ota_event_is_active && !sli_connect_timer_is_pending(&session->eventTimer)) {
+    session->ota_event_is_active = false;
+    // Talk to the NCP of the thread that started the process
+    sl_connect_ncp_select_instance(session->instance);
+    sessionEventHandler(session);
+  }
+  pthread_mutex_unlock(&serverLock);
+}
+
+static void incomingMessageHandler(EmberIncomingMessage *message, void *context)
+{
+  (void)context;
+  emAfPluginOtaUnicastBootloaderServerIncomingMessageCallback(message);
+}
+
+static void messageSentHandler(EmberStatus status, EmberOutgoingMessage *message, void *context)
+{
+  (void)context;
+  emAfPluginOtaUnicastBootloaderServerMessageSentCallback(status, message);
 }
@@ -1,4 +1,5 @@
 #include "connect/callback_dispatcher.h"
+#include "host-common/callback-subscriptions.h"
 
 void emberAfInit(void)
 {
@@ -10,7 +11,7 @@ void emberAfTick(void)
 
 void emberAfStackStatus(EmberStatus status)
 {
-  (void)status;
+  sli_connect_dispatch_stack_status(status);
 }
 
 void emberAfChildJoin(EmberNodeType nodeType,
@@ -31,10 +32,7 @@ void emberAfStackIsr(void)
 void emberAfMessageSent(EmberStatus status,
                         EmberOutgoingMessage *message)
 {
-  emAfPluginOtaUnicastBootloaderServerMessageSentCallback(
-    status,
-    message
-    );
+  sli_connect_dispatch_message_sent(status, message);
 }
 
 void emberAfMacMessageSent(EmberStatus status,
@@ -46,7 +44,7 @@ void emberAfMacMessageSent(EmberStatus status,
 
 void emberAfIncomingMessage(EmberIncomingMessage *message)
 {
-  emAfPluginOtaUnicastBootloaderServerIncomingMessageCallback(message);
+  sli_connect_dispatch_incoming_message(message);
 }
 
 void emberAfIncomingMacMessage(EmberIncomingMacMessage *message)